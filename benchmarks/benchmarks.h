@@ -0,0 +1,86 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <common/primitives.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+namespace micro_profiler
+{
+	namespace benchmarks
+	{
+		class stopwatch
+		{
+		public:
+			stopwatch();
+
+			// Returns seconds passed since the previous call (or construction).
+			double lap();
+
+			// Returns seconds of a monotonic clock, comparable across threads.
+			static double now();
+
+		private:
+			double _last;
+		};
+
+		void wire_format();
+		void scheduling_jitter();
+		void ipc_transports(const char *results_path);
+		void view_sorting();
+
+
+
+		// stopwatch - inline definitions
+		inline stopwatch::stopwatch()
+			: _last(now())
+		{	}
+
+		inline double stopwatch::lap()
+		{
+			const double previous = _last;
+
+			_last = now();
+			return _last - previous;
+		}
+
+		inline double stopwatch::now()
+		{
+#ifdef _WIN32
+			LARGE_INTEGER frequency, counter;
+
+			::QueryPerformanceFrequency(&frequency);
+			::QueryPerformanceCounter(&counter);
+			return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+#else
+			timespec t;
+
+			::clock_gettime(CLOCK_MONOTONIC, &t);
+			return t.tv_sec + 1e-9 * t.tv_nsec;
+#endif
+		}
+	}
+}
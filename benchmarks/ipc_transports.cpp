@@ -0,0 +1,313 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include "benchmarks.h"
+
+#include <ipc/client.h>
+#include <ipc/server.h>
+#include <ipc/shared_ring.h>
+
+#include <algorithm>
+#include <collector/system.h>
+#include <stdio.h>
+#include <string.h>
+#include <wpl/mt/synchronization.h>
+#include <wpl/mt/thread.h>
+
+using namespace std;
+using namespace std::placeholders;
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			typedef function<void (vector<double> &latencies)> session_t;
+
+			const size_t c_sizes[] = {	64, 1 << 10, 16 << 10, 256 << 10, 1 << 20, 10 << 20,	};
+			const unsigned int c_session_counts[] = {	1, 4, 16,	};
+			const size_t c_bytes_per_run = 64 << 20;
+			const size_t c_min_messages = 100, c_max_messages = 20000;
+			const size_t c_min_session_messages = 32;	// Keeps the per-session latencies in the percentiles meaningful.
+			const unsigned int c_window = 32;
+			const char c_server_name[] = "micro-profiler-benchmark";
+#ifdef _WIN32
+			const char c_channel[] = "pipe";
+#else
+			const char c_channel[] = "socket";
+#endif
+
+			class null_session : public ipc::server::session
+			{
+			public:
+				virtual void on_message(const vector<ipc::byte> &/*input*/, vector<ipc::byte> &output)
+				{	output.clear();	}
+			};
+
+			class null_server : public ipc::server
+			{
+			public:
+				null_server(const char *name)
+					: ipc::server(name)
+				{	}
+
+			private:
+				virtual session *create_session()
+				{	return new null_session;	}
+			};
+
+			struct ring_channel
+			{
+				ring_channel(const string &name, size_t capacity)
+					: producer(ipc::shared_ring::create(name, capacity)), consumer(ipc::shared_ring::open(name))
+				{	}
+
+				auto_ptr<ipc::shared_ring> producer, consumer;
+			};
+
+			struct call_window
+			{
+				call_window(size_t count)
+					: outstanding(0), posted(count), latencies(count), completed(false, true)
+				{	}
+
+				unsigned int outstanding;
+				vector<double> posted, latencies;
+				event_flag completed;
+				mutex window_mutex;
+			};
+
+
+			void round_trips(const shared_ptr<ipc::client> &c, size_t count, size_t size, vector<double> &latencies)
+			{
+				vector<ipc::byte> request(size, 0x5A), reply;
+				stopwatch sw;
+
+				for (size_t i = 0; i != count; ++i)
+				{
+					c->call(request, reply);
+					latencies.push_back(sw.lap());
+				}
+			}
+
+			void on_reply(call_window *w, size_t i, const vector<ipc::byte> &/*reply*/)
+			{
+				scoped_lock l(w->window_mutex);
+
+				w->latencies[i] = stopwatch::now() - w->posted[i];
+				--w->outstanding;
+				w->completed.raise();
+			}
+
+			void acquire(call_window &w, unsigned int limit)
+			{
+				for (;; w.completed.wait())
+				{
+					scoped_lock l(w.window_mutex);
+
+					if (w.outstanding < limit)
+					{
+						++w.outstanding;
+						return;
+					}
+				}
+			}
+
+			void pipelined_calls(const shared_ptr<ipc::client> &c, size_t count, size_t size, vector<double> &latencies)
+			{
+				vector<ipc::byte> request(size, 0x5A);
+				call_window w(count);
+
+				for (size_t i = 0; i != count; ++i)
+				{
+					acquire(w, c_window);
+					w.posted[i] = stopwatch::now();
+					c->call_async(request, bind(&on_reply, &w, i, _1));
+				}
+				acquire(w, 1);	// Once this one gets in, every real call is complete.
+				latencies.swap(w.latencies);
+			}
+
+			void echo(const shared_ptr<ring_channel> &requests, const shared_ptr<ring_channel> &replies, size_t count)
+			{
+				const ipc::byte *data;
+				size_t size;
+
+				for (size_t i = 0; i != count; ++i)
+				{
+					requests->consumer->read(data, size);
+					requests->consumer->release();
+					replies->producer->write(&size, 0);
+				}
+			}
+
+			void ring_round_trips(const shared_ptr<ring_channel> &requests, const shared_ptr<ring_channel> &replies,
+				size_t count, size_t size, vector<double> &latencies)
+			{
+				thread t(bind(&echo, requests, replies, count));
+				vector<ipc::byte> request(size, 0x5A);
+				const ipc::byte *data;
+				stopwatch sw;
+
+				for (size_t i = 0; i != count; ++i)
+				{
+					requests->producer->write(&request[0], size);
+					replies->consumer->read(data, size);
+					replies->consumer->release();
+					latencies.push_back(sw.lap());
+				}
+				t.join();
+			}
+
+			void consume(const shared_ptr<ring_channel> &ring, size_t count, vector<double> *latencies)
+			{
+				const ipc::byte *data;
+				size_t size;
+				double posted;
+
+				for (size_t i = 0; i != count; ++i)
+				{
+					ring->consumer->read(data, size);
+					memcpy(&posted, data, sizeof(posted));
+					latencies->push_back(stopwatch::now() - posted);
+					ring->consumer->release();
+				}
+			}
+
+			void ring_stream(const shared_ptr<ring_channel> &ring, size_t count, size_t size, vector<double> &latencies)
+			{
+				thread t(bind(&consume, ring, count, &latencies));
+				vector<ipc::byte> message(size, 0x5A);
+
+				for (size_t i = 0; i != count; ++i)
+				{
+					const double posted = stopwatch::now();
+
+					memcpy(&message[0], &posted, sizeof(posted));
+					ring->producer->write(&message[0], size);
+				}
+				t.join();
+			}
+
+			// Runs the sessions concurrently, each on its own thread. Returns the time taken by the slowest one.
+			double run_sessions(const vector<session_t> &sessions, vector<double> &latencies)
+			{
+				vector< vector<double> > session_latencies(sessions.size());
+				vector< shared_ptr<thread> > threads;
+				stopwatch sw;
+
+				for (size_t i = 0; i != sessions.size(); ++i)
+					threads.push_back(shared_ptr<thread>(new thread(bind(sessions[i], ref(session_latencies[i])))));
+				for (size_t i = 0; i != threads.size(); ++i)
+					threads[i]->join();
+
+				const double elapsed = sw.lap();
+
+				latencies.clear();
+				for (size_t i = 0; i != session_latencies.size(); ++i)
+					latencies.insert(latencies.end(), session_latencies[i].begin(), session_latencies[i].end());
+				return elapsed;
+			}
+
+			void report(FILE *results, const char *backend, const char *mode, size_t sessions, size_t size,
+				double elapsed, vector<double> &latencies)
+			{
+				sort(latencies.begin(), latencies.end());
+
+				const size_t n = latencies.size();
+				const double rate = n / elapsed, mb_rate = rate * size / (1 << 20);
+				const double p50 = 1e6 * latencies[n / 2], p99 = 1e6 * latencies[n * 99 / 100];
+
+				const unsigned int sessions_ = static_cast<unsigned int>(sessions), size_ = static_cast<unsigned int>(size);
+
+				printf("\t%-6s %-10s %2u sessions %8uB: %9.0fmsg/s %8.1fMB/s p50: %9.1fus p99: %9.1fus\n", backend,
+					mode, sessions_, size_, rate, mb_rate, p50, p99);
+				if (results)
+				{
+					fprintf(results, "%s,%s,%u,%u,%u,%.6f,%.1f,%.2f,%.2f,%.2f\n", backend, mode, sessions_, size_,
+						static_cast<unsigned int>(n), elapsed, rate, mb_rate, p50, p99);
+				}
+			}
+		}
+
+		void ipc_transports(const char *results_path)
+		{
+			FILE *results = results_path ? fopen(results_path, "w") : 0;
+			null_server s(c_server_name);
+			thread server_thread(bind(&ipc::server::run, &s));
+			vector<double> latencies;
+
+			if (results)
+			{
+				fprintf(results, "backend,mode,sessions,size,messages,seconds,messages_per_second,mb_per_second,"
+					"p50_us,p99_us\n");
+			}
+			for (size_t i = 0; i != sizeof(c_session_counts) / sizeof(c_session_counts[0]); ++i)
+			{
+				for (size_t j = 0; j != sizeof(c_sizes) / sizeof(c_sizes[0]); ++j)
+				{
+					const size_t n = c_session_counts[i], size = c_sizes[j];
+					const size_t count = max(c_min_session_messages,
+						max(c_min_messages, min(c_max_messages, c_bytes_per_run / size)) / n);
+					vector<session_t> calls, async_calls, ring_calls, ring_streams;
+
+					for (size_t k = 0; k != n; ++k)
+					{
+						const shared_ptr<ipc::client> c(new ipc::client(c_server_name));
+						char name[100];
+
+						sprintf(name, "micro-profiler-benchmark-%u", static_cast<unsigned int>(k));
+
+						const shared_ptr<ring_channel> requests(new ring_channel(string(name) + "-requests",
+							max<size_t>(4 * size, 64 << 10)));
+						const shared_ptr<ring_channel> replies(new ring_channel(string(name) + "-replies", 64));
+
+						calls.push_back(bind(&round_trips, c, count, size, _1));
+						async_calls.push_back(bind(&pipelined_calls, c, count, size, _1));
+						if (requests->consumer.get() && replies->consumer.get())
+						{
+							ring_calls.push_back(bind(&ring_round_trips, requests, replies, count, size, _1));
+							ring_streams.push_back(bind(&ring_stream, requests, count, size, _1));
+						}
+					}
+
+					double elapsed = run_sessions(calls, latencies);
+
+					report(results, c_channel, "round-trip", n, size, elapsed, latencies);
+					elapsed = run_sessions(async_calls, latencies);
+					report(results, c_channel, "pipelined", n, size, elapsed, latencies);
+					if (ring_calls.size() == n)
+					{
+						elapsed = run_sessions(ring_calls, latencies);
+						report(results, "ring", "round-trip", n, size, elapsed, latencies);
+						elapsed = run_sessions(ring_streams, latencies);
+						report(results, "ring", "pipelined", n, size, elapsed, latencies);
+					}
+				}
+			}
+			s.stop();
+			server_thread.join();
+			if (results)
+				fclose(results);
+		}
+	}
+}
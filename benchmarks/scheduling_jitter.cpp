@@ -0,0 +1,146 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include "benchmarks.h"
+
+#include <collector/analysis_worker.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+#include <wpl/mt/synchronization.h>
+#include <wpl/mt/thread.h>
+
+using namespace std;
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			const int c_samples = 200;
+
+			struct analysis_log
+			{
+				analysis_log()
+					: analyzed(false, true), elapsed(0)
+				{	}
+
+				stopwatch sw;
+				event_flag analyzed;
+				double elapsed;
+				vector<double> times;
+			};
+
+			bool log_analysis(analysis_log *log, bool calls_read)
+			{
+				log->times.push_back(log->elapsed += log->sw.lap());
+				log->analyzed.raise();
+				return calls_read;
+			}
+
+			void update()
+			{	}
+
+			void run(analysis_worker *worker, analysis_log *log, bool calls_read)
+			{	worker->run(bind(&log_analysis, log, calls_read), &update);	}
+
+			void print_distribution(const char *name, vector<double> &samples_ms)
+			{
+				sort(samples_ms.begin(), samples_ms.end());
+
+				const size_t n = samples_ms.size();
+
+				printf("\t%-24s p50: %6.2fms, p90: %6.2fms, p99: %6.2fms, max: %6.2fms\n", name, samples_ms[n / 2],
+					samples_ms[n * 9 / 10], samples_ms[n * 99 / 100], samples_ms[n - 1]);
+			}
+		}
+
+		void scheduling_jitter()
+		{
+			// Periodic analysis while calls keep coming: lateness of each wakeup against the analysis interval.
+			{
+				const analysis_scheduler::intervals intervals = {	10, 500, 67	};
+				event_flag wakeup(false, true);
+				analysis_worker worker(wakeup, intervals);
+				analysis_log log;
+				thread t(bind(&run, &worker, &log, true));
+
+				for (int i = 0; i != c_samples + 1; ++i)
+					log.analyzed.wait();
+				worker.stop();
+				t.join();
+
+				vector<double> lateness;
+
+				for (int i = 1; i != c_samples + 1; ++i)
+					lateness.push_back(max(0.0, 1000 * (log.times[i] - log.times[i - 1]) - intervals.analysis));
+				print_distribution("periodic lateness", lateness);
+			}
+
+			// Idle worker woken by a filled trace: time from raising the wakeup to the analysis being done.
+			{
+				const analysis_scheduler::intervals intervals = {	10000, 10000, 10000	};
+				event_flag wakeup(false, true), pause(false, false);
+				analysis_worker worker(wakeup, intervals);
+				analysis_log log;
+				thread t(bind(&run, &worker, &log, false));
+				vector<double> latency;
+				stopwatch sw;
+
+				for (int i = 0; i != c_samples; ++i)
+				{
+					pause.wait(3);
+					sw.lap();
+					wakeup.raise();
+					log.analyzed.wait();
+					latency.push_back(1000 * sw.lap());
+				}
+				worker.stop();
+				t.join();
+				print_distribution("wakeup round trip", latency);
+			}
+
+			// Stop request: time from stop() to the worker's final analysis and update being done.
+			{
+				const analysis_scheduler::intervals intervals = {	10, 500, 67	};
+				vector<double> latency;
+
+				for (int i = 0; i != c_samples / 10; ++i)
+				{
+					event_flag wakeup(false, true);
+					analysis_worker worker(wakeup, intervals);
+					analysis_log log;
+					thread t(bind(&run, &worker, &log, true));
+					stopwatch sw;
+
+					log.analyzed.wait();
+					sw.lap();
+					worker.stop();
+					t.join();
+					latency.push_back(1000 * sw.lap());
+				}
+				print_distribution("stop drain", latency);
+			}
+		}
+	}
+}
@@ -0,0 +1,225 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include "benchmarks.h"
+
+#include <frontend/ordered_view.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			typedef unordered_map<long_address_t, function_statistics, address_compare> statistics;
+			typedef unordered_map<long_address_t, wstring, address_compare> names_map;
+			typedef ordered_view<statistics> view;
+
+			const size_t c_rows = 1000000;
+			const int c_repetitions = 3;
+
+			// Counterparts of the frontend's functors: the predicates are what views compared by before the keys
+			// were extracted, the names are looked up per comparison as symbol_resolver's cache does.
+			struct by_times_called_predicate
+			{
+				bool operator ()(long_address_t, const function_statistics &lhs, long_address_t,
+					const function_statistics &rhs) const
+				{	return lhs.times_called < rhs.times_called;	}
+			};
+
+			struct by_times_called : sort_key_extractor<count_t>
+			{
+				count_t operator ()(long_address_t, const function_statistics &s) const
+				{	return s.times_called;	}
+			};
+
+			struct by_avg_inclusive_time_predicate
+			{
+				bool operator ()(long_address_t, const function_statistics &lhs, long_address_t,
+					const function_statistics &rhs) const
+				{
+					return lhs.times_called && rhs.times_called
+						? lhs.inclusive_time * rhs.times_called < rhs.inclusive_time * lhs.times_called
+						: lhs.times_called < rhs.times_called;
+				}
+			};
+
+			struct by_avg_inclusive_time : sort_key_extractor<double>
+			{
+				double operator ()(long_address_t, const function_statistics &s) const
+				{	return s.times_called ? static_cast<double>(s.inclusive_time) / s.times_called : -1.0;	}
+			};
+
+			class by_name_predicate
+			{
+			public:
+				by_name_predicate(const names_map &names)
+					: _names(&names)
+				{	}
+
+				bool operator ()(long_address_t lhs, const function_statistics &, long_address_t rhs,
+					const function_statistics &) const
+				{	return _names->find(lhs)->second < _names->find(rhs)->second;	}
+
+			private:
+				const names_map *_names;
+			};
+
+			class by_name : public sort_key_extractor<unsigned int>
+			{
+			public:
+				by_name(const names_map &names)
+					: _names(&names)
+				{	}
+
+				// All the names are known upfront, so they are ranked on the first pass.
+				template <typename IteratorT>
+				void prepare(IteratorT /*begin*/, IteratorT /*end*/) const
+				{
+					if (!_ranks.empty())
+						return;
+
+					vector<named_address> names;
+
+					for (names_map::const_iterator i = _names->begin(); i != _names->end(); ++i)
+						names.push_back(make_pair(&i->second, i->first));
+					sort(names.begin(), names.end(), &name_less);
+					for (unsigned int i = 0; i != names.size(); ++i)
+						_ranks[names[i].second] = i;
+				}
+
+				unsigned int operator ()(long_address_t address, const function_statistics &) const
+				{	return _ranks.find(address)->second;	}
+
+			private:
+				typedef pair<const wstring *, long_address_t> named_address;
+
+			private:
+				static bool name_less(const named_address &lhs, const named_address &rhs)
+				{	return *lhs.first < *rhs.first;	}
+
+			private:
+				const names_map *_names;
+				mutable unordered_map<long_address_t, unsigned int, address_compare> _ranks;
+			};
+
+			void make_rows(statistics &s, names_map &names)
+			{
+				wchar_t name[32];
+
+				for (unsigned int i = 0; i != c_rows; ++i)
+				{
+					const long_address_t address = 0x00400000 + 0x40ull * i;
+					const unsigned int h = i * 2654435761u;
+
+					s[address] = function_statistics(1 + h % 5000, 0, 1000 + h % 1000003, 0, 0);
+					swprintf(name, 32, L"ns%u::function_%08x", h % 17, h >> 3);
+					names[address] = name;
+				}
+			}
+
+			template <typename PredicateT>
+			struct rows_less
+			{
+				bool operator ()(statistics::const_iterator lhs, statistics::const_iterator rhs) const
+				{	return predicate(lhs->first, lhs->second, rhs->first, rhs->second);	}
+
+				PredicateT predicate;
+			};
+
+			// The full sort views did before: iterators into the map compared through the predicate.
+			template <typename PredicateT>
+			double predicate_sort(const statistics &s, PredicateT predicate)
+			{
+				vector<statistics::const_iterator> rows;
+				rows_less<PredicateT> less = {	predicate	};
+				stopwatch sw;
+
+				for (statistics::const_iterator i = s.begin(); i != s.end(); ++i)
+					rows.push_back(i);
+				sw.lap();
+				sort(rows.begin(), rows.end(), less);
+				return sw.lap();
+			}
+
+			template <typename KeyExtractorT, typename PredicateT>
+			void run(const char *name, statistics &s, KeyExtractorT extractor, PredicateT predicate)
+			{
+				double predicate_full = 0, key_full = 0, key_window = 0, key_resort = 0, key_incremental = 0;
+
+				for (int r = 0; r != c_repetitions; ++r)
+				{
+					view v(s);
+					stopwatch sw;
+
+					predicate_full += predicate_sort(s, predicate);
+					sw.lap();
+					v.set_order_by_key(extractor, true);
+
+					const double window = sw.lap();
+
+					v.at(c_rows - 1);	// Orders the rest of the view.
+					key_window += window;
+					key_full += window + sw.lap();
+
+					statistics changed;
+
+					for (unsigned int i = r; i < c_rows; i += 997)
+					{
+						statistics::iterator entry = s.find(0x00400000 + 0x40ull * i);
+
+						entry->second.times_called += 7, entry->second.inclusive_time += 100003;
+						changed.insert(*entry);
+					}
+					sw.lap();
+					v.resort(changed);
+					key_incremental += sw.lap();
+					v.resort();	// Extraction state (like name ranks) is reused from the passes above.
+					key_resort += sw.lap();
+				}
+				printf("\t%-16s predicate sort: %7.1fms, key sort: %7.1fms, top %u: %7.1fms, resort top %u: %6.1fms,"
+					" %u changed: %6.1fms\n", name, 1e3 * predicate_full / c_repetitions, 1e3 * key_full / c_repetitions,
+					static_cast<unsigned>(view::sorted_window), 1e3 * key_window / c_repetitions,
+					static_cast<unsigned>(view::sorted_window), 1e3 * key_resort / c_repetitions,
+					static_cast<unsigned>(c_rows / 997), 1e3 * key_incremental / c_repetitions);
+			}
+		}
+
+		void view_sorting()
+		{
+			statistics s;
+			names_map names;
+
+			make_rows(s, names);
+			printf("%u rows, %u hardware threads:\n", static_cast<unsigned>(c_rows), hardware_threads());
+			run("times called", s, by_times_called(), by_times_called_predicate());
+			run("avg. inclusive", s, by_avg_inclusive_time(), by_avg_inclusive_time_predicate());
+			run("name", s, by_name(names), by_name_predicate(names));
+		}
+	}
+}
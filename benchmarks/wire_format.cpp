@@ -0,0 +1,225 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include "benchmarks.h"
+
+#include <common/address_dictionary.h>
+#include <common/columnar.h>
+#include <common/compression.h>
+#include <common/pod_vector.h>
+#include <common/serialization.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <strmd/serializer.h>
+#include <strmd/deserializer.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace benchmarks
+	{
+		namespace
+		{
+			typedef statistics_map_detailed_t<const void *> collector_statistics;
+			typedef statistics_map_detailed_t<long_address_t> frontend_statistics;
+
+			const int c_repetitions = 20;
+
+			// Both ends of an update_format_indexed session. The addresses registered are handed over to the index
+			// directly, since a steady-state session sends no registrations at all.
+			struct indexed_session
+			{
+				address_dictionary dictionary;
+				registered_addresses registered;
+				address_index<long_address_t> index;
+			} g_session;
+
+			class buffer_writer
+			{
+			public:
+				buffer_writer(pod_vector<byte> &buffer)
+					: _buffer(buffer)
+				{	_buffer.clear();	}
+
+				void write(const void *data, size_t size)
+				{	_buffer.append(static_cast<const byte *>(data), static_cast<const byte *>(data) + size);	}
+
+			private:
+				void operator =(const buffer_writer &other);
+
+			private:
+				pod_vector<byte> &_buffer;
+			};
+
+			class buffer_reader
+			{
+			public:
+				buffer_reader(const byte *data, size_t size)
+					: _ptr(data), _remaining(size)
+				{	}
+
+				void read(void *data, size_t size)
+				{
+					memcpy(data, _ptr, size);
+					_ptr += size;
+					_remaining -= size;
+				}
+
+			private:
+				const byte *_ptr;
+				size_t _remaining;
+			};
+
+			// Mimics an update of a moderately sized application: addresses are spread over a module image, each
+			// function calls a few others and spans several latency buckets.
+			void make_update(collector_statistics &statistics, size_t functions, size_t callees_per_function)
+			{
+				const size_t base = 0x00400000;
+
+				for (size_t i = 0; i != functions; ++i)
+				{
+					const void *address = reinterpret_cast<const void *>(base + 0x40 * i);
+					function_statistics_detailed_t<const void *> &f = statistics[address];
+
+					static_cast<function_statistics &>(f) = function_statistics(100 + i % 1000, i % 3,
+						100000 + 37 * i, 30000 + 11 * i, 5000 + i);
+					for (size_t j = 1; j <= callees_per_function; ++j)
+					{
+						f.callees[reinterpret_cast<const void *>(base + 0x40 * ((i * 7 + j * 131) % functions))]
+							= function_statistics(10 + j, 0, 1000 * j, 700 * j, 100 * j);
+					}
+					for (timestamp_t t = 100; t < 100000; t *= 3)
+						f.latencies.add(t + static_cast<timestamp_t>(i), 1 + i % 5);
+				}
+			}
+
+			void encode_varint(pod_vector<byte> &buffer, const collector_statistics &statistics)
+			{
+				buffer_writer writer(buffer);
+				strmd::serializer<buffer_writer, packer> archive(writer);
+
+				archive(statistics);
+			}
+
+			void encode_columnar(pod_vector<byte> &buffer, const collector_statistics &statistics)
+			{
+				buffer_writer writer(buffer);
+
+				write_columnar(writer, statistics.begin(), statistics.end());
+			}
+
+			void encode_indexed(pod_vector<byte> &buffer, const collector_statistics &statistics)
+			{
+				buffer_writer writer(buffer);
+				strmd::serializer<buffer_writer, packer> archive(writer);
+				indexed_statistics_t<collector_statistics> update = {	statistics, g_session.dictionary	};
+
+				g_session.dictionary.register_addresses(statistics, g_session.registered);
+				for (registered_addresses::const_iterator i = g_session.registered.begin();
+					i != g_session.registered.end(); ++i)
+				{
+					g_session.index.append(*i);
+				}
+				archive(update);
+			}
+
+			void decode_varint(frontend_statistics &statistics, const pod_vector<byte> &buffer)
+			{
+				buffer_reader reader(buffer.data(), buffer.size());
+				strmd::deserializer<buffer_reader, packer> archive(reader);
+				function_statistics_detailed_t<long_address_t>::callees_map delta;
+				statistics_update_t<long_address_t> update = {	statistics, delta	};
+
+				archive(update);
+			}
+
+			void decode_columnar(frontend_statistics &statistics, const pod_vector<byte> &buffer)
+			{
+				function_statistics_detailed_t<long_address_t>::callees_map delta;
+				columnar_update update;
+
+				if (update.parse(buffer.data(), buffer.size()))
+					merge_columnar(statistics, &delta, update);
+			}
+
+			void decode_indexed(frontend_statistics &statistics, const pod_vector<byte> &buffer)
+			{
+				buffer_reader reader(buffer.data(), buffer.size());
+				strmd::deserializer<buffer_reader, packer> archive(reader);
+				function_statistics_detailed_t<long_address_t>::callees_map delta;
+				indexed_update_t<long_address_t> update = {	statistics, delta, g_session.index	};
+
+				if (statistics.empty())
+					g_session.index.reset_entries();	// Entries referred to belonged to a previous target.
+				archive(update);
+			}
+
+			void run(const char *name, const collector_statistics &source,
+				void (*encode)(pod_vector<byte> &buffer, const collector_statistics &statistics),
+				void (*decode)(frontend_statistics &statistics, const pod_vector<byte> &buffer))
+			{
+				pod_vector<byte> buffer, compressed, decompressed;
+				frontend_statistics target;
+				stopwatch sw;
+				double encoding = 0, decoding = 0, compressing = 0, decompressing = 0;
+
+				encode(buffer, source), decode(target, buffer); // Warm up and populate the target.
+				compressed.resize(compress_bound(buffer.size()));
+				decompressed.resize(buffer.size());
+				sw.lap();
+				for (int i = 0; i != c_repetitions; ++i)
+				{
+					encode(buffer, source);
+					encoding += sw.lap();
+					decode(target, buffer);
+					decoding += sw.lap();
+					compressed.resize(compress(compressed.data(), buffer.data(), buffer.size()));
+					compressing += sw.lap();
+					decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed.size());
+					decompressing += sw.lap();
+					compressed.resize(compress_bound(buffer.size()));
+				}
+				printf("\t%-9s %10u bytes, encode %9.1fus, decode %9.1fus\n", name, static_cast<unsigned>(buffer.size()),
+					1e6 * encoding / c_repetitions, 1e6 * decoding / c_repetitions);
+				printf("\t%-9s %10u bytes, compress %7.1fus, decompress %7.1fus\n", "+lz",
+					static_cast<unsigned>(compress(compressed.data(), buffer.data(), buffer.size())),
+					1e6 * compressing / c_repetitions, 1e6 * decompressing / c_repetitions);
+			}
+		}
+
+		void wire_format()
+		{
+			const size_t sizes[] = {	100, 1000, 10000, 100000,	};
+
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i)
+			{
+				collector_statistics source;
+
+				make_update(source, sizes[i], 4);
+				printf("%u functions, 4 callees each:\n", static_cast<unsigned>(sizes[i]));
+				run("varint", source, &encode_varint, &decode_varint);
+				run("columnar", source, &encode_columnar, &decode_columnar);
+				run("indexed", source, &encode_indexed, &decode_indexed);
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+namespace micro_profiler
+{
+	// Decides when the collector worker analyzes the collected traces and when it updates the frontend. Times are
+	// in milliseconds of a wrapping monotonic clock. Analysis runs at the shortest interval while calls keep coming
+	// and backs off exponentially towards the idle interval otherwise. The frontend is updated at the update
+	// interval while there is analyzed data to send, and at the idle interval otherwise, to deliver module events.
+	// Intervals are clamped to at least a millisecond (the idle one - to at least the analysis one), so the worker
+	// never spins.
+	class analysis_scheduler
+	{
+	public:
+		struct intervals
+		{
+			unsigned int analysis, idle_analysis, update;
+		};
+
+	public:
+		analysis_scheduler(const intervals &intervals_, unsigned int now);
+
+		unsigned int timeout(unsigned int now) const throw();
+		bool analysis_due(unsigned int now) const throw();
+		bool update_due(unsigned int now) const throw();
+
+		void analyzed(unsigned int now, bool calls_read) throw();
+		void updated(unsigned int now) throw();
+
+	private:
+		static intervals clamp(const intervals &intervals_) throw();
+		static unsigned int remaining(unsigned int since, unsigned int interval, unsigned int now) throw();
+
+	private:
+		const intervals _intervals;
+		unsigned int _analysis_interval, _last_analysis, _last_update;
+		bool _pending;
+	};
+}
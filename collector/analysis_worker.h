@@ -0,0 +1,65 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "analysis_scheduler.h"
+#include "system.h"
+
+#include <functional>
+#include <wpl/base/concepts.h>
+
+namespace wpl
+{
+	namespace mt
+	{
+		class event_flag;
+	}
+}
+
+namespace micro_profiler
+{
+	// Runs the collector's analysis loop on the calling thread: sleeps until the reader wakeup is raised or the
+	// scheduler's timeout expires, then analyzes the traces and updates the frontend when they are due. Relies on the
+	// monotonic clock and wpl::mt primitives only. stop() may be called from any thread, at any time (even before
+	// run()): run() then analyzes and updates the frontend one last time, so that nothing collected is lost, and
+	// returns. request_snapshot() may be called from any thread as well: the worker then analyzes and updates the
+	// frontend immediately, and takes the snapshot right after that. Requests made before a snapshot is taken coalesce.
+	class analysis_worker : wpl::noncopyable
+	{
+	public:
+		typedef std::function<bool ()> analyze_t;
+		typedef std::function<void ()> update_t;
+		typedef std::function<void ()> snapshot_t;
+
+	public:
+		analysis_worker(wpl::mt::event_flag &wakeup, const analysis_scheduler::intervals &intervals_);
+
+		void run(const analyze_t &analyze, const update_t &update, const snapshot_t &snapshot = snapshot_t());
+		void stop();
+		void request_snapshot();
+
+	private:
+		wpl::mt::event_flag &_wakeup;
+		const analysis_scheduler::intervals _intervals;
+		mutex _mtx;
+		bool _stop_requested, _snapshot_requested;
+	};
+}
@@ -24,6 +24,7 @@
 
 #include "primitives.h"
 
+#include <common/call_paths.h>
 #include <vector>
 
 namespace micro_profiler
@@ -32,7 +33,7 @@ namespace micro_profiler
 	class shadow_stack
 	{
 	public:
-		shadow_stack(timestamp_t profiler_latency = 0);
+		shadow_stack(timestamp_t profiler_latency = 0, bool collect_latencies = false, call_paths *paths = 0);
 
 		template <typename ForwardConstIterator>
 		void update(ForwardConstIterator trace_begin, ForwardConstIterator trace_end, OutputMapType &statistics);
@@ -45,9 +46,14 @@ namespace micro_profiler
 		const shadow_stack &operator =(const shadow_stack &rhs);
 
 		void restore_state(OutputMapType &statistics);
+		template <typename RecordT>
+		void unwind(const RecordT &record);
+		void pop(timestamp_t timestamp);
 
 	private:
 		const timestamp_t _profiler_latency;
+		const bool _collect_latencies;
+		call_paths *const _paths;
 		std::vector<call_record_ex> _stack;
 		entrance_counter_map _entrance_counter;
 	};
@@ -56,12 +62,15 @@ namespace micro_profiler
 	template <typename OutputMapType>
 	struct shadow_stack<OutputMapType>::call_record_ex : call_record
 	{
-		call_record_ex(const call_record &from, unsigned int &level, typename OutputMapType::mapped_type *entry);
+		call_record_ex(const call_record &from, const void *frame, unsigned int &level,
+			typename OutputMapType::mapped_type *entry, call_paths::path_id path);
 		call_record_ex(const call_record_ex &other);
 
+		const void *frame;
 		timestamp_t child_time;
 		unsigned int *level;
 		typename OutputMapType::mapped_type *entry;
+		call_paths::path_id path;
 	};
 
 
@@ -71,12 +80,13 @@ namespace micro_profiler
 		typedef statistics_map_detailed::const_iterator const_iterator;
 
 	public:
-		analyzer(timestamp_t profiler_latency = 0);
+		analyzer(timestamp_t profiler_latency = 0, bool collect_latencies = false, bool collect_call_paths = false);
 
 		void clear() throw();
 		size_t size() const throw();
 		const_iterator begin() const throw();
 		const_iterator end() const throw();
+		const call_paths &paths() const throw();
 
 		virtual void accept_calls(unsigned int threadid, const call_record *calls, size_t count);
 
@@ -88,15 +98,18 @@ namespace micro_profiler
 
 	private:
 		const timestamp_t _profiler_latency;
+		const bool _collect_latencies, _collect_call_paths;
 		statistics_map_detailed _statistics;
+		call_paths _paths;
 		stacks_container _stacks;
 	};
 
 
 	// shadow_stack - inline definitions
 	template <typename OutputMapType>
-	inline shadow_stack<OutputMapType>::shadow_stack(timestamp_t profiler_latency)
-		: _profiler_latency(profiler_latency)
+	inline shadow_stack<OutputMapType>::shadow_stack(timestamp_t profiler_latency, bool collect_latencies,
+			call_paths *paths)
+		: _profiler_latency(profiler_latency), _collect_latencies(collect_latencies), _paths(paths)
 	{	}
 
 	template <typename OutputMapType>
@@ -106,45 +119,80 @@ namespace micro_profiler
 			i->entry = &statistics[i->callee];
 	}
 
+	template <typename OutputMapType>
+	template <typename RecordT>
+	inline void shadow_stack<OutputMapType>::unwind(const RecordT &record)
+	{
+		// The stack grows downwards, so the frames placed at or below the location of the current record's frame
+		// were left without their exits being recorded (e.g. unwound by an exception or longjmp).
+		if (const void *stack_ptr = stack_pointer(record))
+		{
+			while (!_stack.empty() && _stack.back().frame && (_stack.back().frame < stack_ptr
+				|| (_stack.back().frame == stack_ptr && record.callee)))
+			{
+				pop(record.timestamp);
+			}
+		}
+	}
+
+	template <typename OutputMapType>
+	inline void shadow_stack<OutputMapType>::pop(timestamp_t timestamp)
+	{
+		const call_record_ex &current = _stack.back();
+		const void *callee = current.callee;
+		unsigned int level = --*current.level;
+		timestamp_t inclusive_time_observed = timestamp - current.timestamp;
+		timestamp_t inclusive_time = inclusive_time_observed - _profiler_latency;
+		timestamp_t exclusive_time = inclusive_time - current.child_time;
+
+		current.entry->add_call(level, inclusive_time, exclusive_time);
+		if (_collect_latencies)
+			add_latency(*current.entry, inclusive_time);
+		if (_paths)
+			_paths->add_time(current.path, exclusive_time);
+		_stack.pop_back();
+		if (!_stack.empty())
+		{
+			call_record_ex &parent = _stack.back();
+
+			parent.child_time += inclusive_time_observed + _profiler_latency;
+			add_child_statistics(*parent.entry, callee, 0, inclusive_time, exclusive_time);
+		}
+	}
+
 	template <typename OutputMapType>
 	template <typename ForwardConstIterator>
 	inline void shadow_stack<OutputMapType>::update(ForwardConstIterator i, ForwardConstIterator end, OutputMapType &statistics)
 	{
 		restore_state(statistics);
 		for (; i != end; ++i)
+		{
+			unwind(*i);
 			if (i->callee)
-				_stack.push_back(call_record_ex(*i, ++_entrance_counter[i->callee], &statistics[i->callee]));
-			else
 			{
-				const call_record_ex &current = _stack.back();
-				const void *callee = current.callee;
-				unsigned int level = --*current.level;
-				timestamp_t inclusive_time_observed = i->timestamp - current.timestamp;
-				timestamp_t inclusive_time = inclusive_time_observed - _profiler_latency;
-				timestamp_t exclusive_time = inclusive_time - current.child_time;
-
-				current.entry->add_call(level, inclusive_time, exclusive_time);
-				_stack.pop_back();
-				if (!_stack.empty())
-				{
-					call_record_ex &parent = _stack.back();
-
-					parent.child_time += inclusive_time_observed + _profiler_latency;
-					add_child_statistics(*parent.entry, callee, 0, inclusive_time, exclusive_time);
-				}
+				const call_paths::path_id path = _paths ? _paths->intern(_stack.empty() ? call_paths::root
+					: _stack.back().path, reinterpret_cast<size_t>(i->callee)) : call_paths::root;
+
+				_stack.push_back(call_record_ex(*i, stack_pointer(*i), ++_entrance_counter[i->callee],
+					&statistics[i->callee], path));
+			}
+			else if (!_stack.empty())
+			{
+				pop(i->timestamp);
 			}
+		}
 	}
 
 
 	// shadow_stack::call_record_ex - inline definitions
 	template <typename OutputMapType>
-	inline shadow_stack<OutputMapType>::call_record_ex::call_record_ex(const call_record &from, unsigned int &level_,
-		typename OutputMapType::mapped_type *entry_)
-		: call_record(from), child_time(0), level(&level_), entry(entry_)
+	inline shadow_stack<OutputMapType>::call_record_ex::call_record_ex(const call_record &from, const void *frame_,
+		unsigned int &level_, typename OutputMapType::mapped_type *entry_, call_paths::path_id path_)
+		: call_record(from), frame(frame_), child_time(0), level(&level_), entry(entry_), path(path_)
 	{	}
 
 	template <typename OutputMapType>
 	inline shadow_stack<OutputMapType>::call_record_ex::call_record_ex(const call_record_ex &other)
-		: call_record(other), child_time(other.child_time), level(other.level), entry(other.entry)
+		: call_record(other), frame(other.frame), child_time(other.child_time), level(other.level), entry(other.entry), path(other.path)
 	{	}
 }
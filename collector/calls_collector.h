@@ -22,6 +22,7 @@
 
 #include "system.h"
 
+#include <wpl/mt/synchronization.h>
 #include <wpl/mt/thread.h>
 #include <list>
 
@@ -36,6 +37,10 @@ namespace micro_profiler
 		virtual ~calls_collector_i() throw()	{	}
 		virtual void read_collected(acceptor &a) = 0;
 		virtual timestamp_t profiler_latency() const throw() = 0;
+
+		// Auto-reset flag raised when the trace of any thread fills past its high watermark, so that the reader may
+		// collect it before the thread blocks. Can be raised by others to wake the reader up early.
+		virtual wpl::mt::event_flag &reader_wakeup() throw() = 0;
 	};
 
 	struct calls_collector_i::acceptor
@@ -53,10 +58,15 @@ namespace micro_profiler
 		virtual void read_collected(acceptor &a);
 
 		void track(call_record call) throw();
+#if defined(MP_RECORD_STACK_POINTERS)
+		void track(timestamp_t timestamp, const void *address, const void *stack_ptr) throw();
+#else
 		void track(timestamp_t timestamp, const void *address) throw();
+#endif
 
 		size_t trace_limit() const throw();
 		virtual timestamp_t profiler_latency() const throw();
+		virtual wpl::mt::event_flag &reader_wakeup() throw();
 
 	private:
 		class thread_trace_block;
@@ -71,6 +81,7 @@ namespace micro_profiler
 		const size_t _trace_limit;
 		timestamp_t _profiler_latency;
 		wpl::mt::tls<thread_trace_block> _trace_pointers_tls;
+		wpl::mt::event_flag _reader_wakeup;
 		mutex _thread_blocks_mtx;
 		std::list<thread_trace_block> _call_traces;
 	};
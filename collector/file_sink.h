@@ -0,0 +1,36 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <common/types.h>
+
+#include <string>
+
+namespace micro_profiler
+{
+	// Opens a channel, that records the messages into files (see common/recording.h) instead of sending them to a
+	// frontend. The first segment is written to 'path', the following ones to 'path.1', 'path.2', etc. If 'path'
+	// exists already (an earlier session or another process), the first free of 'path-1', 'path-2', etc. is taken
+	// instead, so that sessions do not overwrite each other's recordings. Files are buffered and closed when the last
+	// copy of the channel is destroyed. Being passed as a frontend factory to the frontend_controller, the channel is
+	// written on the pipelined sender thread, off the analysis loop.
+	channel_t open_file_sink(const std::wstring &path, size_t segment_limit);
+}
@@ -36,6 +36,7 @@ namespace wpl
 
 namespace micro_profiler
 {
+	class analysis_worker;
 	struct calls_collector_i;
 	struct handle;
 	class image_load_queue;
@@ -55,14 +56,14 @@ namespace micro_profiler
 	private:
 		static void frontend_worker(wpl::mt::thread *previous_thread, const frontend_factory &factory,
 			calls_collector_i *collector, const std::shared_ptr<image_load_queue> &image_load_queue,
-			const std::shared_ptr<void> &exit_event);
+			const std::shared_ptr<analysis_worker> &worker);
 
 	private:
 		calls_collector_i &_collector;
 		frontend_factory _factory;
 		std::shared_ptr<image_load_queue> _image_load_queue;
 		std::shared_ptr<volatile long> _worker_refcount;
-		std::shared_ptr<void> _exit_event;
+		std::shared_ptr<analysis_worker> _worker;
 		std::auto_ptr<wpl::mt::thread> _frontend_thread;
 	};
 }
@@ -0,0 +1,62 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <common/primitives.h>
+
+#include <string>
+#include <wpl/base/concepts.h>
+
+namespace micro_profiler
+{
+	// A file of a fixed size, created anew and mapped into memory for writing. The file is truncated to the size
+	// set by truncate() when the mapping is destroyed. data() is null if the file could not be created or mapped.
+	class mapped_file : wpl::noncopyable
+	{
+	public:
+		mapped_file(const std::wstring &path, size_t size);
+		~mapped_file();
+
+		byte *data() const throw();
+		size_t size() const throw();
+		void truncate(size_t size) throw();
+
+	private:
+		byte *_data;
+		size_t _size, _final_size;
+#ifdef _WIN32
+		void *_file, *_mapping;
+#else
+		int _file;
+#endif
+	};
+
+
+
+	inline byte *mapped_file::data() const throw()
+	{	return _data;	}
+
+	inline size_t mapped_file::size() const throw()
+	{	return _size;	}
+
+	inline void mapped_file::truncate(size_t size) throw()
+	{	_final_size = size;	}
+}
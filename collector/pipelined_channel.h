@@ -0,0 +1,76 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "system.h"
+
+#include <common/pod_vector.h>
+#include <common/types.h>
+
+#include <memory>
+#include <vector>
+#include <wpl/base/concepts.h>
+#include <wpl/mt/synchronization.h>
+
+namespace wpl
+{
+	namespace mt
+	{
+		class thread;
+	}
+}
+
+namespace micro_profiler
+{
+	// Transmits messages via the underlying channel on a dedicated thread, so that posting does not wait for a slow
+	// frontend. The underlying channel is created, used and destroyed on that thread only, as channels may be bound
+	// to the thread (COM apartment) they were opened on. Messages posted are accumulated in one batch while the other
+	// one is being transmitted; posting blocks while the batch accumulated exceeds 'max_queued' bytes. Destruction
+	// transmits all the messages posted before it returns.
+	class pipelined_channel : wpl::noncopyable
+	{
+	public:
+		pipelined_channel(const frontend_factory &factory, size_t max_queued);
+		~pipelined_channel();
+
+		bool operator ()(const void *data, size_t size);
+
+	private:
+		struct batch
+		{
+			pod_vector<byte> data;
+			std::vector<size_t> ends;
+		};
+
+	private:
+		void worker();
+
+	private:
+		const frontend_factory _factory;
+		const size_t _max_queued;
+		mutex _mtx;
+		batch _batches[2];
+		batch *_filling;
+		bool _stop;
+		wpl::mt::event_flag _posted, _swapped;
+		std::auto_ptr<wpl::mt::thread> _thread;
+	};
+}
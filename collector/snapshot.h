@@ -0,0 +1,91 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "system.h"
+
+#include <common/primitives.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <wpl/base/concepts.h>
+
+namespace wpl
+{
+	namespace mt
+	{
+		class thread;
+	}
+}
+
+namespace micro_profiler
+{
+	class statistics_accumulator;
+
+	// Writes the statistics accumulated so far into a new '<prefix>-<YYYYMMDD>-<HHMMSS>-<n>.mpstats' file, which can
+	// be opened in the profiler. The accumulator is reset after each snapshot if asked to, so that every snapshot
+	// carries the statistics collected since the previous one only.
+	class snapshot_writer
+	{
+	public:
+		snapshot_writer(const std::wstring &prefix, const std::shared_ptr<statistics_accumulator> &statistics,
+			timestamp_t ticks_per_second, bool reset);
+
+		// Returns the path of the snapshot written or an empty string if the file could not be created.
+		std::wstring write();
+
+	private:
+		std::wstring next_path();
+
+	private:
+		const std::wstring _prefix;
+		const std::shared_ptr<statistics_accumulator> _statistics;
+		const timestamp_t _ticks_per_second;
+		const bool _reset;
+		unsigned int _sequence;
+	};
+
+	// Calls the handler each time a snapshot is requested from outside of the process: by sending it the signal on
+	// POSIX systems (SIGUSR2, if zero is passed), or by setting the 'Local\micro-profiler-snapshot-<pid>' event on
+	// Windows. The handler is called on the trigger's own thread and never from within a signal handler. Only one
+	// trigger may exist in a process at a time. The collector is only built for Windows so far, so the signal path is
+	// exercised by the tests only.
+	class snapshot_trigger : wpl::noncopyable
+	{
+	public:
+		snapshot_trigger(int signal, const std::function<void ()> &handler);
+		~snapshot_trigger();
+
+	private:
+		struct platform_state;
+
+	private:
+		void worker();
+
+	private:
+		const std::function<void ()> _handler;
+		mutex _mtx;
+		bool _stop;
+		std::auto_ptr<platform_state> _state;
+		std::auto_ptr<wpl::mt::thread> _thread;
+	};
+}
@@ -0,0 +1,77 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/analysis_scheduler.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	analysis_scheduler::analysis_scheduler(const intervals &intervals_, unsigned int now)
+		: _intervals(clamp(intervals_)), _analysis_interval(_intervals.analysis), _last_analysis(now),
+			_last_update(now), _pending(false)
+	{	}
+
+	unsigned int analysis_scheduler::timeout(unsigned int now) const throw()
+	{
+		return min(remaining(_last_analysis, _analysis_interval, now),
+			remaining(_last_update, _pending ? _intervals.update : _intervals.idle_analysis, now));
+	}
+
+	bool analysis_scheduler::analysis_due(unsigned int now) const throw()
+	{	return !remaining(_last_analysis, _analysis_interval, now);	}
+
+	bool analysis_scheduler::update_due(unsigned int now) const throw()
+	{	return !remaining(_last_update, _pending ? _intervals.update : _intervals.idle_analysis, now);	}
+
+	void analysis_scheduler::analyzed(unsigned int now, bool calls_read) throw()
+	{
+		_last_analysis = now;
+		if (calls_read)
+			_analysis_interval = _intervals.analysis, _pending = true;
+		else
+			_analysis_interval = min(2 * _analysis_interval, _intervals.idle_analysis);
+	}
+
+	void analysis_scheduler::updated(unsigned int now) throw()
+	{
+		_last_update = now;
+		_pending = false;
+	}
+
+	analysis_scheduler::intervals analysis_scheduler::clamp(const intervals &intervals_) throw()
+	{
+		intervals clamped = intervals_;
+
+		clamped.analysis = max(1u, clamped.analysis);
+		clamped.idle_analysis = max(clamped.analysis, clamped.idle_analysis);
+		clamped.update = max(1u, clamped.update);
+		return clamped;
+	}
+
+	unsigned int analysis_scheduler::remaining(unsigned int since, unsigned int interval, unsigned int now) throw()
+	{
+		const unsigned int elapsed = now - since;
+
+		return elapsed < interval ? interval - elapsed : 0;
+	}
+}
@@ -0,0 +1,96 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/analysis_worker.h>
+
+#include <collector/system.h>
+
+#include <wpl/mt/synchronization.h>
+
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	analysis_worker::analysis_worker(event_flag &wakeup, const analysis_scheduler::intervals &intervals_)
+		: _wakeup(wakeup), _intervals(intervals_), _stop_requested(false), _snapshot_requested(false)
+	{	}
+
+	void analysis_worker::run(const analyze_t &analyze, const update_t &update, const snapshot_t &snapshot)
+	{
+		analysis_scheduler scheduler(_intervals, monotonic_milliseconds());
+
+		for (;;)
+		{
+			const bool filled = waitable::satisfied == _wakeup.wait(scheduler.timeout(monotonic_milliseconds()));
+			bool stop_requested, snapshot_requested;
+
+			{
+				scoped_lock l(_mtx);
+
+				stop_requested = _stop_requested;
+				snapshot_requested = _snapshot_requested;
+				_snapshot_requested = false;
+			}
+			if (stop_requested)
+				break;
+
+			const unsigned int now = monotonic_milliseconds();
+
+			if (snapshot_requested)
+			{
+				scheduler.analyzed(now, analyze());
+				update();
+				scheduler.updated(now);
+				if (snapshot)
+					snapshot();
+				continue;
+			}
+			if (filled || scheduler.analysis_due(now))
+				scheduler.analyzed(now, analyze());
+			if (scheduler.update_due(now))
+			{
+				update();
+				scheduler.updated(now);
+			}
+		}
+		analyze();
+		update();
+	}
+
+	void analysis_worker::stop()
+	{
+		{
+			scoped_lock l(_mtx);
+
+			_stop_requested = true;
+		}
+		_wakeup.raise();
+	}
+
+	void analysis_worker::request_snapshot()
+	{
+		{
+			scoped_lock l(_mtx);
+
+			_snapshot_requested = true;
+		}
+		_wakeup.raise();
+	}
+}
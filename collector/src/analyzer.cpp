@@ -22,12 +22,16 @@
 
 namespace micro_profiler
 {
-	analyzer::analyzer(timestamp_t profiler_latency)
-		: _profiler_latency(profiler_latency)
+	analyzer::analyzer(timestamp_t profiler_latency, bool collect_latencies, bool collect_call_paths)
+		: _profiler_latency(profiler_latency), _collect_latencies(collect_latencies),
+			_collect_call_paths(collect_call_paths)
 	{	}
 
 	void analyzer::clear() throw()
-	{	_statistics.clear();	}
+	{
+		_statistics.clear();
+		_paths.commit();
+	}
 
 	size_t analyzer::size() const throw()
 	{	return _statistics.size();	}
@@ -38,12 +42,16 @@ namespace micro_profiler
 	analyzer::const_iterator analyzer::end() const throw()
 	{	return _statistics.end();	}
 
+	const call_paths &analyzer::paths() const throw()
+	{	return _paths;	}
+
 	void analyzer::accept_calls(unsigned int threadid, const call_record *calls, size_t count)
 	{
 		stacks_container::iterator i = _stacks.find(threadid);
 
 		if (i == _stacks.end())
-			i = _stacks.insert(std::make_pair(threadid, shadow_stack<statistics_map_detailed>(_profiler_latency))).first;
+			i = _stacks.insert(std::make_pair(threadid, shadow_stack<statistics_map_detailed>(_profiler_latency,
+				_collect_latencies, _collect_call_paths ? &_paths : 0))).first;
 		i->second.update(calls, calls + count, _statistics);
 	}
 }
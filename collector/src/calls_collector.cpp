@@ -45,7 +45,7 @@ namespace micro_profiler
 	class calls_collector::thread_trace_block
 	{
 	public:
-		explicit thread_trace_block(unsigned int thread_id, size_t trace_limit);
+		thread_trace_block(unsigned int thread_id, size_t trace_limit, event_flag &reader_wakeup);
 		thread_trace_block(const thread_trace_block &);
 
 		void track(const call_record &call) throw();
@@ -60,21 +60,25 @@ namespace micro_profiler
 
 	private:
 		const unsigned int _thread_id;
-		const size_t _trace_limit;
+		const size_t _trace_limit, _high_watermark;
+		event_flag &_reader_wakeup;
 		event_flag _proceed_collection;
 		trace_t _traces[2];
 		trace_t * volatile _active_trace, * volatile _inactive_trace;
 	};
 
 
-	calls_collector::thread_trace_block::thread_trace_block(unsigned int thread_id, size_t trace_limit)
-		: _thread_id(thread_id), _trace_limit(sizeof(call_record) * trace_limit), _proceed_collection(false, true),
-			_active_trace(&_traces[0]), _inactive_trace(&_traces[1])
+	calls_collector::thread_trace_block::thread_trace_block(unsigned int thread_id, size_t trace_limit,
+			event_flag &reader_wakeup)
+		: _thread_id(thread_id), _trace_limit(sizeof(call_record) * trace_limit),
+			_high_watermark(sizeof(call_record) * (trace_limit / 2)), _reader_wakeup(reader_wakeup),
+			_proceed_collection(false, true), _active_trace(&_traces[0]), _inactive_trace(&_traces[1])
 	{	}
 
 	calls_collector::thread_trace_block::thread_trace_block(const thread_trace_block &other)
-		: _thread_id(other._thread_id), _trace_limit(other._trace_limit), _proceed_collection(false, true),
-			_active_trace(&_traces[0]), _inactive_trace(&_traces[1])
+		: _thread_id(other._thread_id), _trace_limit(other._trace_limit), _high_watermark(other._high_watermark),
+			_reader_wakeup(other._reader_wakeup), _proceed_collection(false, true), _active_trace(&_traces[0]),
+			_inactive_trace(&_traces[1])
 	{	}
 
 	__forceinline void calls_collector::thread_trace_block::track(const call_record &call) throw()
@@ -94,7 +98,11 @@ namespace micro_profiler
 		bool enough_space = trace->byte_size() < _trace_limit;
 
 		if (enough_space)
+		{
 			trace->push_back(call);
+			if (trace->byte_size() == _high_watermark)
+				_reader_wakeup.raise();
+		}
 
 		atomic_store(_active_trace, trace);
 
@@ -122,7 +130,7 @@ namespace micro_profiler
 
 
 	calls_collector::calls_collector(size_t trace_limit)
-		: _trace_limit(trace_limit), _profiler_latency(0)
+		: _trace_limit(trace_limit), _profiler_latency(0), _reader_wakeup(false, true)
 	{
 		struct delay_evaluator : acceptor
 		{
@@ -162,12 +170,21 @@ namespace micro_profiler
 	void calls_collector::track(call_record call) throw()
 	{	get_current_thread_trace().track(call);	}
 
+#if defined(MP_RECORD_STACK_POINTERS)
+	void calls_collector::track(timestamp_t timestamp, const void *address, const void *stack_ptr) throw()
+	{
+		call_record call = { timestamp, address, stack_ptr };
+
+		get_current_thread_trace().track(call);
+	}
+#else
 	void calls_collector::track(timestamp_t timestamp, const void *address) throw()
 	{
 		call_record call = { timestamp, address };
 
 		get_current_thread_trace().track(call);
 	}
+#endif
 
 	size_t calls_collector::trace_limit() const throw()
 	{	return _trace_limit;	}
@@ -175,6 +192,9 @@ namespace micro_profiler
 	timestamp_t calls_collector::profiler_latency() const throw()
 	{	return _profiler_latency;	}
 
+	event_flag &calls_collector::reader_wakeup() throw()
+	{	return _reader_wakeup;	}
+
 	calls_collector::thread_trace_block &calls_collector::get_current_thread_trace()
 	{
 		if (thread_trace_block *trace = _trace_pointers_tls.get())
@@ -187,7 +207,7 @@ namespace micro_profiler
 	{
 		scoped_lock l(_thread_blocks_mtx);
 
-		calls_collector::thread_trace_block &trace = *_call_traces.insert(_call_traces.end(), thread_trace_block(current_thread_id(), _trace_limit));
+		calls_collector::thread_trace_block &trace = *_call_traces.insert(_call_traces.end(), thread_trace_block(current_thread_id(), _trace_limit, _reader_wakeup));
 		_trace_pointers_tls.set(&trace);
 		return trace;
 	}
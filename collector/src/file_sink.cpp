@@ -0,0 +1,160 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/file_sink.h>
+
+#include <common/recording.h>
+#include <common/string.h>
+
+#include <cstdio>
+#include <errno.h>
+#include <fcntl.h>
+#include <memory>
+#ifdef _WIN32
+	#include <io.h>
+	#include <sys/stat.h>
+#else
+	#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		enum {	buffer_size = 0x10000, max_sessions = 10000	};
+
+		FILE *create_new_file(const wstring &path)
+		{
+#ifdef _WIN32
+			const int fd = _wopen(path.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+
+			if (fd == -1)
+				return 0;
+			if (FILE *file = _fdopen(fd, "wb"))
+				return file;
+			_close(fd);
+#else
+			const int fd = ::open(unicode(path).c_str(), O_CREAT | O_EXCL | O_WRONLY, 0666);
+
+			if (fd == -1)
+				return 0;
+			if (FILE *file = fdopen(fd, "wb"))
+				return file;
+			close(fd);
+#endif
+			return 0;
+		}
+
+		class segment_files
+		{
+		public:
+			segment_files(const wstring &path)
+				: _segment(0)
+			{	create_session(path);	}
+
+			void write(unsigned int segment, const void *buffer, size_t size)
+			{
+				if (segment != _segment)
+				{
+					_segment = segment;
+					open();
+				}
+				if (_file)
+					fwrite(buffer, 1, size, _file.get());
+			}
+
+		private:
+			// The first segment is created exclusively, so that every session (a restarted collector or a child
+			// process inheriting the environment) gets a name of its own: 'path', 'path-1', 'path-2', etc.
+			void create_session(const wstring &path)
+			{
+				for (unsigned int n = 0; n != max_sessions; ++n)
+				{
+					const wstring session = n ? path + L"-" + to_wstring(static_cast<unsigned long long>(n)) : path;
+
+					if (FILE *file = create_new_file(session))
+					{
+						_path = session;
+						set_file(file);
+						return;
+					}
+					if (errno != EEXIST)
+						break;
+				}
+			}
+
+			void open()
+			{
+				const wstring path = _path + L"." + to_wstring(static_cast<unsigned long long>(_segment));
+
+				_file.reset();
+				if (_path.empty())
+					return;
+#ifdef _WIN32
+				set_file(_wfopen(path.c_str(), L"wb"));
+#else
+				set_file(fopen(unicode(path).c_str(), "wb"));
+#endif
+			}
+
+			void set_file(FILE *file)
+			{
+				if (file)
+				{
+					_file.reset(file, &fclose);
+					setvbuf(file, NULL, _IOFBF, buffer_size);
+				}
+			}
+
+		private:
+			wstring _path;
+			unsigned int _segment;
+			shared_ptr<FILE> _file;
+		};
+
+		class file_sink
+		{
+		public:
+			file_sink(const wstring &path, size_t segment_limit)
+				: _files(path), _writer(bind(&segment_files::write, &_files, _1, _2, _3), segment_limit)
+			{	}
+
+			bool write(const void *message, size_t size)
+			{
+				_writer.write(message, size);
+				return true;
+			}
+
+		private:
+			segment_files _files;
+			recording_writer _writer;
+		};
+	}
+
+	channel_t open_file_sink(const wstring &path, size_t segment_limit)
+	{
+		shared_ptr<file_sink> sink(new file_sink(path, segment_limit));
+
+		return bind(&file_sink::write, sink, _1, _2);
+	}
+}
@@ -20,9 +20,17 @@
 
 #include <collector/frontend_controller.h>
 
+#include <collector/analysis_worker.h>
+#include <collector/calls_collector.h>
 #include <collector/statistics_bridge.h>
 #include <collector/entry.h>
+#include <collector/snapshot.h>
+#include <collector/system.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
 #include <windows.h>
 #include <wpl/mt/thread.h>
 
@@ -34,50 +42,115 @@ namespace micro_profiler
 {
 	namespace
 	{
-		shared_ptr<void> create_waitable_timer(int period, PTIMERAPCROUTINE routine, void *parameter)
+		const wchar_t *c_timeline_var = L"MICROPROFILER_TIMELINE";
+		const wchar_t *c_timeline_window_var = L"MICROPROFILER_TIMELINE_WINDOW";
+		const wchar_t *c_statistics_format_var = L"MICROPROFILER_STATISTICS_FORMAT";
+		const wchar_t *c_compression_threshold_var = L"MICROPROFILER_COMPRESSION_THRESHOLD";
+		const wchar_t *c_analysis_interval_var = L"MICROPROFILER_ANALYSIS_INTERVAL";
+		const wchar_t *c_idle_analysis_interval_var = L"MICROPROFILER_IDLE_ANALYSIS_INTERVAL";
+		const wchar_t *c_update_interval_var = L"MICROPROFILER_UPDATE_INTERVAL";
+		const wchar_t *c_trace_recording_var = L"MICROPROFILER_TRACE_RECORDING";
+		const wchar_t *c_trace_segment_size_var = L"MICROPROFILER_TRACE_SEGMENT_SIZE";
+		const wchar_t *c_snapshot_var = L"MICROPROFILER_SNAPSHOT";
+		const wchar_t *c_snapshot_signal_var = L"MICROPROFILER_SNAPSHOT_SIGNAL";
+		const wchar_t *c_snapshot_reset_var = L"MICROPROFILER_SNAPSHOT_RESET";
+		const wchar_t *c_extended_analysis_var = L"MICROPROFILER_EXTENDED_ANALYSIS";
+		const size_t c_default_timeline_window = 100000;
+		const size_t c_default_trace_segment_size = 16 * 1024 * 1024;
+		const analysis_scheduler::intervals c_default_intervals = {	10, 500, 67	};
+
+		shared_ptr<timeline> create_timeline()
 		{
-			LARGE_INTEGER li_period = {};
-			shared_ptr<void> htimer(::CreateWaitableTimer(NULL, FALSE, NULL), &::CloseHandle);
+			const wstring window = get_environment(c_timeline_window_var);
 
-			li_period.QuadPart = -period * 10000;
-			::SetWaitableTimer(htimer.get(), &li_period, period, routine, parameter, FALSE);
-			return htimer;
+			return shared_ptr<timeline>(new timeline(window.empty() ? c_default_timeline_window
+				: static_cast<size_t>(wcstoul(window.c_str(), NULL, 10))));
 		}
 
-		void __stdcall analyze(void *bridge, DWORD /*ignored*/, DWORD /*ignored*/)
-		{	static_cast<statistics_bridge *>(bridge)->analyze();	}
+		shared_ptr<trace_recorder> create_trace_recorder(const calls_collector_i &collector)
+		{
+			const wstring directory = get_environment(c_trace_recording_var);
+			const wstring segment_size = get_environment(c_trace_segment_size_var);
+
+			if (directory.empty())
+				return shared_ptr<trace_recorder>();
+			return shared_ptr<trace_recorder>(new trace_recorder(directory, segment_size.empty()
+				? c_default_trace_segment_size : static_cast<size_t>(wcstoul(segment_size.c_str(), NULL, 10)),
+				ticks_per_second(), collector.profiler_latency()));
+		}
+
+		void write_file(const shared_ptr<FILE> &file, const void *buffer, size_t size)
+		{	fwrite(buffer, 1, size, file.get());	}
+
+		void export_timeline(const timeline &timeline_, const wstring &path)
+		{
+			if (FILE *file = _wfopen(path.c_str(), L"wb"))
+			{
+				timeline_.export_events(bind(&write_file, shared_ptr<FILE>(file, &fclose), _1, _2),
+					ticks_per_second(), ::GetCurrentProcessId());
+			}
+		}
 
-		void __stdcall update(void *bridge, DWORD /*ignored*/, DWORD /*ignored*/)
-		{	static_cast<statistics_bridge *>(bridge)->update_frontend();	}
+		update_formats get_statistics_format()
+		{
+			const wstring format = get_environment(c_statistics_format_var);
+
+			return format == L"columnar" ? update_format_columnar : format == L"indexed" ? update_format_indexed
+				: update_format_varint;
+		}
+
+		size_t get_compression_threshold()
+		{	return static_cast<size_t>(wcstoul(get_environment(c_compression_threshold_var).c_str(), NULL, 10));	}
+
+		unsigned int get_unsigned(const wchar_t *name, unsigned int default_value)
+		{
+			const wstring value = get_environment(name);
+
+			return value.empty() ? default_value : static_cast<unsigned int>(wcstoul(value.c_str(), NULL, 10));
+		}
+
+		analysis_scheduler::intervals get_intervals()
+		{
+			// A zero interval would have the worker spin, so each one is at least a millisecond.
+			analysis_scheduler::intervals intervals = {
+				max(1u, get_unsigned(c_analysis_interval_var, c_default_intervals.analysis)),
+				max(1u, get_unsigned(c_idle_analysis_interval_var, c_default_intervals.idle_analysis)),
+				max(1u, get_unsigned(c_update_interval_var, c_default_intervals.update)),
+			};
+
+			if (intervals.idle_analysis < intervals.analysis)
+				intervals.idle_analysis = intervals.analysis;
+			return intervals;
+		}
 	}
 
 	class frontend_controller::profiler_instance : public handle, wpl::noncopyable
 	{
 	public:
 		profiler_instance(const void *in_image_address, shared_ptr<image_load_queue> image_load_queue,
-			shared_ptr<volatile long> worker_refcount, shared_ptr<void> exit_event);
+			shared_ptr<volatile long> worker_refcount, shared_ptr<analysis_worker> worker);
 		virtual ~profiler_instance();
 
 	private:
 		const void *_in_image_address;
 		shared_ptr<image_load_queue> _image_load_queue;
 		shared_ptr<volatile long> _worker_refcount;
-		shared_ptr<void> _exit_event;
+		shared_ptr<analysis_worker> _worker;
 	};
 
 
 	frontend_controller::profiler_instance::profiler_instance(const void *in_image_address,
 			shared_ptr<image_load_queue> image_load_queue, shared_ptr<volatile long> worker_refcount,
-			shared_ptr<void> exit_event)
+			shared_ptr<analysis_worker> worker)
 		: _in_image_address(in_image_address), _image_load_queue(image_load_queue), _worker_refcount(worker_refcount),
-			_exit_event(exit_event)
+			_worker(worker)
 	{	_image_load_queue->load(in_image_address);	}
 
 	frontend_controller::profiler_instance::~profiler_instance()
 	{
 		_image_load_queue->unload(_in_image_address);
 		if (0 == _InterlockedDecrement(_worker_refcount.get()))
-			::SetEvent(_exit_event.get());
+			_worker->stop();
 	}
 
 
@@ -96,31 +169,31 @@ namespace micro_profiler
 	{
 		if (1 == _InterlockedIncrement(_worker_refcount.get()))
 		{
-			shared_ptr<void> exit_event(::CreateEvent(NULL, TRUE, FALSE, NULL), &::CloseHandle);
+			shared_ptr<analysis_worker> worker(new analysis_worker(_collector.reader_wakeup(), get_intervals()));
 			auto_ptr<thread> frontend_thread(new thread(bind(&frontend_controller::frontend_worker,
-				_frontend_thread.get(), _factory, &_collector, _image_load_queue, exit_event)));
+				_frontend_thread.get(), _factory, &_collector, _image_load_queue, worker)));
 
 			_frontend_thread.release();
 
-			swap(_exit_event, exit_event);
+			swap(_worker, worker);
 			swap(_frontend_thread, frontend_thread);
 		}
 
-		return new profiler_instance(in_image_address, _image_load_queue, _worker_refcount, _exit_event);
+		return new profiler_instance(in_image_address, _image_load_queue, _worker_refcount, _worker);
 	}
 
 	void frontend_controller::force_stop()
 	{
-		if (_exit_event && _frontend_thread.get())
+		if (_worker && _frontend_thread.get())
 		{
-			::SetEvent(_exit_event.get());
+			_worker->stop();
 			_frontend_thread->join();
 		}
 	}
 
 	void frontend_controller::frontend_worker(thread *previous_thread, const frontend_factory &factory,
 		calls_collector_i *collector, const shared_ptr<image_load_queue> &image_load_queue,
-		const shared_ptr<void> &exit_event)
+		const shared_ptr<analysis_worker> &worker)
 	{
 		if (previous_thread)
 			previous_thread->join();
@@ -128,13 +201,34 @@ namespace micro_profiler
 
 		::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
 
-		statistics_bridge b(*collector, factory, image_load_queue);
-		shared_ptr<void> analyzer_timer(create_waitable_timer(10, &analyze, &b));
-		shared_ptr<void> sender_timer(create_waitable_timer(67, &update, &b));
+		const wstring timeline_path = get_environment(c_timeline_var);
+		statistics_bridge b(*collector, factory, image_load_queue, get_statistics_format(),
+			get_compression_threshold(), true, !!get_unsigned(c_extended_analysis_var, 0));
+		shared_ptr<timeline> timeline_(timeline_path.empty() ? shared_ptr<timeline>() : create_timeline());
+
+		b.set_timeline(timeline_);
+		b.set_trace_recorder(create_trace_recorder(*collector));
+
+		const wstring snapshot_prefix = get_environment(c_snapshot_var);
+		auto_ptr<snapshot_writer> snapshots;
+		auto_ptr<snapshot_trigger> trigger;
+
+		if (!snapshot_prefix.empty())
+		{
+			shared_ptr<statistics_accumulator> accumulator(new statistics_accumulator);
+
+			b.set_accumulator(accumulator);
+			snapshots.reset(new snapshot_writer(snapshot_prefix, accumulator, ticks_per_second(),
+				!!get_unsigned(c_snapshot_reset_var, 0)));
+			trigger.reset(new snapshot_trigger(static_cast<int>(get_unsigned(c_snapshot_signal_var, 0)),
+				bind(&analysis_worker::request_snapshot, worker.get())));
+		}
 
-		while (WAIT_IO_COMPLETION == ::WaitForSingleObjectEx(exit_event.get(), INFINITE, TRUE))
-		{	}
-		b.analyze();
-		b.update_frontend();
+		worker->run(bind(&statistics_bridge::analyze, &b), bind(&statistics_bridge::update_frontend, &b),
+			snapshots.get() ? analysis_worker::snapshot_t(bind(&snapshot_writer::write, snapshots.get()))
+			: analysis_worker::snapshot_t());
+		trigger.reset();
+		if (timeline_)
+			export_timeline(*timeline_, timeline_path);
 	}
 }
@@ -47,7 +47,13 @@ IF _M_IX86
 
 	_profile_enter	proc
 		PUSHREGS
+IFDEF MP_RECORD_STACK_POINTERS
+		lea	ecx, [esp + 10h]
+		push	ecx
+		mov	ecx, [esp + 10h]
+ELSE
 		mov	ecx, [esp + 0Ch]
+ENDIF
 		push	ecx
 		PUSHRDTSC
 		mov	ecx, offset ?_instance@calls_collector@micro_profiler@@0V12@A
@@ -58,6 +64,10 @@ IF _M_IX86
 
 	_profile_exit	proc
 		PUSHREGS
+IFDEF MP_RECORD_STACK_POINTERS
+		lea	ecx, [esp + 10h]
+		push	ecx
+ENDIF
 		push 0
 		PUSHRDTSC
 		mov	ecx, offset ?_instance@calls_collector@micro_profiler@@0V12@A
@@ -70,7 +80,13 @@ ELSEIF _M_X64
 
 	.code
 
-	extrn ?track@calls_collector@micro_profiler@@QEAAX_JPEBX@Z:near
+IFDEF MP_RECORD_STACK_POINTERS
+	TRACK	equ	<?track@calls_collector@micro_profiler@@QEAAX_JPEBX1@Z>
+ELSE
+	TRACK	equ	<?track@calls_collector@micro_profiler@@QEAAX_JPEBX@Z>
+ENDIF
+
+	extrn TRACK:near
 	extrn ?_instance@calls_collector@micro_profiler@@0V12@A:qword
 
 	PUSHREGS	macro
@@ -108,7 +124,10 @@ ELSEIF _M_X64
 		RDTSC64
 		mov	rcx, offset ?_instance@calls_collector@micro_profiler@@0V12@A
 		mov	r8, qword ptr [rsp + 68h]
-		call	?track@calls_collector@micro_profiler@@QEAAX_JPEBX@Z
+IFDEF MP_RECORD_STACK_POINTERS
+		lea	r9, [rsp + 70h]
+ENDIF
+		call	TRACK
 
 		add	rsp, 28h
 		POPREGS
@@ -124,8 +143,11 @@ ELSEIF _M_X64
 
 		mov	rcx, offset ?_instance@calls_collector@micro_profiler@@0V12@A
 		xor	r8, r8
+IFDEF MP_RECORD_STACK_POINTERS
+		lea	r9, [rsp + 70h]
+ENDIF
 		RDTSC64
-		call	?track@calls_collector@micro_profiler@@QEAAX_JPEBX@Z
+		call	TRACK
 
 		add	rsp, 30h
 		movdqu	xmm0, [rsp - 10h]
@@ -21,8 +21,10 @@
 #include <crtdbg.h>
 
 #include <collector/channel_client.h>
+#include <collector/file_sink.h>
 #include <collector/frontend_controller.h>
 #include <collector/entry.h>
+#include <collector/system.h>
 #include <common/constants.h>
 
 #include <windows.h>
@@ -40,6 +42,10 @@ namespace micro_profiler
 		unsigned char g_exitprocess_patch[] = { 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE0 };
 		void **g_exitprocess_patch_jmp_address = reinterpret_cast<void **>(g_exitprocess_patch + 2);
 #endif
+		const wchar_t *c_recording_var = L"MICROPROFILER_RECORDING";
+		const wchar_t *c_recording_segment_limit_var = L"MICROPROFILER_RECORDING_SEGMENT_LIMIT";
+		const size_t c_default_recording_segment_limit = 64 * 1024 * 1024;
+
 		auto_ptr<frontend_controller> g_frontend_controller;
 		void *g_exitprocess_address = 0;
 		volatile long g_patch_lockcount = 0;
@@ -66,6 +72,19 @@ namespace micro_profiler
 			::ExitProcess(exit_code);
 		}
 
+		frontend_factory create_frontend_factory()
+		{
+			const wstring recording_path = get_environment(c_recording_var);
+
+			if (recording_path.empty())
+				return bind(&open_channel, reinterpret_cast<const guid_t &>(c_frontendClassID));
+
+			const wstring limit = get_environment(c_recording_segment_limit_var);
+
+			return bind(&open_file_sink, recording_path, limit.empty() ? c_default_recording_segment_limit
+				: static_cast<size_t>(wcstoul(limit.c_str(), NULL, 10)));
+		}
+
 		void PatchExitProcess()
 		{
 			shared_ptr<void> hkernel(::LoadLibraryW(L"kernel32.dll"), &::FreeLibrary);
@@ -86,8 +105,7 @@ extern "C" BOOL WINAPI DllMain(HINSTANCE /*hinstance*/, DWORD reason, LPVOID /*r
 	case DLL_PROCESS_ATTACH:
 		_CrtSetDbgFlag(_CrtSetDbgFlag(_CRTDBG_REPORT_FLAG) | _CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 
-		g_frontend_controller.reset(new frontend_controller(*calls_collector::instance(),
-			bind(&open_channel, reinterpret_cast<const guid_t &>(c_frontendClassID))));
+		g_frontend_controller.reset(new frontend_controller(*calls_collector::instance(), create_frontend_factory()));
 		break;
 
 	case DLL_PROCESS_DETACH:
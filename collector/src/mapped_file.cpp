@@ -0,0 +1,92 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/mapped_file.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <common/string.h>
+
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace micro_profiler
+{
+#ifdef _WIN32
+	mapped_file::mapped_file(const wstring &path, size_t size)
+		: _data(0), _size(size), _final_size(size), _mapping(0)
+	{
+		const unsigned long long size64 = size;
+
+		_file = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL, NULL);
+		if (INVALID_HANDLE_VALUE == _file)
+			return;
+		_mapping = ::CreateFileMappingW(_file, NULL, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+			static_cast<DWORD>(size64), NULL);
+		if (_mapping)
+			_data = static_cast<byte *>(::MapViewOfFile(_mapping, FILE_MAP_WRITE, 0, 0, size));
+	}
+
+	mapped_file::~mapped_file()
+	{
+		LARGE_INTEGER final_size;
+
+		if (_data)
+			::UnmapViewOfFile(_data);
+		if (_mapping)
+			::CloseHandle(_mapping);
+		if (INVALID_HANDLE_VALUE == _file)
+			return;
+		final_size.QuadPart = _final_size;
+		if (::SetFilePointerEx(_file, final_size, NULL, FILE_BEGIN))
+			::SetEndOfFile(_file);
+		::CloseHandle(_file);
+	}
+#else
+	mapped_file::mapped_file(const wstring &path, size_t size)
+		: _data(0), _size(size), _final_size(size)
+	{
+		_file = ::open(unicode(path).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (_file < 0 || ::ftruncate(_file, size))
+			return;
+
+		void *data = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0);
+
+		if (MAP_FAILED != data)
+			_data = static_cast<byte *>(data);
+	}
+
+	mapped_file::~mapped_file()
+	{
+		if (_data)
+			::munmap(_data, _size);
+		if (_file < 0)
+			return;
+		::ftruncate(_file, _final_size);
+		::close(_file);
+	}
+#endif
+}
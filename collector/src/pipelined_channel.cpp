@@ -0,0 +1,95 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/pipelined_channel.h>
+
+#include <wpl/mt/thread.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	pipelined_channel::pipelined_channel(const frontend_factory &factory, size_t max_queued)
+		: _factory(factory), _max_queued(max_queued), _filling(&_batches[0]), _stop(false), _posted(false, true),
+			_swapped(false, true)
+	{	_thread.reset(new wpl::mt::thread(bind(&pipelined_channel::worker, this)));	}
+
+	pipelined_channel::~pipelined_channel()
+	{
+		{
+			scoped_lock l(_mtx);
+
+			_stop = true;
+		}
+		_posted.raise();
+		_thread->join();
+	}
+
+	bool pipelined_channel::operator ()(const void *data, size_t size)
+	{
+		for (bool queued = false; !queued; )
+		{
+			{
+				scoped_lock l(_mtx);
+
+				if (!_filling->data.size() || _filling->data.size() + size <= _max_queued)
+				{
+					_filling->data.append(static_cast<const byte *>(data), static_cast<const byte *>(data) + size);
+					_filling->ends.push_back(_filling->data.size());
+					queued = true;
+				}
+			}
+			_posted.raise();
+			if (!queued)
+				_swapped.wait();
+		}
+		return true;
+	}
+
+	void pipelined_channel::worker()
+	{
+		const channel_t underlying = _factory();
+
+		for (bool stop = false; !stop; )
+		{
+			batch *sending;
+
+			_posted.wait();
+			{
+				scoped_lock l(_mtx);
+
+				sending = _filling;
+				_filling = sending == &_batches[0] ? &_batches[1] : &_batches[0];
+				stop = _stop;
+			}
+			_swapped.raise();
+
+			size_t begin = 0;
+
+			if (underlying)
+			{
+				for (vector<size_t>::const_iterator i = sending->ends.begin(); i != sending->ends.end(); begin = *i++)
+					underlying(sending->data.data() + begin, *i - begin);
+			}
+			sending->data.clear();
+			sending->ends.clear();
+		}
+	}
+}
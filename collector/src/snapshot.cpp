@@ -0,0 +1,199 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/snapshot.h>
+
+#include <collector/statistics_accumulator.h>
+
+#include <common/serialization.h>
+#include <common/string.h>
+
+#include <cstdio>
+#include <ctime>
+#include <strmd/serializer.h>
+#include <wpl/mt/thread.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <errno.h>
+	#include <semaphore.h>
+	#include <signal.h>
+#endif
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		class file_writer
+		{
+		public:
+			file_writer(FILE *file)
+				: _file(file)
+			{	}
+
+			void write(const void *data, size_t size)
+			{	fwrite(data, 1, size, _file);	}
+
+		private:
+			FILE *_file;
+		};
+	}
+
+	snapshot_writer::snapshot_writer(const wstring &prefix, const shared_ptr<statistics_accumulator> &statistics,
+			timestamp_t ticks_per_second, bool reset)
+		: _prefix(prefix), _statistics(statistics), _ticks_per_second(ticks_per_second), _reset(reset), _sequence(0)
+	{	}
+
+	wstring snapshot_writer::write()
+	{
+		const wstring path = next_path();
+#ifdef _WIN32
+		FILE *file = _wfopen(path.c_str(), L"wb");
+#else
+		FILE *file = fopen(unicode(path).c_str(), "wb");
+#endif
+
+		if (!file)
+			return wstring();
+
+		shared_ptr<FILE> guard(file, &fclose);
+		file_writer writer(file);
+		strmd::serializer<file_writer, packer> archive(writer);
+
+		_statistics->save(archive, _ticks_per_second);
+		if (_reset)
+			_statistics->reset();
+		return path;
+	}
+
+	wstring snapshot_writer::next_path()
+	{
+		const time_t now = time(NULL);
+		char suffix[64];
+
+		strftime(suffix, sizeof(suffix), "-%Y%m%d-%H%M%S-", localtime(&now));
+		return _prefix + unicode(suffix) + to_wstring(static_cast<unsigned long long>(_sequence++)) + L".mpstats";
+	}
+
+
+#ifdef _WIN32
+	struct snapshot_trigger::platform_state
+	{
+		platform_state(int /*signal*/)
+		{
+			const wstring name = L"Local\\micro-profiler-snapshot-"
+				+ to_wstring(static_cast<unsigned long long>(::GetCurrentProcessId()));
+
+			events[0] = ::CreateEventW(NULL, FALSE, FALSE, NULL);
+			events[1] = ::CreateEventW(NULL, FALSE, FALSE, name.c_str());
+		}
+
+		~platform_state()
+		{
+			if (events[1])
+				::CloseHandle(events[1]);
+			::CloseHandle(events[0]);
+		}
+
+		void wake()
+		{	::SetEvent(events[0]);	}
+
+		bool wait()
+		{	return events[1] && WAIT_OBJECT_0 + 1 == ::WaitForMultipleObjects(2, events, FALSE, INFINITE);	}
+
+		HANDLE events[2];
+	};
+#else
+	namespace
+	{
+		// sem_post() is async-signal-safe, unlike anything from wpl::mt, so the handler only counts the requests.
+		sem_t g_requests;
+
+		void on_signal(int /*signal*/)
+		{	sem_post(&g_requests);	}
+	}
+
+	struct snapshot_trigger::platform_state
+	{
+		platform_state(int signal_)
+			: signal(signal_ ? signal_ : SIGUSR2)
+		{
+			struct sigaction action = {	};
+
+			sem_init(&g_requests, 0, 0);
+			action.sa_handler = &on_signal;
+			action.sa_flags = SA_RESTART;
+			sigemptyset(&action.sa_mask);
+			sigaction(signal, &action, &previous);
+		}
+
+		~platform_state()
+		{
+			sigaction(signal, &previous, NULL);
+			sem_destroy(&g_requests);
+		}
+
+		void wake()
+		{	sem_post(&g_requests);	}
+
+		bool wait()
+		{
+			while (sem_wait(&g_requests) && errno == EINTR)
+			{	}
+			return true;
+		}
+
+		const int signal;
+		struct sigaction previous;
+	};
+#endif
+
+	snapshot_trigger::snapshot_trigger(int signal, const function<void ()> &handler)
+		: _handler(handler), _stop(false), _state(new platform_state(signal))
+	{	_thread.reset(new wpl::mt::thread(bind(&snapshot_trigger::worker, this)));	}
+
+	snapshot_trigger::~snapshot_trigger()
+	{
+		{
+			scoped_lock l(_mtx);
+
+			_stop = true;
+		}
+		_state->wake();
+		_thread->join();
+	}
+
+	void snapshot_trigger::worker()
+	{
+		while (_state->wait())
+		{
+			{
+				scoped_lock l(_mtx);
+
+				if (_stop)
+					break;
+			}
+			_handler();
+		}
+	}
+}
@@ -0,0 +1,102 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/statistics_accumulator.h>
+
+#include <collector/analyzer.h>
+
+#include <common/path.h>
+#include <common/string.h>
+
+#include <stdio.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		long_address_t to_long_address(const void *address)
+		{	return reinterpret_cast<size_t>(address);	}
+	}
+
+	void statistics_accumulator::accumulate(const analyzer &source)
+	{
+		const call_paths &paths = source.paths();
+
+		for (analyzer::const_iterator i = source.begin(); i != source.end(); ++i)
+		{
+			function_statistics_detailed_t<long_address_t> &to = _statistics[to_long_address(i->first)];
+
+			to += i->second;
+			for (statistics_map_detailed::mapped_type::callees_map::const_iterator j = i->second.callees.begin();
+				j != i->second.callees.end(); ++j)
+			{
+				to.callees[to_long_address(j->first)] += j->second;
+			}
+			to.latencies += i->second.latencies;
+		}
+
+		// Paths are interned parents first, so the parent of each path is already mapped when it is reached.
+		if (_path_map.empty())
+			_path_map.push_back(call_paths::root);
+		for (call_paths::path_id i = static_cast<call_paths::path_id>(_path_map.size()); i < paths.size(); ++i)
+			_path_map.push_back(_paths.intern(_path_map[paths[i].parent], paths[i].function));
+		for (call_paths::path_id i = 1; i < paths.size(); ++i)
+			_paths.add_time(_path_map[i], paths[i].exclusive_time);
+	}
+
+	void statistics_accumulator::switch_source() throw()
+	{	_path_map.clear();	}
+
+	void statistics_accumulator::reset()
+	{
+		_statistics.clear();
+		_paths = call_paths();
+		_path_map.clear();
+	}
+
+	void statistics_accumulator::add_modules(const loaded_modules &modules)
+	{
+		for (loaded_modules::const_iterator i = modules.begin(); i != modules.end(); ++i)
+			_modules[i->load_address] = *i->path;
+	}
+
+	const statistics_map_detailed_t<long_address_t> &statistics_accumulator::statistics() const throw()
+	{	return _statistics;	}
+
+	const call_paths &statistics_accumulator::paths() const throw()
+	{	return _paths;	}
+
+	wstring statistics_accumulator::address_name(long_address_t address) const
+	{
+		map<long_address_t, wstring>::const_iterator m = _modules.upper_bound(address);
+		char name[32];
+
+		if (m == _modules.begin())
+		{
+			sprintf(name, "0x%llX", address);
+			return unicode(name);
+		}
+		--m;
+		sprintf(name, "+0x%llX", address - m->first);
+		return m->second + unicode(name);
+	}
+}
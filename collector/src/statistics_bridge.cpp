@@ -22,6 +22,8 @@
 
 #include <collector/calls_collector.h>
 
+#include <common/columnar.h>
+#include <common/compression.h>
 #include <common/module.h>
 #include <common/protocol.h>
 #include <common/serialization.h>
@@ -31,12 +33,14 @@
 #include <strmd/serializer.h>
 
 using namespace std;
+using namespace std::placeholders;
 
 namespace micro_profiler
 {
 	namespace
 	{
 		const timestamp_t c_ticks_per_second(ticks_per_second());
+		const size_t c_max_pipelined_bytes = 16 * 1024 * 1024;
 
 		class vector_writer
 		{
@@ -59,6 +63,50 @@ namespace micro_profiler
 		private:
 			pod_vector<byte> &_buffer;
 		};
+
+		class acceptor_tee : public calls_collector_i::acceptor
+		{
+		public:
+			acceptor_tee(calls_collector_i::acceptor &first, calls_collector_i::acceptor *second)
+				: _first(first), _second(second)
+			{	}
+
+			virtual void accept_calls(unsigned int threadid, const call_record *calls, size_t count)
+			{
+				_first.accept_calls(threadid, calls, count);
+				if (_second)
+					_second->accept_calls(threadid, calls, count);
+			}
+
+		private:
+			void operator =(const acceptor_tee &other);
+
+		private:
+			calls_collector_i::acceptor &_first, *_second;
+		};
+
+		class calls_counter : public calls_collector_i::acceptor
+		{
+		public:
+			calls_counter(calls_collector_i::acceptor &underlying)
+				: calls(0), _underlying(underlying)
+			{	}
+
+			virtual void accept_calls(unsigned int threadid, const call_record *calls_, size_t count)
+			{
+				calls += count;
+				_underlying.accept_calls(threadid, calls_, count);
+			}
+
+		public:
+			size_t calls;
+
+		private:
+			void operator =(const calls_counter &other);
+
+		private:
+			calls_collector_i::acceptor &_underlying;
+		};
 	}
 
 	void image_load_queue::load(const void *in_image_address)
@@ -91,19 +139,45 @@ namespace micro_profiler
 
 	statistics_bridge::statistics_bridge(calls_collector_i &collector,
 			const function<channel_t ()> &factory,
-			const std::shared_ptr<image_load_queue> &image_load_queue)
-		: _analyzer(collector.profiler_latency()), _collector(collector), _frontend(factory()),
-			_image_load_queue(image_load_queue)
+			const std::shared_ptr<image_load_queue> &image_load_queue, update_formats format,
+			size_t compression_threshold, bool pipelined, bool extended_analysis)
+		: _analyzer(collector.profiler_latency(), extended_analysis, extended_analysis), _format(format),
+			_compression_threshold(compression_threshold), _collector(collector), _image_load_queue(image_load_queue)
 	{
 		initialization_data idata = {
 			get_module_info(0).path,
-			c_ticks_per_second
+			c_ticks_per_second,
+			format
 		};
+
+		if (pipelined)
+		{
+			_pipeline.reset(new pipelined_channel(factory, c_max_pipelined_bytes));
+			_frontend = bind(&pipelined_channel::operator (), _pipeline.get(), _1, _2);
+		}
+		else
+			_frontend = factory();
 		send(init, idata);
 	}
 
-	void statistics_bridge::analyze()
-	{	_collector.read_collected(_analyzer);	}
+	void statistics_bridge::set_timeline(const shared_ptr<timeline> &timeline_)
+	{	_timeline = timeline_;	}
+
+	void statistics_bridge::set_trace_recorder(const shared_ptr<trace_recorder> &recorder)
+	{	_trace_recorder = recorder;	}
+
+	void statistics_bridge::set_accumulator(const shared_ptr<statistics_accumulator> &accumulator)
+	{	_accumulator = accumulator;	}
+
+	bool statistics_bridge::analyze()
+	{
+		acceptor_tee with_recorder(_analyzer, _trace_recorder.get());
+		acceptor_tee with_timeline(with_recorder, _timeline.get());
+		calls_counter counter(with_timeline);
+
+		_collector.read_collected(counter);
+		return !!counter.calls;
+	}
 
 	void statistics_bridge::update_frontend()
 	{
@@ -112,11 +186,28 @@ namespace micro_profiler
 		
 		_image_load_queue->get_changes(loaded, unloaded);
 		if (!loaded.empty())
+		{
 			send(modules_loaded, loaded);
+			if (_accumulator)
+				_accumulator->add_modules(loaded);
+			if (_timeline)
+				_timeline->add_modules(loaded);
+		}
 		if (_analyzer.size())
-			send(update_statistics, _analyzer);
+		{
+			if (_format == update_format_columnar)
+				send_columnar();
+			else if (_format == update_format_indexed)
+				send_indexed();
+			else
+				send(update_statistics, _analyzer);
+		}
+		if (_analyzer.paths().changed())
+			send(update_call_paths, _analyzer.paths());
 		if (!unloaded.empty())
 			send(modules_unloaded, unloaded);
+		if (_accumulator)
+			_accumulator->accumulate(_analyzer);
 		_analyzer.clear();
 	}
 
@@ -130,7 +221,65 @@ namespace micro_profiler
 
 			archive(command);
 			archive(data);
-			_frontend(_buffer.data(), static_cast<long>(_buffer.size()));
+			transmit();
+		}
+	}
+
+	void statistics_bridge::send_columnar()
+	{
+		if (_frontend)
+		{
+			vector_writer writer(_buffer);
+			strmd::serializer<vector_writer, packer> archive(writer);
+			commands command = update_statistics;
+
+			archive(command);
+			write_columnar(writer, _analyzer.begin(), _analyzer.end());
+			transmit();
+		}
+	}
+
+	void statistics_bridge::send_indexed()
+	{
+		// Addresses met for the first time are registered before the update referring to them by id.
+		_dictionary.register_addresses(_analyzer, _registered);
+		if (!_registered.empty())
+			send(register_addresses, _registered);
+
+		indexed_statistics_t<analyzer> update = {	_analyzer, _dictionary	};
+
+		send(update_statistics, update);
+	}
+
+	void statistics_bridge::transmit()
+	{
+		const size_t size = _buffer.size();
+
+		// Small messages are sent raw, as are the ones compression does not make shorter.
+		if (_compression_threshold && size >= _compression_threshold && size <= c_max_uncompressed_size)
+		{
+			vector_writer writer(_compressed_buffer);
+			strmd::serializer<vector_writer, packer> archive(writer);
+			commands command = compressed;
+			unsigned int uncompressed_size = static_cast<unsigned int>(size);
+
+			archive(command);
+			archive(uncompressed_size);
+
+			const size_t header_size = _compressed_buffer.size();
+
+			_compressed_buffer.resize(header_size + compress_bound(size));
+			if (_compressed_buffer.size() == header_size + compress_bound(size))
+			{
+				_compressed_buffer.resize(header_size + compress(_compressed_buffer.data() + header_size,
+					_buffer.data(), size));
+				if (_compressed_buffer.size() < size)
+				{
+					_frontend(_compressed_buffer.data(), static_cast<long>(_compressed_buffer.size()));
+					return;
+				}
+			}
 		}
+		_frontend(_buffer.data(), static_cast<long>(size));
 	}
 }
@@ -20,9 +20,18 @@
 
 #include <collector/system.h>
 
+#include <common/string.h>
+
 #include <intrin.h>
 #include <memory>
-#include <windows.h>
+#include <vector>
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <stdlib.h>
+	#include <time.h>
+#endif
 
 #pragma intrinsic(__rdtsc)
 
@@ -46,7 +55,42 @@ namespace micro_profiler
 	unsigned int current_thread_id()
 	{	return ::GetCurrentThreadId();	}
 
+	std::wstring get_environment(const wchar_t *name)
+	{
+#ifdef _WIN32
+		if (DWORD result = ::GetEnvironmentVariableW(name, NULL, 0))
+		{
+			std::vector<wchar_t> buffer(result);
+
+			::GetEnvironmentVariableW(name, &buffer[0], result);
+			return &buffer[0];
+		}
+		return std::wstring();
+#else
+		const char *value = ::getenv(unicode(name).c_str());
+
+		return value ? unicode(std::string(value)) : std::wstring();
+#endif
+	}
+
+	unsigned int monotonic_milliseconds()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER pc_freq, pc;
+
+		::QueryPerformanceFrequency(&pc_freq);
+		::QueryPerformanceCounter(&pc);
+		return static_cast<unsigned int>(pc.QuadPart / (pc_freq.QuadPart / 1000));
+#else
+		timespec t;
 
+		::clock_gettime(CLOCK_MONOTONIC, &t);
+		return static_cast<unsigned int>(static_cast<unsigned long long>(t.tv_sec) * 1000 + t.tv_nsec / 1000000);
+#endif
+	}
+
+
+#ifdef _WIN32
 	mutex::mutex()
 	{
 		typedef char static_size_assertion[sizeof(CRITICAL_SECTION) <= sizeof(_mtx_buffer)];
@@ -62,6 +106,46 @@ namespace micro_profiler
 
 	void mutex::leave()
 	{	::LeaveCriticalSection(static_cast<CRITICAL_SECTION *>(static_cast<void*>(_mtx_buffer)));	}
+#else
+	mutex::mutex()
+	{
+		typedef char static_size_assertion[sizeof(pthread_mutex_t) <= sizeof(_mtx_buffer)];
+
+		pthread_mutex_init(static_cast<pthread_mutex_t *>(static_cast<void*>(_mtx_buffer)), NULL);
+	}
+
+	mutex::~mutex()
+	{	pthread_mutex_destroy(static_cast<pthread_mutex_t *>(static_cast<void*>(_mtx_buffer)));	}
+
+	void mutex::enter()
+	{	pthread_mutex_lock(static_cast<pthread_mutex_t *>(static_cast<void*>(_mtx_buffer)));	}
+
+	void mutex::leave()
+	{	pthread_mutex_unlock(static_cast<pthread_mutex_t *>(static_cast<void*>(_mtx_buffer)));	}
+
+
+	condition::condition()
+	{
+		typedef char static_size_assertion[sizeof(pthread_cond_t) <= sizeof(_cv_buffer)];
+
+		pthread_cond_init(static_cast<pthread_cond_t *>(static_cast<void*>(_cv_buffer)), NULL);
+	}
+
+	condition::~condition()
+	{	pthread_cond_destroy(static_cast<pthread_cond_t *>(static_cast<void*>(_cv_buffer)));	}
+
+	void condition::wait(mutex &mtx)
+	{
+		pthread_cond_wait(static_cast<pthread_cond_t *>(static_cast<void*>(_cv_buffer)),
+			static_cast<pthread_mutex_t *>(static_cast<void*>(mtx._mtx_buffer)));
+	}
+
+	void condition::notify_one()
+	{	pthread_cond_signal(static_cast<pthread_cond_t *>(static_cast<void*>(_cv_buffer)));	}
+
+	void condition::notify_all()
+	{	pthread_cond_broadcast(static_cast<pthread_cond_t *>(static_cast<void*>(_cv_buffer)));	}
+#endif
 
 
    long interlocked_compare_exchange(long volatile *destination, long exchange, long comperand)
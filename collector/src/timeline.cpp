@@ -0,0 +1,150 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/timeline.h>
+
+#include <common/path.h>
+#include <common/string.h>
+
+#include <algorithm>
+#include <stdio.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	timeline::thread_window::thread_window()
+		: _head(0)
+	{	}
+
+	void timeline::thread_window::append(const call_record *calls, size_t count, size_t window)
+	{
+		if (count > window)
+			calls += count - window, count = window;
+		while (count && _records.size() < window)
+			_records.push_back(*calls++), --count;
+		for (; count; --count, _head = (_head + 1) % window)
+			_records[_head] = *calls++;
+	}
+
+	size_t timeline::thread_window::size() const throw()
+	{	return _records.size();	}
+
+	const call_record &timeline::thread_window::operator [](size_t index) const throw()
+	{	return _records[(_head + index) % _records.size()];	}
+
+
+	timeline::timeline(size_t window)
+		: _window(window)
+	{	}
+
+	size_t timeline::window() const throw()
+	{	return _window;	}
+
+	size_t timeline::size() const
+	{
+		scoped_lock l(_mtx);
+		size_t total = 0;
+
+		for (windows_map::const_iterator i = _windows.begin(); i != _windows.end(); ++i)
+			total += i->second.size();
+		return total;
+	}
+
+	void timeline::clear()
+	{
+		scoped_lock l(_mtx);
+
+		_windows.clear();
+	}
+
+	void timeline::add_modules(const loaded_modules &modules)
+	{
+		scoped_lock l(_mtx);
+
+		for (loaded_modules::const_iterator i = modules.begin(); i != modules.end(); ++i)
+			_modules[i->load_address] = unicode(*i->path);
+	}
+
+	void timeline::export_events(const trace_events_writer::sink_t &sink, timestamp_t ticks_per_second,
+		unsigned int pid) const
+	{
+		scoped_lock l(_mtx);
+		bool has_origin = false;
+		timestamp_t origin = 0;
+
+		for (windows_map::const_iterator i = _windows.begin(); i != _windows.end(); ++i)
+		{
+			if (i->second.size() && (!has_origin || i->second[0].timestamp < origin))
+				origin = i->second[0].timestamp, has_origin = true;
+		}
+
+		trace_events_writer writer(sink, ticks_per_second, origin, pid);
+
+		for (windows_map::const_iterator i = _windows.begin(); i != _windows.end(); ++i)
+		{
+			const thread_window &w = i->second;
+			size_t depth = 0;
+
+			// Exits of the calls entered before the window are dropped - they have no begin event to match.
+			for (size_t j = 0, count = w.size(); j != count; ++j)
+			{
+				if (w[j].callee)
+				{
+					const string name = event_name(reinterpret_cast<size_t>(w[j].callee));
+
+					writer.begin(i->first, w[j].timestamp, name.c_str());
+					++depth;
+				}
+				else if (depth)
+				{
+					writer.end(i->first, w[j].timestamp);
+					--depth;
+				}
+			}
+		}
+		writer.close();
+	}
+
+	void timeline::accept_calls(unsigned int threadid, const call_record *calls, size_t count)
+	{
+		if (!_window)
+			return;
+
+		scoped_lock l(_mtx);
+
+		_windows[threadid].append(calls, count, _window);
+	}
+
+	string timeline::event_name(long_address_t address) const
+	{
+		map<long_address_t, string>::const_iterator m = _modules.upper_bound(address);
+		char name[32];
+
+		if (m == _modules.begin())
+		{
+			sprintf(name, "0x%llx", address);
+			return name;
+		}
+		--m;
+		sprintf(name, "+0x%llx", address - m->first);
+		return m->second + name;
+	}
+}
@@ -0,0 +1,204 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/trace_recorder.h>
+
+#include <collector/mapped_file.h>
+
+#include <common/path.h>
+#include <common/string.h>
+
+#include <algorithm>
+#include <errno.h>
+#ifdef _WIN32
+	#include <direct.h>
+#else
+	#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		FILE *create_file(const wstring &path)
+		{
+#ifdef _WIN32
+			return _wfopen(path.c_str(), L"wb");
+#else
+			return fopen(unicode(path).c_str(), "wb");
+#endif
+		}
+
+		enum {	max_sessions = 10000	};
+
+		bool create_directory(const wstring &path)
+		{
+#ifdef _WIN32
+			return !_wmkdir(path.c_str());
+#else
+			return !mkdir(unicode(path).c_str(), 0777);
+#endif
+		}
+
+		wstring create_session_directory(const wstring &directory)
+		{
+			for (unsigned int n = 1; n != max_sessions; ++n)
+			{
+				const wstring session = directory & to_wstring(static_cast<unsigned long long>(n));
+
+				if (create_directory(session))
+					return session;
+				if (errno != EEXIST)
+					break;
+			}
+			return wstring();
+		}
+
+		raw_trace_header &header(mapped_file &file)
+		{	return *static_cast<raw_trace_header *>(static_cast<void *>(file.data()));	}
+	}
+
+	trace_recorder::thread_trace::thread_trace()
+		: segment(0), index_offset(-1), stopped(false)
+	{	}
+
+
+	trace_recorder::trace_recorder(const wstring &directory, size_t segment_size, timestamp_t ticks_per_second,
+			timestamp_t profiler_latency)
+		: _directory(create_session_directory(directory)),
+			_segment_size(max<size_t>(min_segment_size, segment_size))
+	{
+		if (_directory.empty())
+			return;
+		if (FILE *index = create_file(_directory & L"index"))
+		{
+			raw_trace_index_header header;
+
+			header.signature = raw_trace_signature;
+			header.reserved = 0;
+			header.ticks_per_second = ticks_per_second;
+			header.profiler_latency = profiler_latency;
+			_index.reset(index, &fclose);
+			fwrite(&header, sizeof(header), 1, index);
+			fflush(index);
+		}
+	}
+
+	trace_recorder::~trace_recorder()
+	{
+		for (traces_map::iterator i = _traces.begin(); i != _traces.end(); ++i)
+			close_segment(*i->second);
+	}
+
+	void trace_recorder::accept_calls(unsigned int threadid, const call_record *calls, size_t count)
+	{
+		if (_directory.empty())
+			return;
+
+		shared_ptr<thread_trace> &ptrace = _traces[threadid];
+
+		if (!ptrace)
+			ptrace.reset(new thread_trace);
+
+		for (thread_trace &trace = *ptrace; count && !trace.stopped; )
+		{
+			size_t available = trace.file.get()
+				? trace.file->size() - sizeof(raw_trace_header) - static_cast<size_t>(header(*trace.file).size) : 0;
+
+			if (available < max_packed_call_record_size)
+			{
+				close_segment(trace);
+				if (!open_segment(threadid, trace))
+					return;
+				available = trace.file->size() - sizeof(raw_trace_header);
+			}
+
+			raw_trace_header &h = header(*trace.file);
+			const size_t n = min(count, available / max_packed_call_record_size);
+
+			if (!h.records)
+				h.first_timestamp = calls->timestamp;
+			h.size += trace.encoder.encode(trace.file->data() + sizeof(raw_trace_header) + h.size, calls, n);
+			h.records += n;
+			h.last_timestamp = calls[n - 1].timestamp;
+			calls += n, count -= n;
+		}
+	}
+
+	bool trace_recorder::open_segment(unsigned int threadid, thread_trace &trace)
+	{
+		const wstring name = to_wstring(static_cast<unsigned long long>(threadid)) + L"-"
+			+ to_wstring(static_cast<unsigned long long>(trace.segment)) + L".trace";
+
+		trace.file.reset(new mapped_file(_directory & name, _segment_size));
+		trace.encoder.reset();
+		if (!trace.file->data())
+		{
+			// Retrying would only leave more empty segments behind - the thread is not recorded any further.
+			trace.file->truncate(0);
+			trace.file.reset();
+			trace.stopped = true;
+			return false;
+		}
+
+		raw_trace_header &h = header(*trace.file);
+
+		h.signature = raw_trace_signature;
+		h.threadid = threadid;
+		h.size = h.records = 0;
+		h.first_timestamp = h.last_timestamp = 0;
+
+		const raw_trace_index_entry entry = {	threadid, trace.segment, 0, 0, 0	};
+
+		trace.index_offset = write_index_entry(entry, -1);
+		return true;
+	}
+
+	void trace_recorder::close_segment(thread_trace &trace)
+	{
+		if (!trace.file.get())
+			return;
+
+		const raw_trace_header &h = header(*trace.file);
+		const raw_trace_index_entry entry = {
+			h.threadid, trace.segment, h.records, h.first_timestamp, h.last_timestamp
+		};
+
+		write_index_entry(entry, trace.index_offset);
+		trace.file->truncate(sizeof(raw_trace_header) + static_cast<size_t>(h.size));
+		trace.file.reset();
+		trace.index_offset = -1;
+		++trace.segment;
+	}
+
+	long trace_recorder::write_index_entry(const raw_trace_index_entry &entry, long offset)
+	{
+		FILE *index = _index.get();
+
+		if (!index || fseek(index, offset < 0 ? 0 : offset, offset < 0 ? SEEK_END : SEEK_SET))
+			return -1;
+		offset = ftell(index);
+		fwrite(&entry, sizeof(entry), 1, index);
+		fflush(index);
+		return offset;
+	}
+}
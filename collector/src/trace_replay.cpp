@@ -0,0 +1,155 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/trace_replay.h>
+
+#include <collector/analyzer.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <wpl/mt/thread.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		bool segment_less(const raw_trace_index_entry &lhs, const raw_trace_index_entry &rhs)
+		{	return lhs.threadid < rhs.threadid || (lhs.threadid == rhs.threadid && lhs.segment < rhs.segment);	}
+
+		struct out_of_range
+		{
+			out_of_range(timestamp_t begin_, timestamp_t end_)
+				: begin(begin_), end(end_)
+			{	}
+
+			bool operator ()(const call_record &record) const
+			{	return record.timestamp < begin || end <= record.timestamp;	}
+
+			timestamp_t begin, end;
+		};
+	}
+
+	struct trace_replay::worker_context
+	{
+		worker_context(timestamp_t profiler_latency)
+			: analyzer_(profiler_latency, true, true), failed(false)
+		{	}
+
+		vector<raw_trace_index_entry> segments;
+		timestamp_t begin, end;
+		analyzer analyzer_;
+		bool failed;
+	};
+
+
+	trace_replay::trace_replay(const segment_reader &reader, timestamp_t profiler_latency)
+		: _reader(reader), _profiler_latency(profiler_latency)
+	{	}
+
+	void trace_replay::add_segment(const raw_trace_index_entry &segment)
+	{	_segments.push_back(segment);	}
+
+	bool trace_replay::run(unsigned int workers, timestamp_t begin, timestamp_t end)
+	{
+		vector< shared_ptr<worker_context> > contexts;
+		map<unsigned int, size_t> thread_workers;
+		bool succeeded = true;
+
+		workers = max(workers, 1u);
+		sort(_segments.begin(), _segments.end(), &segment_less);
+		for (vector<raw_trace_index_entry>::const_iterator i = _segments.begin(); i != _segments.end(); ++i)
+		{
+			if (!i->records || i->last_timestamp < begin || end <= i->first_timestamp)
+				continue;
+
+			const size_t next_worker = thread_workers.size() % workers;
+			const size_t worker = thread_workers.insert(make_pair(i->threadid, next_worker)).first->second;
+
+			if (contexts.size() <= worker)
+			{
+				contexts.push_back(shared_ptr<worker_context>(new worker_context(_profiler_latency)));
+				contexts.back()->begin = begin;
+				contexts.back()->end = end;
+			}
+			contexts[worker]->segments.push_back(*i);
+		}
+
+		{
+			vector< shared_ptr<wpl::mt::thread> > threads;
+
+			for (size_t i = 1; i < contexts.size(); ++i)
+			{
+				threads.push_back(shared_ptr<wpl::mt::thread>(new wpl::mt::thread(bind(&trace_replay::replay, this,
+					contexts[i].get()))));
+			}
+			if (!contexts.empty())
+				replay(contexts[0].get());
+			for (size_t i = 0; i != threads.size(); ++i)
+				threads[i]->join();
+		}
+
+		for (size_t i = 0; i != contexts.size(); ++i)
+		{
+			_accumulator.switch_source();
+			_accumulator.accumulate(contexts[i]->analyzer_);
+			succeeded = succeeded && !contexts[i]->failed;
+		}
+		return succeeded;
+	}
+
+	const statistics_accumulator &trace_replay::result() const throw()
+	{	return _accumulator;	}
+
+	void trace_replay::replay(worker_context *context) const
+	{
+		vector<byte> buffer;
+		vector<call_record> calls;
+		raw_trace_decoder decoder;
+
+		for (vector<raw_trace_index_entry>::const_iterator i = context->segments.begin();
+			i != context->segments.end(); ++i)
+		{
+			const raw_trace_header *header = 0;
+
+			buffer.clear();
+			calls.clear();
+			decoder.reset();
+			if (_reader(*i, buffer) && buffer.size() >= sizeof(raw_trace_header))
+				header = static_cast<const raw_trace_header *>(static_cast<const void *>(&buffer[0]));
+			if (!header || header->signature != raw_trace_signature
+				|| header->size > buffer.size() - sizeof(raw_trace_header)
+				|| !decoder.decode(calls, &buffer[sizeof(raw_trace_header)], static_cast<size_t>(header->size)))
+			{
+				context->failed = true;
+				continue;
+			}
+
+			vector<call_record>::iterator begin = calls.begin(), end = calls.end();
+
+			if (i->first_timestamp < context->begin || context->end <= i->last_timestamp)
+				end = remove_if(begin, end, out_of_range(context->begin, context->end));
+			if (begin != end)
+				context->analyzer_.accept_calls(i->threadid, &*begin, end - begin);
+		}
+	}
+}
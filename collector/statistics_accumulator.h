@@ -0,0 +1,80 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <common/call_paths.h>
+#include <common/primitives.h>
+#include <common/protocol.h>
+#include <common/statistics_file.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace micro_profiler
+{
+	class analyzer;
+
+	// Accumulates the results of analyzers (see analyzer.h): function statistics are summed up and call paths are
+	// re-interned into a trie of its own. The analyzer is expected to be cleared between the passes (as the
+	// statistics_bridge does after each update), so that each pass adds only the new data. Path ids of the analyzer
+	// are mapped incrementally, thus switch_source() must be called before accumulating another analyzer.
+	class statistics_accumulator
+	{
+	public:
+		void accumulate(const analyzer &source);
+		void switch_source() throw();
+		void reset();
+
+		// Remembers the modules loaded, so that the functions saved can be named after them. Modules are kept across
+		// reset().
+		void add_modules(const loaded_modules &modules);
+
+		const statistics_map_detailed_t<long_address_t> &statistics() const throw();
+		const call_paths &paths() const throw();
+
+		// Writes the accumulated data as a statistics file read by functions_list::load(). There are no symbols here:
+		// a function is named '<module file>+0x<offset>' after the closest module added below its address, or
+		// '0x<address>' if there is none. The profiler cannot symbolize such a file later.
+		template <typename ArchiveT>
+		void save(ArchiveT &archive, timestamp_t ticks_per_second) const;
+
+	private:
+		std::wstring address_name(long_address_t address) const;
+
+	private:
+		statistics_map_detailed_t<long_address_t> _statistics;
+		call_paths _paths;
+		std::vector<call_paths::path_id> _path_map;
+		std::map<long_address_t, std::wstring> _modules;
+	};
+
+
+
+	// statistics_accumulator - inline definitions
+	template <typename ArchiveT>
+	inline void statistics_accumulator::save(ArchiveT &archive, timestamp_t ticks_per_second) const
+	{
+		save_statistics_file(archive, ticks_per_second, _statistics, _paths,
+			std::bind(&statistics_accumulator::address_name, this, std::placeholders::_1));
+	}
+}
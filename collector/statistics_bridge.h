@@ -21,7 +21,12 @@
 #pragma once
 
 #include "analyzer.h"
+#include "pipelined_channel.h"
+#include "statistics_accumulator.h"
+#include "timeline.h"
+#include "trace_recorder.h"
 
+#include <common/address_dictionary.h>
 #include <common/pod_vector.h>
 #include <common/protocol.h>
 #include <common/types.h>
@@ -52,20 +57,35 @@ namespace micro_profiler
 	{
 	public:
 		statistics_bridge(calls_collector_i &collector, const std::function<channel_t ()> &factory,
-			const std::shared_ptr<image_load_queue> &image_load_queue);
+			const std::shared_ptr<image_load_queue> &image_load_queue, update_formats format = update_format_varint,
+			size_t compression_threshold = 0, bool pipelined = false, bool extended_analysis = false);
 
-		void analyze();
+		void set_timeline(const std::shared_ptr<timeline> &timeline_);
+		void set_trace_recorder(const std::shared_ptr<trace_recorder> &recorder);
+		void set_accumulator(const std::shared_ptr<statistics_accumulator> &accumulator);
+		bool analyze();
 		void update_frontend();
 
 	private:
 		template <typename DataT>
 		void send(commands command, const DataT &data);
+		void send_columnar();
+		void send_indexed();
+		void transmit();
 
 	public:
-		pod_vector<unsigned char> _buffer;
+		pod_vector<unsigned char> _buffer, _compressed_buffer;
 		analyzer _analyzer;
+		address_dictionary _dictionary;
+		registered_addresses _registered;
+		const update_formats _format;
+		const size_t _compression_threshold;
 		calls_collector_i &_collector;
 		channel_t _frontend;
 		std::shared_ptr<image_load_queue> _image_load_queue;
+		std::shared_ptr<timeline> _timeline;
+		std::shared_ptr<trace_recorder> _trace_recorder;
+		std::shared_ptr<statistics_accumulator> _accumulator;
+		std::auto_ptr<pipelined_channel> _pipeline;
 	};
 }
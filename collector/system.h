@@ -22,18 +22,28 @@
 
 #include "primitives.h"
 
+#include <string>
+
 namespace micro_profiler
 {
 	timestamp_t ticks_per_second();
 	unsigned int current_thread_id();
 
+	// Returns the value of the environment variable, or an empty string if it is not set.
+	std::wstring get_environment(const wchar_t *name);
+
+	// Milliseconds of a monotonic clock, wrapping around at 2^32. Unaffected by adjustments of the wall clock.
+	unsigned int monotonic_milliseconds();
+
 	class mutex
 	{
-		char _mtx_buffer[6 * sizeof(void*)];
+		void *_mtx_buffer[6];
 
 		mutex(const mutex &);
 		mutex &operator =(const mutex &);
 
+		friend class condition;
+
 	public:
 		mutex();
 		~mutex();
@@ -54,6 +64,26 @@ namespace micro_profiler
 		~scoped_lock() throw();
 	};
 
+#ifndef _WIN32
+	// A condition variable for the POSIX IPC transport. wait() must be called with the mutex entered - it is left
+	// while waiting and entered again before returning.
+	class condition
+	{
+		long long _cv_buffer[6];
+
+		condition(const condition &);
+		condition &operator =(const condition &);
+
+	public:
+		condition();
+		~condition();
+
+		void wait(mutex &mtx);
+		void notify_one();
+		void notify_all();
+	};
+#endif
+
 	
 	inline scoped_lock::scoped_lock(mutex &mtx) throw()
 		: _mutex(mtx)
@@ -0,0 +1,157 @@
+#include <collector/analysis_scheduler.h>
+
+#include <vector>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			const analysis_scheduler::intervals c_intervals = {	10, 500, 67	};
+		}
+
+		begin_test_suite( AnalysisSchedulerTests )
+			test( AnalysisIsDueAfterTheShortestIntervalInitially )
+			{
+				// INIT / ACT
+				analysis_scheduler s(c_intervals, 1000);
+
+				// ACT / ASSERT
+				assert_equal(10u, s.timeout(1000));
+				assert_equal(3u, s.timeout(1007));
+				assert_is_false(s.analysis_due(1009));
+				assert_is_true(s.analysis_due(1010));
+				assert_equal(0u, s.timeout(1011));
+				assert_is_false(s.update_due(1011));
+			}
+
+
+			test( IdleAnalysisBacksOffExponentiallyUpToTheIdleInterval )
+			{
+				// INIT
+				analysis_scheduler s(c_intervals, 0);
+				unsigned int reference[] = {	20, 40, 80, 160, 320, 500, 500,	};
+				vector<unsigned int> timeouts;
+
+				// ACT
+				for (unsigned int now = 10, i = 0; i != 7; ++i)
+				{
+					s.analyzed(now, false);
+					s.updated(now);
+					timeouts.push_back(s.timeout(now));
+					now += timeouts.back();
+				}
+
+				// ASSERT
+				assert_equal(reference, timeouts);
+			}
+
+
+			test( ReadingCallsRestoresTheShortestAnalysisInterval )
+			{
+				// INIT
+				analysis_scheduler s(c_intervals, 0);
+
+				s.analyzed(10, false);
+				s.analyzed(30, false);
+				s.analyzed(70, false);
+
+				// ACT
+				s.analyzed(150, true);
+				s.updated(150);
+
+				// ASSERT
+				assert_equal(10u, s.timeout(150));
+				assert_is_true(s.analysis_due(160));
+
+				// ACT
+				s.analyzed(160, false);
+
+				// ASSERT
+				assert_equal(20u, s.timeout(160));
+			}
+
+
+			test( UpdatesFollowTheUpdateIntervalOnlyWhileThereIsDataToSend )
+			{
+				// INIT
+				analysis_scheduler s(c_intervals, 0);
+
+				// ACT / ASSERT
+				assert_is_false(s.update_due(67));
+				assert_is_false(s.update_due(499));
+				assert_is_true(s.update_due(500));
+
+				// ACT
+				s.analyzed(10, true);
+
+				// ASSERT
+				assert_is_false(s.update_due(66));
+				assert_is_true(s.update_due(67));
+
+				// ACT
+				s.updated(70);
+				s.analyzed(70, false);
+
+				// ASSERT
+				assert_is_false(s.update_due(137));
+				assert_equal(20u, s.timeout(70));
+				assert_is_true(s.update_due(570));
+			}
+
+
+			test( TimeoutIsLimitedByTheNearestUpdate )
+			{
+				// INIT
+				analysis_scheduler s(c_intervals, 0);
+
+				s.analyzed(10, true);
+				for (unsigned int now = 20; now != 70; now += 10)
+					s.analyzed(now, false);	// Backed off to 320ms by now.
+
+				// ACT / ASSERT
+				assert_equal(7u, s.timeout(60));
+			}
+
+
+			test( ClockWrappingAroundIsHandled )
+			{
+				// INIT
+				analysis_scheduler s(c_intervals, 0xFFFFFFFA);
+
+				// ACT / ASSERT
+				assert_equal(5u, s.timeout(0xFFFFFFFF));
+				assert_is_false(s.analysis_due(3));
+				assert_is_true(s.analysis_due(4));
+				assert_equal(0u, s.timeout(4));
+			}
+
+
+			test( ZeroIntervalsAreClampedToAMillisecond )
+			{
+				// INIT
+				const analysis_scheduler::intervals zero = {	0, 0, 0	};
+				analysis_scheduler s(zero, 100);
+
+				// ACT / ASSERT
+				assert_equal(1u, s.timeout(100));
+				assert_is_false(s.analysis_due(100));
+				assert_is_true(s.analysis_due(101));
+
+				// ACT
+				s.analyzed(101, false);
+				s.updated(101);
+
+				// ASSERT
+				assert_equal(1u, s.timeout(101));
+				assert_is_false(s.update_due(101));
+				assert_is_true(s.update_due(102));
+			}
+		end_test_suite
+	}
+}
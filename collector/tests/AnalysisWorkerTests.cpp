@@ -0,0 +1,217 @@
+#include <collector/analysis_worker.h>
+
+#include <collector/system.h>
+#include <test-helpers/helpers.h>
+
+#include <string>
+#include <ut/assert.h>
+#include <ut/test.h>
+#include <wpl/mt/synchronization.h>
+#include <wpl/mt/thread.h>
+
+using namespace std;
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			struct worker_log
+			{
+				worker_log()
+					: analyzed(false, true), snapshotted(false, true), calls_read(false)
+				{	}
+
+				mutex mtx;
+				string sequence;
+				vector<unsigned int> analysis_times;
+				event_flag analyzed, snapshotted;
+				bool calls_read;
+			};
+
+			bool log_analysis(worker_log *log)
+			{
+				{
+					scoped_lock l(log->mtx);
+
+					log->sequence += 'a';
+					log->analysis_times.push_back(monotonic_milliseconds());
+				}
+				log->analyzed.raise();
+				return log->calls_read;
+			}
+
+			void log_update(worker_log *log)
+			{
+				scoped_lock l(log->mtx);
+
+				log->sequence += 'u';
+			}
+
+			void log_snapshot(worker_log *log)
+			{
+				{
+					scoped_lock l(log->mtx);
+
+					log->sequence += 's';
+				}
+				log->snapshotted.raise();
+			}
+
+			void run_worker(analysis_worker *worker, worker_log *log)
+			{	worker->run(bind(&log_analysis, log), bind(&log_update, log));	}
+
+			void run_worker_with_snapshots(analysis_worker *worker, worker_log *log)
+			{	worker->run(bind(&log_analysis, log), bind(&log_update, log), bind(&log_snapshot, log));	}
+
+			const analysis_scheduler::intervals c_long_intervals = {	10000, 10000, 10000	};
+		}
+
+		begin_test_suite( AnalysisWorkerTests )
+			test( WorkerStoppedBeforeRunAnalyzesAndUpdatesOnceAndReturns )
+			{
+				// INIT
+				event_flag wakeup(false, true);
+				analysis_worker w(wakeup, c_long_intervals);
+				worker_log log;
+
+				w.stop();
+
+				// ACT
+				run_worker(&w, &log);
+
+				// ASSERT
+				assert_equal("au", log.sequence);
+			}
+
+
+			test( RaisingWakeupAnalyzesTracesImmediately )
+			{
+				// INIT
+				event_flag wakeup(false, true);
+				analysis_worker w(wakeup, c_long_intervals);
+				worker_log log;
+				thread t(bind(&run_worker, &w, &log));
+
+				// ACT
+				wakeup.raise();
+
+				// ASSERT
+				assert_equal(waitable::satisfied, log.analyzed.wait(5000));
+
+				// ACT
+				wakeup.raise();
+
+				// ASSERT
+				assert_equal(waitable::satisfied, log.analyzed.wait(5000));
+
+				// ACT
+				w.stop();
+				t.join();
+
+				// ASSERT
+				assert_equal("aaau", log.sequence);
+			}
+
+
+			test( StoppingARunningWorkerDrainsTracesToTheFrontend )
+			{
+				// INIT
+				const analysis_scheduler::intervals intervals = {	1, 1, 1	};
+				event_flag wakeup(false, true);
+				analysis_worker w(wakeup, intervals);
+				worker_log log;
+
+				log.calls_read = true;
+
+				thread t(bind(&run_worker, &w, &log));
+
+				log.analyzed.wait();
+				log.analyzed.wait();
+
+				// ACT
+				w.stop();
+				t.join();
+
+				// ASSERT
+				const size_t n = log.sequence.size();
+
+				assert_is_true(n >= 4);
+				assert_equal("au", log.sequence.substr(n - 2));
+
+				// ACT (stopping again is harmless)
+				w.stop();
+			}
+
+
+			test( AnalysisIsScheduledAtTheAnalysisIntervalWithBoundedJitter )
+			{
+				// INIT
+				const unsigned int period = 20;
+				const analysis_scheduler::intervals intervals = {	period, period, 1000	};
+				event_flag wakeup(false, true);
+				analysis_worker w(wakeup, intervals);
+				worker_log log;
+
+				log.calls_read = true;
+
+				// ACT
+				thread t(bind(&run_worker, &w, &log));
+
+				for (int i = 0; i != 21; ++i)
+					log.analyzed.wait();
+				w.stop();
+				t.join();
+
+				// ASSERT
+				unsigned int max_lag = 0, total = 0;
+
+				for (size_t i = 1; i != 21; ++i)
+				{
+					const unsigned int gap = log.analysis_times[i] - log.analysis_times[i - 1];
+
+					assert_is_true(gap >= period - 1);	// Clocks of different resolutions may round the gap down.
+					const unsigned int lag = gap > period ? gap - period : 0;
+
+					max_lag = lag > max_lag ? lag : max_lag;
+					total += gap;
+				}
+
+				// Timer resolution of the OS allows a wakeup to come late, but it must never accumulate or stall.
+				assert_is_true(max_lag < 10 * period);
+				assert_is_true(total < 20 * 2 * period);
+			}
+
+
+			test( RequestedSnapshotIsTakenImmediatelyAfterAnalysisAndUpdate )
+			{
+				// INIT
+				event_flag wakeup(false, true);
+				analysis_worker w(wakeup, c_long_intervals);
+				worker_log log;
+				thread t(bind(&run_worker_with_snapshots, &w, &log));
+
+				// ACT
+				w.request_snapshot();
+
+				// ASSERT
+				assert_equal(waitable::satisfied, log.snapshotted.wait(5000));
+
+				// ACT
+				w.request_snapshot();
+
+				// ASSERT
+				assert_equal(waitable::satisfied, log.snapshotted.wait(5000));
+
+				// ACT
+				w.stop();
+				t.join();
+
+				// ASSERT
+				assert_equal("ausausau", log.sequence);
+			}
+		end_test_suite
+	}
+}
@@ -171,6 +171,41 @@ namespace micro_profiler
 			}
 
 
+			test( LatenciesAreCollectedOnlyWhenRequested )
+			{
+				// INIT
+				analyzer a1, a2(0, true);
+				call_record trace[] = {
+					{	12300, (void *)1234	},
+					{	12305, (void *)0	},
+					{	12310, (void *)2234	},
+					{	12317, (void *)0	},
+					{	12320, (void *)2234	},
+					{	12322, (void *)12234	},
+					{	12325, (void *)0	},
+					{	12327, (void *)0	},
+				};
+
+				// ACT
+				a1.accept_calls(1, trace, array_size(trace));
+				a2.accept_calls(1, trace, array_size(trace));
+
+				// ASSERT
+				map<const void *, function_statistics_detailed> m1(a1.begin(), a1.end()), m2(a2.begin(), a2.end());
+
+				assert_equal(0u, m1[(void *)1234].latencies.total());
+				assert_equal(0u, m1[(void *)2234].latencies.total());
+
+				assert_equal(1u, m2[(void *)1234].latencies.total());
+				assert_equal(5, m2[(void *)1234].latencies.percentile(1));
+				assert_equal(2u, m2[(void *)2234].latencies.total());
+				assert_equal(7, m2[(void *)2234].latencies.percentile(0.5));
+				assert_equal(7, m2[(void *)2234].latencies.percentile(1));
+				assert_equal(1u, m2[(void *)12234].latencies.total());
+				assert_equal(3, m2[(void *)12234].latencies.percentile(1));
+			}
+
+
 			test( DifferentShadowStacksAreMaintainedForEachThread )
 			{
 				// INIT
@@ -11,6 +11,7 @@
 #include <ut/test.h>
 
 using wpl::mt::thread;
+using wpl::mt::waitable;
 using namespace std;
 
 namespace micro_profiler
@@ -217,6 +218,43 @@ namespace micro_profiler
 			}
 
 
+			test( ReaderIsWokenUpWhenTraceFillsToItsHighWatermark )
+			{
+				// INIT
+				calls_collector c(100);
+				collection_acceptor a;
+
+				c.reader_wakeup().wait(0);
+
+				// ACT
+				emulate_n_calls(c, 24);
+
+				// ASSERT
+				assert_equal(waitable::timeout, c.reader_wakeup().wait(0));
+
+				// ACT
+				emulate_n_calls(c, 1);
+
+				// ASSERT
+				assert_equal(waitable::satisfied, c.reader_wakeup().wait(0));
+
+				// ACT
+				emulate_n_calls(c, 5);
+
+				// ASSERT
+				assert_equal(waitable::timeout, c.reader_wakeup().wait(0));
+
+				// INIT
+				c.read_collected(a);
+
+				// ACT
+				emulate_n_calls(c, 25);
+
+				// ASSERT
+				assert_equal(waitable::satisfied, c.reader_wakeup().wait(0));
+			}
+
+
 			test( ReplyMaxTraceLength )
 			{
 				// INIT
@@ -2,6 +2,8 @@
 
 #include <test-helpers/helpers.h>
 
+#include <common/columnar.h>
+#include <common/compression.h>
 #include <common/serialization.h>
 
 #include <stdexcept>
@@ -34,6 +36,12 @@ namespace micro_profiler
 						_remaining -= size;
 					}
 
+					const unsigned char *ptr() const
+					{	return _ptr;	}
+
+					size_t remaining() const
+					{	return _remaining;	}
+
 				private:
 					const unsigned char *_ptr;
 					size_t _remaining;
@@ -76,9 +84,11 @@ namespace micro_profiler
 			{	return Frontend(state);	}
 
 			template <typename ArchiveT>
-			void serialize(ArchiveT &a, FrontendState &state)
+			void receive(ArchiveT &a, const buffer_reader &reader, FrontendState &state)
 			{
 				commands c;
+				unsigned int uncompressed_size;
+				vector<byte> uncompressed;
 
 				a(c);
 				state.update_log.push_back(FrontendState::ReceivedEntry());
@@ -98,7 +108,23 @@ namespace micro_profiler
 					break;
 
 				case update_statistics:
-					a(e.update);
+					if (state.process_init.statistics_format == update_format_columnar)
+					{
+						columnar_update u;
+
+						assert_is_true(u.parse(reader.ptr(), reader.remaining()));
+						merge_columnar(e.update, 0, u);
+					}
+					else if (state.process_init.statistics_format == update_format_indexed)
+					{
+						function_statistics_detailed::callees_map delta;
+						indexed_update_t<unsigned int> u = {	e.update, delta, state.addresses	};
+
+						state.addresses.reset_entries();
+						a(u);
+					}
+					else
+						a(e.update);
 					state.updated.raise();
 					state.update_lock.wait();
 					break;
@@ -106,6 +132,30 @@ namespace micro_profiler
 				case modules_unloaded:
 					a(e.image_unloads);
 					state.modules_state_updated.raise();
+					break;
+
+				case register_addresses:
+					state.update_log.pop_back();
+					a(state.addresses);
+					break;
+
+				case update_call_paths:
+					state.update_log.pop_back();
+					a(state.paths);
+					break;
+
+				case compressed:
+					state.update_log.pop_back();
+					++state.compressed_messages;
+					a(uncompressed_size);
+					assert_is_true(uncompressed_size <= c_max_uncompressed_size);
+					uncompressed.resize(uncompressed_size);
+					assert_is_true(decompress(&uncompressed[0], uncompressed_size, reader.ptr(), reader.remaining()));
+
+					buffer_reader inner_reader(&uncompressed[0], uncompressed_size);
+					strmd::deserializer<buffer_reader, packer> inner_archive(inner_reader);
+
+					receive(inner_archive, inner_reader, state);
 				}
 			}
 
@@ -114,19 +164,19 @@ namespace micro_profiler
 				buffer_reader reader(message, size);
 				strmd::deserializer<buffer_reader, packer> a(reader);
 
-				a(_state);
+				receive(a, reader, _state);
 				return true;
 			}
 
 
 			FrontendState::FrontendState(const function<void()>& oninitialized_)
 				: update_lock(true, false), oninitialized(oninitialized_), updated(false, true),
-					modules_state_updated(false, true), ref_count(0)
+					modules_state_updated(false, true), ref_count(0), compressed_messages(0)
 			{	}
 
 
 			Tracer::Tracer(timestamp_t latency)
-				: _latency(latency)
+				: _latency(latency), _reader_wakeup(false, true)
 			{	}
 
 			void Tracer::read_collected(acceptor &a)
@@ -142,6 +192,9 @@ namespace micro_profiler
 
 			timestamp_t Tracer::profiler_latency() const throw()
 			{	return _latency;	}
+
+			wpl::mt::event_flag &Tracer::reader_wakeup() throw()
+			{	return _reader_wakeup;	}
 		}
 	}
 }
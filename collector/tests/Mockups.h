@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/address_dictionary.h>
+#include <common/call_paths.h>
 #include <common/protocol.h>
 #include <common/types.h>
 #include <collector/calls_collector.h>
@@ -31,10 +33,13 @@ namespace micro_profiler
 				initialization_data process_init;
 
 				std::vector<ReceivedEntry> update_log;
+				address_index<unsigned int> addresses;
+				call_paths paths;
 				wpl::mt::event_flag updated;
 				wpl::mt::event_flag modules_state_updated;
 
 				size_t ref_count;
+				size_t compressed_messages;
 			};
 			
 
@@ -56,12 +61,14 @@ namespace micro_profiler
 
 				virtual void read_collected(acceptor &a);
 				virtual timestamp_t profiler_latency() const throw();
+				virtual wpl::mt::event_flag &reader_wakeup() throw();
 
 			private:
 				typedef std::unordered_map< wpl::mt::thread::id, std::vector<call_record> > TracesMap;
 
 				timestamp_t _latency;
 				TracesMap _traces;
+				wpl::mt::event_flag _reader_wakeup;
 				mutex _mutex;
 			};
 
@@ -70,8 +77,11 @@ namespace micro_profiler
 			template <size_t size>
 			inline void Tracer::Add(wpl::mt::thread::id threadid, call_record (&trace_chunk)[size])
 			{
-				scoped_lock l(_mutex);
-				_traces[threadid].insert(_traces[threadid].end(), trace_chunk, trace_chunk + size);
+				{
+					scoped_lock l(_mutex);
+					_traces[threadid].insert(_traces[threadid].end(), trace_chunk, trace_chunk + size);
+				}
+				_reader_wakeup.raise();	// Each chunk added is treated as a trace filled past its watermark.
 			}
 		}
 	}
@@ -0,0 +1,181 @@
+#include <collector/pipelined_channel.h>
+
+#include <test-helpers/helpers.h>
+
+#include <string>
+#include <string.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+#include <wpl/mt/thread.h>
+
+using namespace std;
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			struct channel_log
+			{
+				channel_log()
+					: proceed(true, false)
+				{	}
+
+				event_flag proceed;
+				vector<string> messages;
+				vector<thread::id> threads;
+				vector<thread::id> factory_threads;
+			};
+
+			bool log_message(channel_log *log, const void *data, size_t size)
+			{
+				log->proceed.wait();
+				log->messages.push_back(string(static_cast<const char *>(data), size));
+				log->threads.push_back(this_thread::open()->get_id());
+				return true;
+			}
+
+			channel_t open_channel(channel_log *log)
+			{
+				log->factory_threads.push_back(this_thread::open()->get_id());
+				return bind(&log_message, log, placeholders::_1, placeholders::_2);
+			}
+
+			frontend_factory make_factory(channel_log &log)
+			{	return bind(&open_channel, &log);	}
+
+			void post(pipelined_channel &c, const char *message)
+			{	c(message, strlen(message));	}
+
+			void post_all(pipelined_channel *c, const char *message, int times, event_flag *done)
+			{
+				while (times--)
+					post(*c, message);
+				done->raise();
+			}
+		}
+
+		begin_test_suite( PipelinedChannelTests )
+			test( MessagesArePassedInOrderAndAllDeliveredOnDestruction )
+			{
+				// INIT
+				channel_log log;
+
+				// INIT / ACT
+				{
+					pipelined_channel c(make_factory(log), 1000000);
+
+					post(c, "lorem");
+					post(c, "");
+					post(c, "ipsum dolor");
+					post(c, "amet");
+				}
+
+				// ASSERT
+				string reference[] = {	"lorem", "", "ipsum dolor", "amet",	};
+
+				assert_equal(reference, log.messages);
+			}
+
+
+			test( MessagesAreTransmittedOnASeparateThread )
+			{
+				// INIT
+				channel_log log;
+
+				// INIT / ACT
+				{
+					pipelined_channel c(make_factory(log), 1000000);
+
+					post(c, "lorem");
+					post(c, "ipsum");
+				}
+
+				// ASSERT
+				assert_equal(2u, log.threads.size());
+				assert_not_equal(this_thread::open()->get_id(), log.threads[0]);
+				assert_equal(log.threads[0], log.threads[1]);
+			}
+
+
+			test( UnderlyingChannelIsOpenedOnTheTransmittingThread )
+			{
+				// INIT
+				channel_log log;
+
+				// INIT / ACT
+				{
+					pipelined_channel c(make_factory(log), 1000000);
+
+					post(c, "lorem");
+				}
+
+				// ASSERT
+				assert_equal(1u, log.factory_threads.size());
+				assert_equal(1u, log.threads.size());
+				assert_equal(log.threads[0], log.factory_threads[0]);
+			}
+
+
+			test( PostingDoesNotWaitForTransmission )
+			{
+				// INIT
+				channel_log log;
+
+				log.proceed.lower();
+
+				// INIT / ACT
+				{
+					pipelined_channel c(make_factory(log), 1000000);
+
+					// ACT (must not block)
+					for (int i = 0; i != 1000; ++i)
+						post(c, i % 2 ? "odd" : "even");
+
+					// ASSERT
+					assert_is_empty(log.messages);
+
+					// ACT
+					log.proceed.raise();
+				}
+
+				// ASSERT
+				assert_equal(1000u, log.messages.size());
+				assert_equal("even", log.messages[0]);
+				assert_equal("odd", log.messages[999]);
+			}
+
+
+			test( PostingBlocksWhileQueuedBytesExceedTheLimit )
+			{
+				// INIT
+				channel_log log;
+				event_flag done(false, false);
+
+				log.proceed.lower();
+
+				// INIT / ACT
+				{
+					pipelined_channel c(make_factory(log), 5);
+					thread poster(bind(&post_all, &c, "lorem", 3, &done));
+
+					// ASSERT
+					assert_equal(waitable::timeout, done.wait(200));
+
+					// ACT
+					log.proceed.raise();
+
+					// ASSERT
+					assert_equal(waitable::satisfied, done.wait(5000));
+
+					poster.join();
+				}
+
+				// ASSERT
+				assert_equal(3u, log.messages.size());
+			}
+		end_test_suite
+	}
+}
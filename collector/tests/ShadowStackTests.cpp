@@ -31,6 +31,22 @@ namespace micro_profiler
 				virtual void add_call(unsigned int level, timestamp_t inclusive_time_, timestamp_t exclusive_time_)
 				{	function_statistics::add_call(level, inclusive_time_, exclusive_time_);	}
 			};
+
+			struct call_record_sp : call_record
+			{
+				call_record_sp(timestamp_t timestamp_, const void *callee_, const void *stack_ptr_)
+					: stack_ptr(stack_ptr_)
+				{
+					timestamp = timestamp_;
+					callee = callee_;
+				}
+
+				const void *stack_ptr;
+			};
+
+			// Lets the resync logic be covered whether or not call_record carries stack pointers itself.
+			const void *stack_pointer(const call_record_sp &record)
+			{	return record.stack_ptr;	}
 		}
 
 		begin_test_suite( ShadowStackTests )
@@ -912,6 +928,120 @@ namespace micro_profiler
 				assert_equal(1u, statistics[(void *)0x11].times_called);
 				assert_equal(0u, statistics[(void *)0x11].max_reentrance);
 			}
+
+
+			test( ExclusiveTimeIsAccumulatedPerCallPath )
+			{
+				// INIT
+				call_paths paths;
+				shadow_stack< unordered_map<const void *, function_statistics> > ss(0, false, &paths);
+				unordered_map<const void *, function_statistics> statistics;
+				call_record trace1[] = {
+					{	1, (void *)0x1	},
+						{	2, (void *)0x2	},
+							{	3, (void *)0x2	},
+							{	7, (void *)0	},
+						{	10, (void *)0	},
+						{	11, (void *)0x3	},
+				};
+				call_record trace2[] = {
+							{	12, (void *)0x2	},
+							{	17, (void *)0	},
+						{	20, (void *)0	},
+						{	22, (void *)0x2	},
+						{	25, (void *)0	},
+					{	30, (void *)0	},
+				};
+
+				// ACT
+				ss.update(trace1, array_end(trace1), statistics);
+				statistics.clear();
+				ss.update(trace2, array_end(trace2), statistics);
+
+				// ASSERT
+				assert_equal(6u, paths.size());
+				assert_equal(0u, paths[1].parent);
+				assert_equal(0x1u, paths[1].function);
+				assert_equal(9, paths[1].exclusive_time);
+				assert_equal(1u, paths[2].parent);
+				assert_equal(0x2u, paths[2].function);
+				assert_equal(4 + 3, paths[2].exclusive_time);
+				assert_equal(2u, paths[3].parent);
+				assert_equal(0x2u, paths[3].function);
+				assert_equal(4, paths[3].exclusive_time);
+				assert_equal(1u, paths[4].parent);
+				assert_equal(0x3u, paths[4].function);
+				assert_equal(4, paths[4].exclusive_time);
+				assert_equal(4u, paths[5].parent);
+				assert_equal(0x2u, paths[5].function);
+				assert_equal(5, paths[5].exclusive_time);
+			}
+
+			test( FramesSkippedByUnwindingArePoppedOnEnteringAtTheSameStackLevel )
+			{
+				// INIT
+				shadow_stack< map<const void *, function_statistics> > ss;
+				map<const void *, function_statistics> statistics;
+				call_record_sp trace[] = {
+					call_record_sp(100, (void *)0x1, (void *)0x1000),
+						call_record_sp(110, (void *)0x2, (void *)0x0F00),
+							call_record_sp(115, (void *)0x3, (void *)0x0E00),
+						call_record_sp(130, (void *)0x4, (void *)0x0F00),
+						call_record_sp(135, (void *)0, (void *)0x0F00),
+					call_record_sp(140, (void *)0, (void *)0x1000),
+				};
+
+				// ACT
+				ss.update(trace, array_end(trace), statistics);
+
+				// ASSERT
+				assert_equal(4u, statistics.size());
+				assert_equal(1u, statistics[(void *)0x1].times_called);
+				assert_equal(40, statistics[(void *)0x1].inclusive_time);
+				assert_equal(15, statistics[(void *)0x1].exclusive_time);
+				assert_equal(1u, statistics[(void *)0x2].times_called);
+				assert_equal(20, statistics[(void *)0x2].inclusive_time);
+				assert_equal(5, statistics[(void *)0x2].exclusive_time);
+				assert_equal(1u, statistics[(void *)0x3].times_called);
+				assert_equal(15, statistics[(void *)0x3].inclusive_time);
+				assert_equal(15, statistics[(void *)0x3].exclusive_time);
+				assert_equal(1u, statistics[(void *)0x4].times_called);
+				assert_equal(5, statistics[(void *)0x4].inclusive_time);
+				assert_equal(5, statistics[(void *)0x4].exclusive_time);
+			}
+
+
+			test( FramesSkippedByUnwindingArePoppedOnExitingAnOuterFrame )
+			{
+				// INIT
+				shadow_stack< map<const void *, function_statistics> > ss;
+				map<const void *, function_statistics> statistics;
+				call_record_sp trace1[] = {
+					call_record_sp(100, (void *)0x1, (void *)0x1000),
+						call_record_sp(110, (void *)0x2, (void *)0x0F00),
+							call_record_sp(113, (void *)0x3, (void *)0x0E00),
+				};
+				call_record_sp trace2[] = {
+					call_record_sp(120, (void *)0, (void *)0x1000),
+					call_record_sp(125, (void *)0, (void *)0x1100),
+				};
+
+				// ACT
+				ss.update(trace1, array_end(trace1), statistics);
+				ss.update(trace2, array_end(trace2), statistics);
+
+				// ASSERT
+				assert_equal(3u, statistics.size());
+				assert_equal(1u, statistics[(void *)0x1].times_called);
+				assert_equal(20, statistics[(void *)0x1].inclusive_time);
+				assert_equal(10, statistics[(void *)0x1].exclusive_time);
+				assert_equal(1u, statistics[(void *)0x2].times_called);
+				assert_equal(10, statistics[(void *)0x2].inclusive_time);
+				assert_equal(3, statistics[(void *)0x2].exclusive_time);
+				assert_equal(1u, statistics[(void *)0x3].times_called);
+				assert_equal(7, statistics[(void *)0x3].inclusive_time);
+				assert_equal(7, statistics[(void *)0x3].exclusive_time);
+			}
 		end_test_suite
 	}
 }
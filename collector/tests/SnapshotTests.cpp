@@ -0,0 +1,97 @@
+#include <collector/snapshot.h>
+
+#include <test-helpers/helpers.h>
+
+#include <string>
+#include <ut/assert.h>
+#include <ut/test.h>
+#include <wpl/mt/synchronization.h>
+#include <wpl/mt/thread.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <signal.h>
+#endif
+
+using namespace std;
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			struct trigger_log
+			{
+				trigger_log()
+					: triggered(false, true), count(0)
+				{	}
+
+				event_flag triggered;
+				thread::id thread_id;
+				int count;
+			};
+
+			void log_trigger(trigger_log *log)
+			{
+				log->thread_id = this_thread::open()->get_id();
+				++log->count;
+				log->triggered.raise();
+			}
+
+			void request_snapshot()
+			{
+#ifdef _WIN32
+				const wstring name = L"Local\\micro-profiler-snapshot-"
+					+ to_wstring(static_cast<unsigned long long>(::GetCurrentProcessId()));
+				HANDLE event = ::OpenEventW(EVENT_MODIFY_STATE, FALSE, name.c_str());
+
+				::SetEvent(event);
+				::CloseHandle(event);
+#else
+				raise(SIGUSR2);
+#endif
+			}
+		}
+
+		begin_test_suite( SnapshotTests )
+			test( RequestingASnapshotCallsTheHandlerOnTheTriggerThread )
+			{
+				// INIT
+				trigger_log log;
+				snapshot_trigger t(0, bind(&log_trigger, &log));
+
+				// ACT
+				request_snapshot();
+
+				// ASSERT
+				assert_equal(waitable::satisfied, log.triggered.wait(5000));
+				assert_not_equal(this_thread::open()->get_id(), log.thread_id);
+
+				// ACT
+				request_snapshot();
+
+				// ASSERT
+				assert_equal(waitable::satisfied, log.triggered.wait(5000));
+				assert_equal(2, log.count);
+			}
+
+
+			test( HandlerIsNotCalledWithoutRequests )
+			{
+				// INIT
+				trigger_log log;
+
+				// INIT / ACT
+				{
+					snapshot_trigger t(0, bind(&log_trigger, &log));
+				}
+
+				// ASSERT
+				assert_equal(0, log.count);
+			}
+		end_test_suite
+	}
+}
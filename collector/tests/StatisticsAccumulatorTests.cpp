@@ -0,0 +1,266 @@
+#include <collector/statistics_accumulator.h>
+
+#include <collector/analyzer.h>
+#include <common/serialization.h>
+#include "StatisticsFile.h"
+
+#include <test-helpers/helpers.h>
+
+#include <strmd/deserializer.h>
+#include <strmd/serializer.h>
+#include <unordered_map>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			void accept(analyzer &a, unsigned int threadid, timestamp_t shift)
+			{
+				call_record trace[] = {
+					{	shift + 1000, (void *)0x1000	},
+						{	shift + 1010, (void *)0x2000	},
+						{	shift + 1030, 0	},
+					{	shift + 1100, 0	},
+				};
+
+				a.accept_calls(threadid, trace, array_size(trace));
+			}
+		}
+
+		begin_test_suite( StatisticsAccumulatorTests )
+			test( StatisticsOfConsecutivePassesAreSummedUp )
+			{
+				// INIT
+				analyzer a(0, true, true);
+				statistics_accumulator accumulator;
+
+				accept(a, 1, 0);
+
+				// ACT
+				accumulator.accumulate(a);
+
+				// ASSERT
+				assert_equal(2u, accumulator.statistics().size());
+				assert_equal(1u, accumulator.statistics().find(0x1000)->second.times_called);
+				assert_equal(100, accumulator.statistics().find(0x1000)->second.inclusive_time);
+
+				// INIT
+				a.clear();
+				accept(a, 1, 1000);
+				accept(a, 2, 1000);
+
+				// ACT
+				accumulator.accumulate(a);
+
+				// ASSERT
+				const function_statistics_detailed_t<long_address_t> &f = accumulator.statistics().find(0x1000)->second;
+
+				assert_equal(2u, accumulator.statistics().size());
+				assert_equal(3u, f.times_called);
+				assert_equal(300, f.inclusive_time);
+				assert_equal(240, f.exclusive_time);
+				assert_equal(3u, f.callees.find(0x2000)->second.times_called);
+				assert_equal(3u, accumulator.statistics().find(0x2000)->second.times_called);
+			}
+
+
+			test( CallPathTimesOfConsecutivePassesAreSummedUp )
+			{
+				// INIT
+				analyzer a(0, true, true);
+				statistics_accumulator accumulator;
+
+				accept(a, 1, 0);
+				accumulator.accumulate(a);
+				a.clear();
+				accept(a, 1, 1000);
+
+				// ACT
+				accumulator.accumulate(a);
+
+				// ASSERT
+				const call_paths &paths = accumulator.paths();
+
+				assert_equal(3u, paths.size());
+				assert_equal(0x1000u, paths[1].function);
+				assert_equal(160, paths[1].exclusive_time);
+				assert_equal(1u, paths[2].parent);
+				assert_equal(0x2000u, paths[2].function);
+				assert_equal(40, paths[2].exclusive_time);
+			}
+
+
+			test( PathsOfDifferentSourcesAreMergedAfterSwitching )
+			{
+				// INIT
+				analyzer a1(0, true, true), a2(0, true, true);
+				call_record trace[] = {
+					{	1000, (void *)0x2000	},
+						{	1010, (void *)0x1000	},
+						{	1030, 0	},
+					{	1100, 0	},
+				};
+				statistics_accumulator accumulator;
+
+				a2.accept_calls(1, trace, array_size(trace));
+				accept(a1, 1, 0);
+				accept(a2, 1, 1000);
+
+				// ACT
+				accumulator.accumulate(a1);
+				accumulator.switch_source();
+				accumulator.accumulate(a2);
+
+				// ASSERT
+				const call_paths &paths = accumulator.paths();
+
+				assert_equal(5u, paths.size());
+				assert_equal(160, paths[1].exclusive_time);
+				assert_equal(40, paths[2].exclusive_time);
+				assert_equal(0x2000u, paths[3].function);
+				assert_equal(80, paths[3].exclusive_time);
+				assert_equal(3u, paths[4].parent);
+				assert_equal(20, paths[4].exclusive_time);
+			}
+
+
+			test( ResetDropsEverythingAccumulated )
+			{
+				// INIT
+				analyzer a(0, true, true);
+				statistics_accumulator accumulator;
+
+				accept(a, 1, 0);
+				accumulator.accumulate(a);
+				a.clear();
+
+				// ACT
+				accumulator.reset();
+
+				// ASSERT
+				assert_is_empty(accumulator.statistics());
+				assert_equal(1u, accumulator.paths().size());
+
+				// INIT
+				accept(a, 1, 1000);
+
+				// ACT
+				accumulator.accumulate(a);
+
+				// ASSERT
+				assert_equal(1u, accumulator.statistics().find(0x1000)->second.times_called);
+				assert_equal(3u, accumulator.paths().size());
+				assert_equal(80, accumulator.paths()[1].exclusive_time);
+				assert_equal(20, accumulator.paths()[2].exclusive_time);
+			}
+
+
+			test( SavedDataIsReadInTheStatisticsFileLayout )
+			{
+				// INIT
+				analyzer a(0, true, true);
+				statistics_accumulator accumulator;
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> ser(buffer);
+				strmd::deserializer<vector_adapter, packer> dser(buffer);
+				timestamp_t ticks_per_second;
+				unsigned int version;
+				unordered_map<long_address_t, wstring> symbols;
+				statistics_map_detailed_t<long_address_t> statistics;
+				call_paths paths;
+
+				accept(a, 1, 0);
+				accumulator.accumulate(a);
+
+				// ACT
+				accumulator.save(ser, 1000000);
+
+				// ASSERT
+				dser(ticks_per_second);
+				dser(version);
+
+				assert_equal(0, ticks_per_second);
+				assert_equal(c_statistics_file_version, version);
+
+				dser(ticks_per_second);
+				dser(symbols);
+				dser(statistics);
+				dser(paths);
+
+				assert_equal(1000000, ticks_per_second);
+				assert_equal(2u, symbols.size());
+				assert_equal(L"0x1000", symbols[0x1000]);
+				assert_equal(L"0x2000", symbols[0x2000]);
+				assert_equal(2u, statistics.size());
+				assert_equal(accumulator.statistics().find(0x1000)->second, statistics[0x1000]);
+				assert_equal(3u, paths.size());
+				assert_equal(80, paths[1].exclusive_time);
+			}
+
+
+			test( FunctionsAreNamedByTheClosestModuleBelowThem )
+			{
+				// INIT
+				analyzer a(0, true, true);
+				statistics_accumulator accumulator;
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> ser(buffer);
+				strmd::deserializer<vector_adapter, packer> dser(buffer);
+				module_info modules[] = {	{	0x0800, L"c:\\dev\\lorem.dll"	}, {	0x1800, L"/usr/lib/libipsum.so"	},	};
+				timestamp_t ticks_per_second;
+				unsigned int version;
+				unordered_map<long_address_t, wstring> symbols;
+
+				accept(a, 1, 0);
+				accumulator.accumulate(a);
+
+				// ACT
+				accumulator.add_modules(mkvector(modules));
+				accumulator.reset();
+				accumulator.accumulate(a);
+				accumulator.save(ser, 1000000);
+
+				// ASSERT
+				dser(ticks_per_second);
+				dser(version);
+				dser(ticks_per_second);
+				dser(symbols);
+
+				assert_equal(L"lorem.dll+0x800", symbols[0x1000]);
+				assert_equal(L"libipsum.so+0x800", symbols[0x2000]);
+			}
+
+
+			test( SavedDataIsLoadedByTheProfiler )
+			{
+				// INIT
+				analyzer a(0, true, true);
+				statistics_accumulator accumulator;
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> ser(buffer);
+				size_t paths_count;
+
+				accept(a, 1, 0);
+				accumulator.accumulate(a);
+				accumulator.save(ser, 1000000);
+
+				// ACT
+				vector<loaded_function> functions = load_statistics_file(buffer.buffer, paths_count);
+
+				// ASSERT
+				assert_equal(2u, functions.size());
+				assert_equal(L"0x1000", functions[0].name);
+				assert_equal(L"1", functions[0].times_called);
+				assert_equal(L"0x2000", functions[1].name);
+				assert_equal(L"1", functions[1].times_called);
+				assert_equal(3u, paths_count);
+			}
+		end_test_suite
+	}
+}
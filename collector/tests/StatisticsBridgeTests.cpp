@@ -206,6 +206,221 @@ namespace micro_profiler
 			}
 
 
+			test( ColumnarUpdatesAreAnnouncedAndPassedToFrontend )
+			{
+				// INIT
+				mockups::Tracer cc(0);
+				statistics_bridge b(cc, _state.MakeFactory(), _queue, update_format_columnar, 0, false, true);
+				call_record trace[] = {
+					{	0, (void *)0x1223	},
+						{	5, (void *)0x2223	},
+						{	12, (void *)(0)	},
+						{	15, (void *)0x2223	},
+						{	17, (void *)(0)	},
+					{	30, (void *)(0)	},
+				};
+
+				cc.Add(0, trace);
+
+				// ACT
+				b.analyze();
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(update_format_columnar, _state.process_init.statistics_format);
+				assert_equal(1u, _state.update_log.size());
+
+				mockups::statistics_map_detailed &u = _state.update_log[0].update;
+
+				assert_equal(2u, u.size());
+				assert_equal(1u, u[0x1223].times_called);
+				assert_equal(30, u[0x1223].inclusive_time);
+				assert_equal(21, u[0x1223].exclusive_time);
+				assert_equal(1u, u[0x1223].callees.size());
+				assert_equal(2u, u[0x1223].callees[0x2223].times_called);
+				assert_equal(9, u[0x1223].callees[0x2223].inclusive_time);
+				assert_equal(2u, u[0x2223].times_called);
+				assert_equal(7, u[0x2223].max_call_time);
+				assert_equal(2u, u[0x2223].latencies.total());
+				assert_equal(7, u[0x2223].latencies.percentile(1));
+			}
+
+
+			test( LatenciesAndCallPathsAreNotCollectedUnlessExtendedAnalysisIsRequested )
+			{
+				// INIT
+				mockups::Tracer cc(0);
+				statistics_bridge b(cc, _state.MakeFactory(), _queue);
+				call_record trace[] = {
+					{	0, (void *)0x1223	},
+					{	30, (void *)(0)	},
+				};
+
+				cc.Add(0, trace);
+
+				// ACT
+				b.analyze();
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(1u, _state.update_log.size());
+				assert_equal(1u, _state.update_log[0].update[0x1223].times_called);
+				assert_equal(0u, _state.update_log[0].update[0x1223].latencies.total());
+				assert_equal(call_paths().size(), _state.paths.size());
+			}
+
+
+			test( IndexedUpdatesRegisterEachAddressOnlyOnce )
+			{
+				// INIT
+				mockups::Tracer cc(0);
+				statistics_bridge b(cc, _state.MakeFactory(), _queue, update_format_indexed);
+				call_record trace1[] = {
+					{	0, (void *)0x1223	},
+						{	5, (void *)0x2223	},
+						{	12, (void *)(0)	},
+					{	30, (void *)(0)	},
+				};
+				call_record trace2[] = {
+					{	40, (void *)0x3223	},
+						{	41, (void *)0x2223	},
+						{	45, (void *)(0)	},
+					{	50, (void *)(0)	},
+				};
+
+				cc.Add(0, trace1);
+
+				// ACT
+				b.analyze();
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(update_format_indexed, _state.process_init.statistics_format);
+				assert_equal(2u, _state.addresses.size());
+				assert_equal(1u, _state.update_log.size());
+
+				mockups::statistics_map_detailed &u1 = _state.update_log[0].update;
+
+				assert_equal(2u, u1.size());
+				assert_equal(1u, u1[0x1223].times_called);
+				assert_equal(30, u1[0x1223].inclusive_time);
+				assert_equal(1u, u1[0x1223].callees.size());
+				assert_equal(7, u1[0x1223].callees[0x2223].inclusive_time);
+				assert_equal(1u, u1[0x2223].times_called);
+
+				// INIT
+				cc.Add(0, trace2);
+
+				// ACT
+				b.analyze();
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(3u, _state.addresses.size());
+				assert_equal(0x3223u, _state.addresses[2]);
+				assert_equal(2u, _state.update_log.size());
+
+				mockups::statistics_map_detailed &u2 = _state.update_log[1].update;
+
+				assert_equal(2u, u2.size());
+				assert_equal(1u, u2[0x3223].times_called);
+				assert_equal(10, u2[0x3223].inclusive_time);
+				assert_equal(4, u2[0x3223].callees[0x2223].inclusive_time);
+				assert_equal(1u, u2[0x2223].times_called);
+				assert_equal(4, u2[0x2223].inclusive_time);
+			}
+
+
+			test( PipelinedBridgeDeliversAllUpdatesOnDestruction )
+			{
+				// INIT
+				mockups::Tracer cc(0);
+				call_record trace1[] = {	{	0, (void *)0x1223	}, {	10, (void *)(0)	},	};
+				call_record trace2[] = {	{	20, (void *)0x2223	}, {	25, (void *)(0)	},	};
+
+				// INIT / ACT
+				{
+					statistics_bridge b(cc, _state.MakeFactory(), _queue, update_format_varint, 0, true);
+
+					cc.Add(0, trace1);
+					b.analyze();
+					b.update_frontend();
+					cc.Add(0, trace2);
+					b.analyze();
+					b.update_frontend();
+				}
+
+				// ASSERT
+				assert_equal(0u, _state.ref_count);
+				assert_equal(2u, _state.update_log.size());
+				assert_equal(1u, _state.update_log[0].update[0x1223].times_called);
+				assert_equal(10, _state.update_log[0].update[0x1223].inclusive_time);
+				assert_equal(1u, _state.update_log[1].update[0x2223].times_called);
+				assert_equal(5, _state.update_log[1].update[0x2223].inclusive_time);
+			}
+
+
+			test( MessagesAboveThresholdAreSentCompressed )
+			{
+				// INIT
+				mockups::FrontendState state2;
+				mockups::Tracer cc1(0), cc2(0);
+				statistics_bridge b1(cc1, _state.MakeFactory(), _queue, update_format_varint, 1000),
+					b2(cc2, state2.MakeFactory(), _queue);
+				call_record trace[600];
+
+				for (unsigned int i = 0; i != 300; ++i)
+				{
+					call_record enter = {	10 * i, (void *)(0x10000 + 0x10 * i)	}, exit = {	10 * i + 5, (void *)0	};
+
+					trace[2 * i] = enter, trace[2 * i + 1] = exit;
+				}
+				cc1.Add(0, trace);
+				cc2.Add(0, trace);
+
+				// ACT
+				b1.analyze();
+				b1.update_frontend();
+				b2.analyze();
+				b2.update_frontend();
+
+				// ASSERT
+				assert_equal(1u, _state.compressed_messages);
+				assert_equal(0u, state2.compressed_messages);
+				assert_equal(1u, _state.update_log.size());
+				assert_equal(300u, _state.update_log[0].update.size());
+				for (mockups::statistics_map_detailed::const_iterator i = state2.update_log[0].update.begin();
+					i != state2.update_log[0].update.end(); ++i)
+				{
+					assert_equal(i->second.times_called, _state.update_log[0].update[i->first].times_called);
+					assert_equal(i->second.inclusive_time, _state.update_log[0].update[i->first].inclusive_time);
+				}
+			}
+
+
+			test( MessagesBelowThresholdAreSentRaw )
+			{
+				// INIT
+				mockups::Tracer cc(0);
+				statistics_bridge b(cc, _state.MakeFactory(), _queue, update_format_varint, 100000);
+				call_record trace[] = {
+					{	0, (void *)0x1223	},
+					{	10, (void *)(0)	},
+				};
+
+				cc.Add(0, trace);
+
+				// ACT
+				b.analyze();
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(0u, _state.compressed_messages);
+				assert_equal(1u, _state.update_log.size());
+				assert_equal(1u, _state.update_log[0].update[0x1223].times_called);
+			}
+
+
 			test( LoadedModulesAreReportedOnUpdate )
 			{
 				// INIT
@@ -302,6 +517,58 @@ namespace micro_profiler
 				assert_is_empty(_state.update_log[2].update);
 				assert_equal(1u, _state.update_log[2].image_unloads.size());
 			}
+
+
+			test( CallPathsArePassedToFrontendIncrementally )
+			{
+				// INIT
+				mockups::Tracer cc(0);
+				statistics_bridge b(cc, _state.MakeFactory(), _queue, update_format_varint, 0, false, true);
+				call_record trace1[] = {
+					{	0, (void *)0x1223	},
+					{	10, (void *)0x2223	},
+					{	30, (void *)0	},
+					{	100, (void *)0	},
+				};
+				call_record trace2[] = {
+					{	200, (void *)0x1223	},
+					{	205, (void *)0x2223	},
+					{	206, (void *)0	},
+					{	209, (void *)0x3223	},
+					{	219, (void *)0	},
+					{	220, (void *)0	},
+				};
+
+				cc.Add(0, trace1);
+				b.analyze();
+
+				// ACT
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(3u, _state.paths.size());
+				assert_equal(0u, _state.paths[1].parent);
+				assert_equal(0x1223u, _state.paths[1].function);
+				assert_equal(80, _state.paths[1].exclusive_time);
+				assert_equal(1u, _state.paths[2].parent);
+				assert_equal(0x2223u, _state.paths[2].function);
+				assert_equal(20, _state.paths[2].exclusive_time);
+
+				// INIT
+				cc.Add(0, trace2);
+				b.analyze();
+
+				// ACT
+				b.update_frontend();
+
+				// ASSERT
+				assert_equal(4u, _state.paths.size());
+				assert_equal(89, _state.paths[1].exclusive_time);
+				assert_equal(21, _state.paths[2].exclusive_time);
+				assert_equal(1u, _state.paths[3].parent);
+				assert_equal(0x3223u, _state.paths[3].function);
+				assert_equal(10, _state.paths[3].exclusive_time);
+			}
 		end_test_suite
 	}
 }
@@ -0,0 +1,41 @@
+#include "StatisticsFile.h"
+
+#include <common/serialization.h>
+#include <frontend/function_list.h>
+#include <test-helpers/helpers.h>
+
+#include <strmd/deserializer.h>
+#include <ut/assert.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		vector<loaded_function> load_statistics_file(const vector<byte> &file, size_t &paths_count)
+		{
+			vector_adapter buffer;
+			strmd::deserializer<vector_adapter, packer> dser(buffer);
+			vector<loaded_function> functions;
+
+			buffer.buffer = file;
+
+			shared_ptr<functions_list> fl = functions_list::load(dser);
+
+			assert_equal(buffer.end_position(), buffer.ptr);
+			fl->set_order(1, true);
+			for (functions_list::index_type i = 0; i != fl->get_count(); ++i)
+			{
+				loaded_function f;
+
+				fl->get_text(i, 1, f.name);
+				fl->get_text(i, 2, f.times_called);
+				fl->get_text(i, 4, f.inclusive_time);
+				functions.push_back(f);
+			}
+			paths_count = fl->paths().size();
+			return functions;
+		}
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <common/primitives.h>
+
+#include <string>
+#include <vector>
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		struct loaded_function
+		{
+			std::wstring name, times_called, inclusive_time;
+		};
+
+		// Loads a statistics file with functions_list::load(), just like the profiler opens it, and returns the text of
+		// its rows ordered by name. Kept in a separate translation unit, since the frontend's primitives clash with the
+		// collector's.
+		std::vector<loaded_function> load_statistics_file(const std::vector<byte> &file, size_t &paths_count);
+	}
+}
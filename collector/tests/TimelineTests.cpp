@@ -0,0 +1,186 @@
+#include <collector/timeline.h>
+
+#include <test-helpers/helpers.h>
+
+#include <string>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			void append_text(string &text, const void *buffer, size_t size)
+			{	text.append(static_cast<const char *>(buffer), size);	}
+
+			string export_text(const timeline &t)
+			{
+				string text;
+
+				t.export_events(bind(&append_text, ref(text), _1, _2), 1000000000);
+				return text;
+			}
+		}
+
+		begin_test_suite( TimelineTests )
+			test( NewTimelineIsEmpty )
+			{
+				// INIT / ACT
+				timeline t(100);
+
+				// ASSERT
+				assert_equal(100u, t.window());
+				assert_equal(0u, t.size());
+				assert_equal("{\"traceEvents\":[\n]}\n", export_text(t));
+			}
+
+
+			test( RecordsAreKeptPerThreadUpToWindowSize )
+			{
+				// INIT
+				timeline t(3);
+				call_record trace1[] = {
+					{	1, (void *)0x10	},
+					{	2, (void *)0x20	},
+				};
+				call_record trace2[] = {
+					{	1, (void *)0x30	},
+					{	2, (void *)0	},
+					{	3, (void *)0x40	},
+					{	4, (void *)0	},
+					{	5, (void *)0x50	},
+				};
+
+				// ACT
+				t.accept_calls(1, trace1, array_size(trace1));
+
+				// ASSERT
+				assert_equal(2u, t.size());
+
+				// ACT
+				t.accept_calls(2, trace2, array_size(trace2));
+
+				// ASSERT
+				assert_equal(5u, t.size());
+
+				// ACT
+				t.accept_calls(1, trace1, array_size(trace1));
+
+				// ASSERT
+				assert_equal(6u, t.size());
+
+				// ACT
+				t.clear();
+
+				// ASSERT
+				assert_equal(0u, t.size());
+			}
+
+
+			test( OldestRecordsAreDiscardedAndUnmatchedExitsAreSkipped )
+			{
+				// INIT
+				timeline t(4);
+				call_record trace1[] = {
+					{	1000, (void *)0x10	},
+					{	2000, (void *)0x20	},
+					{	3000, (void *)0	},
+				};
+				call_record trace2[] = {
+					{	4000, (void *)0	},
+					{	5000, (void *)0x30	},
+					{	6000, (void *)0	},
+				};
+
+				// ACT
+				t.accept_calls(1, trace1, array_size(trace1));
+				t.accept_calls(1, trace2, array_size(trace2));
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":1,\"ts\":2.000,\"name\":\"0x30\"},"
+					"\n{\"ph\":\"E\",\"pid\":1,\"tid\":1,\"ts\":3.000}"
+					"\n]}\n", export_text(t));
+			}
+
+
+			test( TraceLongerThanWindowLeavesItsTail )
+			{
+				// INIT
+				timeline t(2);
+				call_record trace[] = {
+					{	1000, (void *)0x10	},
+					{	2000, (void *)0	},
+					{	3000, (void *)0x20	},
+					{	4000, (void *)0	},
+				};
+
+				// ACT
+				t.accept_calls(7, trace, array_size(trace));
+
+				// ASSERT
+				assert_equal(2u, t.size());
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":7,\"ts\":0.000,\"name\":\"0x20\"},"
+					"\n{\"ph\":\"E\",\"pid\":1,\"tid\":7,\"ts\":1.000}"
+					"\n]}\n", export_text(t));
+			}
+
+
+			test( EventsAreTimedRelativeToEarliestRecordOfAllThreads )
+			{
+				// INIT
+				timeline t(10);
+				call_record trace1[] = {
+					{	5000, (void *)0x10	},
+				};
+				call_record trace2[] = {
+					{	3000, (void *)0x20	},
+				};
+
+				// ACT
+				t.accept_calls(1, trace1, array_size(trace1));
+				t.accept_calls(2, trace2, array_size(trace2));
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":1,\"ts\":2.000,\"name\":\"0x10\"},"
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":2,\"ts\":0.000,\"name\":\"0x20\"}"
+					"\n]}\n", export_text(t));
+			}
+
+
+			test( EventsAreNamedAfterClosestModuleBelowTheFunction )
+			{
+				// INIT
+				timeline t(10);
+				module_info m[] = {
+					{	0x1000, L"/usr/lib/libfoo.so"	},
+					{	0x8000, L"c:\\program files\\app.exe"	},
+				};
+				call_record trace[] = {
+					{	1000, (void *)0x10	},
+					{	2000, (void *)0x1234	},
+					{	3000, (void *)0x8000	},
+				};
+
+				t.accept_calls(1, trace, array_size(trace));
+
+				// ACT
+				t.add_modules(mkvector(m));
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":1,\"ts\":0.000,\"name\":\"0x10\"},"
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":1,\"ts\":1.000,\"name\":\"libfoo.so+0x234\"},"
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":1,\"ts\":2.000,\"name\":\"app.exe+0x0\"}"
+					"\n]}\n", export_text(t));
+			}
+		end_test_suite
+	}
+}
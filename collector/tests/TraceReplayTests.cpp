@@ -0,0 +1,240 @@
+#include <collector/trace_replay.h>
+
+#include "StatisticsFile.h"
+
+#include <collector/analyzer.h>
+#include <common/serialization.h>
+#include <test-helpers/helpers.h>
+
+#include <map>
+#include <strmd/serializer.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			typedef map<pair<unsigned int, unsigned int>, vector<byte> > segments_map;
+
+			struct recording
+			{
+				recording()
+					: reads(0)
+				{	}
+
+				raw_trace_index_entry add(unsigned int threadid, unsigned int segment, const call_record *calls,
+					size_t count)
+				{
+					vector<byte> &buffer = segments[make_pair(threadid, segment)];
+					raw_trace_header header = {
+						raw_trace_signature, threadid, 0, count, calls[0].timestamp, calls[count - 1].timestamp
+					};
+					raw_trace_encoder encoder;
+					raw_trace_index_entry entry = {
+						threadid, segment, count, calls[0].timestamp, calls[count - 1].timestamp
+					};
+
+					buffer.resize(sizeof(header) + count * max_packed_call_record_size);
+					header.size = encoder.encode(&buffer[sizeof(header)], calls, count);
+					buffer.resize(sizeof(header) + static_cast<size_t>(header.size));
+					memcpy(&buffer[0], &header, sizeof(header));
+					return entry;
+				}
+
+				segments_map segments;
+				int reads;
+			};
+
+			bool read_segment(recording *r, const raw_trace_index_entry &entry, vector<byte> &buffer)
+			{
+				segments_map::const_iterator i = r->segments.find(make_pair(entry.threadid, entry.segment));
+
+				++r->reads;
+				if (i == r->segments.end())
+					return false;
+				buffer = i->second;
+				return true;
+			}
+
+			const function_statistics &get(const trace_replay &replay, long_address_t address)
+			{	return replay.result().statistics().find(address)->second;	}
+		}
+
+		begin_test_suite( TraceReplayTests )
+			test( ReplayedSegmentsProduceTheSameStatisticsAsTheLiveAnalyzer )
+			{
+				// INIT
+				recording r;
+				trace_replay replay(bind(&read_segment, &r, _1, _2), 3);
+				call_record trace1[] = {
+					{	1000, (void *)0x1000	},
+						{	1010, (void *)0x2000	},
+						{	1030, 0	},
+					{	1100, 0	},
+				};
+				call_record trace2[] = {
+					{	1200, (void *)0x1000	},
+					{	1250, 0	},
+				};
+				analyzer reference(3, true, true);
+
+				replay.add_segment(r.add(7, 1, trace2, array_size(trace2)));
+				replay.add_segment(r.add(7, 0, trace1, array_size(trace1)));
+				reference.accept_calls(7, trace1, array_size(trace1));
+				reference.accept_calls(7, trace2, array_size(trace2));
+
+				// ACT
+				assert_is_true(replay.run(1, 0, 100000));
+
+				// ASSERT
+				assert_equal(2u, replay.result().statistics().size());
+				assert_equal(static_cast<const function_statistics &>(reference.begin()->second),
+					get(replay, reinterpret_cast<size_t>(reference.begin()->first)));
+				assert_equal(2u, get(replay, 0x1000).times_called);
+				assert_equal(144, get(replay, 0x1000).inclusive_time);
+				assert_equal(1u, replay.result().statistics().find(0x1000)->second.callees.size());
+				assert_equal(reference.paths().size(), replay.result().paths().size());
+			}
+
+
+			test( ThreadsReplayedInParallelAreMerged )
+			{
+				// INIT
+				recording r;
+				trace_replay replay1(bind(&read_segment, &r, _1, _2), 0);
+				trace_replay replay4(bind(&read_segment, &r, _1, _2), 0);
+
+				for (unsigned int threadid = 1; threadid != 10; ++threadid)
+				{
+					call_record trace[] = {
+						{	1000, (void *)0x1000	},
+							{	1000 + threadid, (void *)(0x2000 + 0x10 * (threadid % 3))	},
+							{	1020, 0	},
+						{	1100, 0	},
+					};
+					const raw_trace_index_entry entry = r.add(threadid, 0, trace, array_size(trace));
+
+					replay1.add_segment(entry);
+					replay4.add_segment(entry);
+				}
+
+				// ACT
+				assert_is_true(replay1.run(1, 0, 100000));
+				assert_is_true(replay4.run(4, 0, 100000));
+
+				// ASSERT
+				assert_equal(4u, replay4.result().statistics().size());
+				assert_equal(9u, get(replay4, 0x1000).times_called);
+				assert_equal(get(replay1, 0x1000), get(replay4, 0x1000));
+				assert_equal(get(replay1, 0x2000), get(replay4, 0x2000));
+				assert_equal(get(replay1, 0x2010), get(replay4, 0x2010));
+				assert_equal(get(replay1, 0x2020), get(replay4, 0x2020));
+				assert_equal(3u, replay4.result().statistics().find(0x1000)->second.callees.size());
+				assert_equal(replay1.result().paths().size(), replay4.result().paths().size());
+				assert_equal(5u, replay4.result().paths().size());
+			}
+
+
+			test( SegmentsOutsideTheTimeRangeAreNotRead )
+			{
+				// INIT
+				recording r;
+				trace_replay replay(bind(&read_segment, &r, _1, _2), 0);
+				call_record trace1[] = {	{	1000, (void *)0x1000	}, {	1100, 0	},	};
+				call_record trace2[] = {	{	2000, (void *)0x2000	}, {	2100, 0	},	};
+				call_record trace3[] = {	{	3000, (void *)0x3000	}, {	3100, 0	},	};
+
+				replay.add_segment(r.add(1, 0, trace1, 2));
+				replay.add_segment(r.add(1, 1, trace2, 2));
+				replay.add_segment(r.add(1, 2, trace3, 2));
+
+				// ACT
+				assert_is_true(replay.run(2, 1500, 2500));
+
+				// ASSERT
+				assert_equal(1, r.reads);
+				assert_equal(1u, replay.result().statistics().size());
+				assert_equal(100, get(replay, 0x2000).inclusive_time);
+			}
+
+
+			test( RecordsOutsideTheTimeRangeAreSkipped )
+			{
+				// INIT
+				recording r;
+				trace_replay replay(bind(&read_segment, &r, _1, _2), 0);
+				call_record trace[] = {
+					{	1000, (void *)0x1000	}, {	1100, 0	},
+					{	2000, (void *)0x2000	}, {	2100, 0	},
+					{	3000, (void *)0x3000	}, {	3100, 0	},
+				};
+
+				replay.add_segment(r.add(1, 0, trace, array_size(trace)));
+
+				// ACT
+				replay.run(1, 2000, 3000);
+
+				// ASSERT
+				assert_equal(1u, replay.result().statistics().size());
+				assert_equal(1u, get(replay, 0x2000).times_called);
+			}
+
+
+			test( MissingSegmentsAreReportedAndTheRestIsReplayed )
+			{
+				// INIT
+				recording r;
+				trace_replay replay(bind(&read_segment, &r, _1, _2), 0);
+				call_record trace[] = {	{	1000, (void *)0x1000	}, {	1100, 0	},	};
+				raw_trace_index_entry missing = {	2, 0, 2, 1000, 1100	};
+
+				replay.add_segment(r.add(1, 0, trace, 2));
+				replay.add_segment(missing);
+
+				// ACT / ASSERT
+				assert_is_false(replay.run(2, 0, 100000));
+				assert_equal(1u, replay.result().statistics().size());
+			}
+
+
+			test( ReplayedStatisticsAreSavedInAFileTheProfilerLoads )
+			{
+				// INIT
+				recording r;
+				trace_replay replay(bind(&read_segment, &r, _1, _2), 0);
+				call_record trace[] = {
+					{	1000, (void *)0x1000	},
+						{	1010, (void *)0x2000	},
+						{	1030, 0	},
+					{	1100, 0	},
+				};
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> ser(buffer);
+				size_t paths_count;
+
+				replay.add_segment(r.add(1, 0, trace, array_size(trace)));
+				replay.run(1, 0, 100000);
+
+				// ACT
+				replay.result().save(ser, 1000);
+
+				// ASSERT
+				vector<loaded_function> functions = load_statistics_file(buffer.buffer, paths_count);
+
+				assert_equal(2u, functions.size());
+				assert_equal(L"0x1000", functions[0].name);
+				assert_equal(L"1", functions[0].times_called);
+				assert_equal(L"100ms", functions[0].inclusive_time);
+				assert_equal(L"0x2000", functions[1].name);
+				assert_equal(L"20ms", functions[1].inclusive_time);
+				assert_equal(replay.result().paths().size(), paths_count);
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,85 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "calls_collector.h"
+
+#include <common/protocol.h>
+#include <common/trace_events.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace micro_profiler
+{
+	// Keeps the most recent raw enter/exit records of each thread (at most 'window' records per thread), so that the
+	// exact call sequence preceding a moment of interest can be exported as a timeline. The records are only held in
+	// memory: the collector exports them once, when profiling stops.
+	class timeline : public calls_collector_i::acceptor
+	{
+	public:
+		explicit timeline(size_t window);
+
+		size_t window() const throw();
+		size_t size() const;
+		void clear();
+
+		// Remembers the modules loaded, so that the events exported are named '<module file>+0x<offset>' after the
+		// closest module added below the function address, or '0x<address>' if there is none. Modules are kept across
+		// clear().
+		void add_modules(const loaded_modules &modules);
+
+		void export_events(const trace_events_writer::sink_t &sink, timestamp_t ticks_per_second,
+			unsigned int pid = 1) const;
+
+		virtual void accept_calls(unsigned int threadid, const call_record *calls, size_t count);
+
+	private:
+		class thread_window;
+		typedef std::map<unsigned int /*threadid*/, thread_window> windows_map;
+
+	private:
+		timeline(const timeline &other);
+		void operator =(const timeline &rhs);
+
+		std::string event_name(long_address_t address) const;
+
+	private:
+		const size_t _window;
+		mutable mutex _mtx;
+		windows_map _windows;
+		std::map<long_address_t, std::string> _modules;
+	};
+
+	class timeline::thread_window
+	{
+	public:
+		thread_window();
+
+		void append(const call_record *calls, size_t count, size_t window);
+		size_t size() const throw();
+		const call_record &operator [](size_t index) const throw();
+
+	private:
+		std::vector<call_record> _records;
+		size_t _head;
+	};
+}
@@ -0,0 +1,83 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "calls_collector.h"
+
+#include <common/raw_trace.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <wpl/base/concepts.h>
+
+namespace micro_profiler
+{
+	class mapped_file;
+
+	// Records the call records read from the collector into memory-mapped raw trace segments (see
+	// common/raw_trace.h). Each recorder creates its own session subdirectory - the first free '<directory>/<n>',
+	// n = 1, 2, ... - so that earlier recordings are never overwritten. There is one sequence of segments per thread:
+	// '<session>/<threadid>-<segment>.trace'. The index ('<session>/index') opens with the timing parameters needed to
+	// analyze the recording offline, and lists a segment as soon as it is opened. The index entry gets the record
+	// count and time range once the segment is full, or when the recorder is destroyed - the segment is truncated to
+	// its actual size then. The segment header is kept up to date after each block of calls, so a segment left by a
+	// terminated process (listed with zero records) is readable up to the last block recorded. A thread whose segment
+	// cannot be created or mapped is not recorded any further.
+	class trace_recorder : public calls_collector_i::acceptor, wpl::noncopyable
+	{
+	public:
+		enum {	min_segment_size = 0x10000	};
+
+	public:
+		trace_recorder(const std::wstring &directory, size_t segment_size, timestamp_t ticks_per_second,
+			timestamp_t profiler_latency);
+		~trace_recorder();
+
+		virtual void accept_calls(unsigned int threadid, const call_record *calls, size_t count);
+
+	private:
+		struct thread_trace
+		{
+			thread_trace();
+
+			unsigned int segment;
+			long index_offset;
+			bool stopped;
+			std::auto_ptr<mapped_file> file;
+			raw_trace_encoder encoder;
+		};
+
+		typedef std::map< unsigned int /*threadid*/, std::shared_ptr<thread_trace> > traces_map;
+
+	private:
+		bool open_segment(unsigned int threadid, thread_trace &trace);
+		void close_segment(thread_trace &trace);
+		long write_index_entry(const raw_trace_index_entry &entry, long offset);
+
+	private:
+		const std::wstring _directory;
+		const size_t _segment_size;
+		std::shared_ptr<FILE> _index;
+		traces_map _traces;
+	};
+}
@@ -0,0 +1,65 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "statistics_accumulator.h"
+
+#include <common/raw_trace.h>
+
+#include <functional>
+#include <vector>
+#include <wpl/base/concepts.h>
+
+namespace micro_profiler
+{
+	// Replays raw trace recordings (see trace_recorder.h) through the analyzer, offline. The threads recorded are
+	// distributed among the workers, each replaying the segments of its threads in order into an analyzer of its
+	// own; the results are merged once all the workers are done. Only the records within the time range are
+	// replayed, and the segments lying entirely outside of it are not read at all.
+	class trace_replay : wpl::noncopyable
+	{
+	public:
+		// Reads the whole segment file (header included) into the buffer. Called concurrently by the workers.
+		typedef std::function<bool (const raw_trace_index_entry &segment, std::vector<byte> &buffer)> segment_reader;
+
+	public:
+		trace_replay(const segment_reader &reader, timestamp_t profiler_latency);
+
+		void add_segment(const raw_trace_index_entry &segment);
+
+		// Replays records with timestamps in [begin, end). Returns false if any segment could not be read.
+		bool run(unsigned int workers, timestamp_t begin, timestamp_t end);
+
+		const statistics_accumulator &result() const throw();
+
+	private:
+		struct worker_context;
+
+	private:
+		void replay(worker_context *context) const;
+
+	private:
+		const segment_reader _reader;
+		const timestamp_t _profiler_latency;
+		std::vector<raw_trace_index_entry> _segments;
+		statistics_accumulator _accumulator;
+	};
+}
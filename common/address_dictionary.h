@@ -0,0 +1,156 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace micro_profiler
+{
+	// Assigns dense per-session ids to function addresses in the order of their first appearance. Used by the
+	// sending side of update_format_indexed.
+	class address_dictionary
+	{
+	public:
+		// Assigns ids to all the function and callee addresses met in the statistics. Addresses that had no id yet
+		// are listed into 'registered' in the order of their ids.
+		template <typename ContainerT>
+		void register_addresses(const ContainerT &statistics, std::vector<long_address_t> &registered);
+
+		unsigned int operator [](const void *address) const;
+		size_t size() const throw();
+
+	private:
+		void add(const void *address, std::vector<long_address_t> &registered);
+
+	private:
+		std::unordered_map<const void *, unsigned int, address_compare> _ids;
+	};
+
+	// Receiving side of the dictionary: resolves ids into addresses and remembers the statistics entry each id
+	// refers to, so that merging an update does not hash the addresses of the functions. Ids come from the wire, so
+	// the ones not appended yet are rejected with std::out_of_range.
+	template <typename AddressT>
+	class address_index
+	{
+	public:
+		typedef typename statistics_map_detailed_t<AddressT>::mapped_type entry_type;
+
+	public:
+		void append(long_address_t address);
+		size_t size() const throw();
+		AddressT operator [](unsigned int id) const;
+		entry_type &entry(statistics_map_detailed_t<AddressT> &statistics, unsigned int id);
+
+		// Must be called whenever the entries of the statistics map referred to are removed.
+		void reset_entries() throw();
+
+	private:
+		std::vector<AddressT> _addresses;
+		std::vector<entry_type *> _entries;
+	};
+
+	// Serialization proxy writing statistics with function addresses replaced by their dictionary ids.
+	template <typename ContainerT>
+	struct indexed_statistics_t
+	{
+		const ContainerT &statistics;
+		const address_dictionary &dictionary;
+	};
+
+	// Deserialization target merging indexed statistics, the counterpart of statistics_update_t.
+	template <typename AddressT>
+	struct indexed_update_t
+	{
+		statistics_map_detailed_t<AddressT> &statistics;
+		typename function_statistics_detailed_t<AddressT>::callees_map &delta;
+		address_index<AddressT> &index;
+	};
+
+
+
+	// address_dictionary - inline definitions
+	template <typename ContainerT>
+	inline void address_dictionary::register_addresses(const ContainerT &statistics,
+		std::vector<long_address_t> &registered)
+	{
+		registered.clear();
+		for (typename ContainerT::const_iterator i = statistics.begin(); i != statistics.end(); ++i)
+		{
+			add(i->first, registered);
+			for (typename ContainerT::const_iterator::value_type::second_type::callees_map::const_iterator
+				j = i->second.callees.begin(); j != i->second.callees.end(); ++j)
+			{
+				add(j->first, registered);
+			}
+		}
+	}
+
+	inline unsigned int address_dictionary::operator [](const void *address) const
+	{	return _ids.find(address)->second;	}
+
+	inline size_t address_dictionary::size() const throw()
+	{	return _ids.size();	}
+
+	inline void address_dictionary::add(const void *address, std::vector<long_address_t> &registered)
+	{
+		if (_ids.find(address) == _ids.end())
+		{
+			_ids.insert(std::make_pair(address, static_cast<unsigned int>(_ids.size())));
+			registered.push_back(reinterpret_cast<size_t>(address));
+		}
+	}
+
+
+	// address_index - inline definitions
+	template <typename AddressT>
+	inline void address_index<AddressT>::append(long_address_t address)
+	{
+		_addresses.push_back(static_cast<AddressT>(address));
+		_entries.push_back(0);
+	}
+
+	template <typename AddressT>
+	inline size_t address_index<AddressT>::size() const throw()
+	{	return _addresses.size();	}
+
+	template <typename AddressT>
+	inline AddressT address_index<AddressT>::operator [](unsigned int id) const
+	{	return _addresses.at(id);	}
+
+	template <typename AddressT>
+	inline typename address_index<AddressT>::entry_type &address_index<AddressT>::entry(
+		statistics_map_detailed_t<AddressT> &statistics, unsigned int id)
+	{
+		entry_type *&e = _entries.at(id);
+
+		if (!e)
+			e = &statistics[_addresses[id]];
+		return *e;
+	}
+
+	template <typename AddressT>
+	inline void address_index<AddressT>::reset_entries() throw()
+	{	std::fill(_entries.begin(), _entries.end(), static_cast<entry_type *>(0));	}
+}
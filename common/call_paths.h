@@ -0,0 +1,274 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace micro_profiler
+{
+	// Interned call paths (a trie of stacks): each node is a unique (parent path, function) pair, stored once, so the
+	// memory taken is proportional to the number of distinct stacks seen. Node 0 is the empty root path. Every path
+	// accumulates the exclusive time spent with exactly this stack - the data a flame graph is built from.
+	class call_paths
+	{
+	public:
+		typedef unsigned int path_id;
+		class pending_nodes;
+		class pending_times;
+
+		struct node
+		{
+			path_id parent;
+			long_address_t function;
+			timestamp_t exclusive_time;
+		};
+
+		enum {	root = 0	};
+
+	public:
+		call_paths();
+
+		path_id intern(path_id parent, long_address_t function);
+		void add_time(path_id path, timestamp_t exclusive_time);
+		void commit() throw();
+		void reset_times() throw();
+
+		bool changed() const throw();
+		size_t size() const throw();
+		const node &operator [](path_id path) const throw();
+
+	private:
+		struct key_hash
+		{
+			size_t operator ()(const std::pair<path_id, long_address_t> &key) const throw();
+		};
+
+		typedef std::unordered_map<std::pair<path_id, long_address_t>, path_id, key_hash> index_map;
+
+	private:
+		std::vector<node> _nodes;
+		std::vector<path_id> _timed;
+		index_map _index;
+		path_id _committed;
+	};
+
+	// Nodes interned since the last commit() - the part of the trie the receiving side does not have yet. The nodes
+	// appended come from the wire, so the ones referring to a parent the receiving side does not have are rejected with
+	// std::out_of_range.
+	class call_paths::pending_nodes
+	{
+	public:
+		typedef std::vector<node>::const_iterator const_iterator;
+		typedef node value_type;
+
+	public:
+		explicit pending_nodes(call_paths &paths);
+
+		size_t size() const throw();
+		const_iterator begin() const throw();
+		const_iterator end() const throw();
+
+		void append(const node &n);
+
+	private:
+		void operator =(const pending_nodes &rhs);
+
+	private:
+		call_paths &_paths;
+	};
+
+	// (path, exclusive time) pairs for the paths that got time since the last commit().
+	class call_paths::pending_times
+	{
+	public:
+		class const_iterator;
+		typedef std::pair<path_id, timestamp_t> value_type;
+
+	public:
+		explicit pending_times(call_paths &paths);
+
+		size_t size() const throw();
+		const_iterator begin() const throw();
+		const_iterator end() const throw();
+
+		void append(const value_type &time);
+
+	private:
+		void operator =(const pending_times &rhs);
+
+	private:
+		call_paths &_paths;
+	};
+
+	class call_paths::pending_times::const_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef pending_times::value_type value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const value_type *pointer;
+		typedef const value_type &reference;
+
+	public:
+		const_iterator(const std::vector<node> &nodes, std::vector<path_id>::const_iterator current);
+
+		value_type operator *() const;
+		const_iterator &operator ++();
+		bool operator ==(const const_iterator &rhs) const;
+		bool operator !=(const const_iterator &rhs) const;
+
+	private:
+		const std::vector<node> *_nodes;
+		std::vector<path_id>::const_iterator _current;
+	};
+
+
+
+	// call_paths - inline definitions
+	inline call_paths::call_paths()
+		: _committed(1)
+	{
+		node root_node = {	0, 0, 0	};
+
+		_nodes.push_back(root_node);
+	}
+
+	inline call_paths::path_id call_paths::intern(path_id parent, long_address_t function)
+	{
+		std::pair<index_map::iterator, bool> i = _index.insert(std::make_pair(std::make_pair(parent, function),
+			static_cast<path_id>(_nodes.size())));
+
+		if (i.second)
+		{
+			node n = {	parent, function, 0	};
+
+			_nodes.push_back(n);
+		}
+		return i.first->second;
+	}
+
+	inline void call_paths::add_time(path_id path, timestamp_t exclusive_time)
+	{
+		timestamp_t &time = _nodes[path].exclusive_time;
+
+		if (exclusive_time <= 0)
+			return;	// Overcompensated profiler latency - nothing to show on a flame graph.
+		if (!time)
+			_timed.push_back(path);
+		time += exclusive_time;
+	}
+
+	inline void call_paths::commit() throw()
+	{
+		_committed = static_cast<path_id>(_nodes.size());
+		reset_times();
+	}
+
+	inline void call_paths::reset_times() throw()
+	{
+		for (std::vector<path_id>::const_iterator i = _timed.begin(); i != _timed.end(); ++i)
+			_nodes[*i].exclusive_time = 0;
+		_timed.clear();
+	}
+
+	inline bool call_paths::changed() const throw()
+	{	return _committed != _nodes.size() || !_timed.empty();	}
+
+	inline size_t call_paths::size() const throw()
+	{	return _nodes.size();	}
+
+	inline const call_paths::node &call_paths::operator [](path_id path) const throw()
+	{	return _nodes[path];	}
+
+	inline size_t call_paths::key_hash::operator ()(const std::pair<path_id, long_address_t> &key) const throw()
+	{	return address_compare()(key.second) ^ static_cast<size_t>(key.first * 2654435761u);	}
+
+
+	// call_paths::pending_nodes - inline definitions
+	inline call_paths::pending_nodes::pending_nodes(call_paths &paths)
+		: _paths(paths)
+	{	}
+
+	inline size_t call_paths::pending_nodes::size() const throw()
+	{	return _paths._nodes.size() - _paths._committed;	}
+
+	inline call_paths::pending_nodes::const_iterator call_paths::pending_nodes::begin() const throw()
+	{	return _paths._nodes.begin() + _paths._committed;	}
+
+	inline call_paths::pending_nodes::const_iterator call_paths::pending_nodes::end() const throw()
+	{	return _paths._nodes.end();	}
+
+	inline void call_paths::pending_nodes::append(const node &n)
+	{
+		if (n.parent >= _paths._nodes.size())
+			throw std::out_of_range("Unknown parent path!");
+		_paths.intern(n.parent, n.function);
+	}
+
+
+	// call_paths::pending_times - inline definitions
+	inline call_paths::pending_times::pending_times(call_paths &paths)
+		: _paths(paths)
+	{	}
+
+	inline size_t call_paths::pending_times::size() const throw()
+	{	return _paths._timed.size();	}
+
+	inline call_paths::pending_times::const_iterator call_paths::pending_times::begin() const throw()
+	{	return const_iterator(_paths._nodes, _paths._timed.begin());	}
+
+	inline call_paths::pending_times::const_iterator call_paths::pending_times::end() const throw()
+	{	return const_iterator(_paths._nodes, _paths._timed.end());	}
+
+	inline void call_paths::pending_times::append(const value_type &time)
+	{
+		if (time.first < _paths._nodes.size())
+			_paths.add_time(time.first, time.second);
+	}
+
+
+	// call_paths::pending_times::const_iterator - inline definitions
+	inline call_paths::pending_times::const_iterator::const_iterator(const std::vector<node> &nodes,
+			std::vector<path_id>::const_iterator current)
+		: _nodes(&nodes), _current(current)
+	{	}
+
+	inline call_paths::pending_times::value_type call_paths::pending_times::const_iterator::operator *() const
+	{	return std::make_pair(*_current, (*_nodes)[*_current].exclusive_time);	}
+
+	inline call_paths::pending_times::const_iterator &call_paths::pending_times::const_iterator::operator ++()
+	{
+		++_current;
+		return *this;
+	}
+
+	inline bool call_paths::pending_times::const_iterator::operator ==(const const_iterator &rhs) const
+	{	return _current == rhs._current;	}
+
+	inline bool call_paths::pending_times::const_iterator::operator !=(const const_iterator &rhs) const
+	{	return _current != rhs._current;	}
+}
@@ -0,0 +1,237 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+#include <string.h>
+#include <vector>
+
+namespace micro_profiler
+{
+	// Columnar (struct-of-arrays) layout of an update_statistics payload. Values are fixed-width and stored in native
+	// byte order; every column occupies a multiple of 8 bytes (4-byte columns are zero-padded), so each column starts
+	// 8-byte aligned relative to the payload. The payload itself follows a varint command in the message and may sit
+	// at any address, so values are copied out of the columns rather than dereferenced in place:
+	//	header:		uint32 function_count, edge_count, bucket_count, reserved
+	//	functions:	address[], times_called[], inclusive_time[], exclusive_time[], max_call_time[], max_reentrance[]
+	//	edges:		callee[], times_called[], inclusive_time[], exclusive_time[], max_call_time[], max_reentrance[],
+	//				caller[] (index into functions)
+	//	buckets:	count[], function[] (index into functions), bucket[]
+	// Edges and buckets are ordered by their function index, so the whole payload is merged in a single pass.
+	template <typename T>
+	struct column
+	{
+		T operator [](unsigned int index) const throw();
+
+		const void *data;
+	};
+
+	struct statistics_columns
+	{
+		column<long_address_t> address;
+		column<count_t> times_called;
+		column<timestamp_t> inclusive_time, exclusive_time, max_call_time;
+		column<unsigned int> max_reentrance;
+
+		function_statistics at(unsigned int index) const throw();
+	};
+
+	struct columnar_update
+	{
+		// Points the columns into the payload. Returns false if the payload is shorter than its header claims.
+		bool parse(const void *data, size_t size) throw();
+
+		unsigned int function_count, edge_count, bucket_count;
+		statistics_columns functions, edges;
+		column<unsigned int> edge_caller;
+		column<count_t> bucket_hits;
+		column<unsigned int> bucket_function, bucket_index;
+	};
+
+	template <typename WriterT, typename IteratorT>
+	void write_columnar(WriterT &writer, IteratorT begin, IteratorT end);
+
+	// Merges the update into the statistics the same way the varint reader does: entries are summed, the flat
+	// per-function delta is accumulated (if requested) and entry_updated is raised for entries having callees.
+	template <typename AddressT>
+	void merge_columnar(statistics_map_detailed_t<AddressT> &statistics,
+		typename function_statistics_detailed_t<AddressT>::callees_map *delta, const columnar_update &update);
+
+
+
+	namespace columnar
+	{
+		template <typename AddressT>
+		inline long_address_t to_long_address(AddressT address)
+		{	return address;	}
+
+		inline long_address_t to_long_address(const void *address)
+		{	return reinterpret_cast<size_t>(address);	}
+
+		template <typename AddressT>
+		inline void from_long_address(AddressT &to, long_address_t from)
+		{	to = static_cast<AddressT>(from);	}
+
+		inline void from_long_address(const void *&to, long_address_t from)
+		{	to = reinterpret_cast<const void *>(static_cast<size_t>(from));	}
+
+		template <typename AddressT>
+		inline AddressT address_at(const statistics_columns &columns, unsigned int index)
+		{
+			AddressT address;
+
+			from_long_address(address, columns.address[index]);
+			return address;
+		}
+
+		template <typename WriterT, typename T>
+		inline void write_column(WriterT &writer, const std::vector<T> &column)
+		{
+			const unsigned int padding = 0;
+
+			if (!column.empty())
+				writer.write(&column[0], column.size() * sizeof(T));
+			if (column.size() * sizeof(T) % 8)
+				writer.write(&padding, sizeof(padding));
+		}
+
+		// Columns are gathered in a single pass over the source, which is far cheaper than a pass per column.
+		struct staging_columns
+		{
+			void push_back(long_address_t address_, const function_statistics &s)
+			{
+				address.push_back(address_);
+				times_called.push_back(s.times_called);
+				inclusive_time.push_back(s.inclusive_time);
+				exclusive_time.push_back(s.exclusive_time);
+				max_call_time.push_back(s.max_call_time);
+				max_reentrance.push_back(s.max_reentrance);
+			}
+
+			template <typename WriterT>
+			void write(WriterT &writer) const
+			{
+				write_column(writer, address);
+				write_column(writer, times_called);
+				write_column(writer, inclusive_time);
+				write_column(writer, exclusive_time);
+				write_column(writer, max_call_time);
+				write_column(writer, max_reentrance);
+			}
+
+			std::vector<long_address_t> address;
+			std::vector<count_t> times_called;
+			std::vector<timestamp_t> inclusive_time, exclusive_time, max_call_time;
+			std::vector<unsigned int> max_reentrance;
+		};
+	}
+
+
+	// column - inline definitions
+	template <typename T>
+	inline T column<T>::operator [](unsigned int index) const throw()
+	{
+		T value;
+
+		memcpy(&value, static_cast<const byte *>(data) + index * sizeof(T), sizeof(T));
+		return value;
+	}
+
+
+	// statistics_columns - inline definitions
+	inline function_statistics statistics_columns::at(unsigned int index) const throw()
+	{
+		return function_statistics(times_called[index], max_reentrance[index], inclusive_time[index],
+			exclusive_time[index], max_call_time[index]);
+	}
+
+
+	template <typename WriterT, typename IteratorT>
+	inline void write_columnar(WriterT &writer, IteratorT begin, IteratorT end)
+	{
+		using namespace columnar;
+
+		staging_columns functions, edges;
+		std::vector<unsigned int> edge_caller, bucket_function, bucket_index;
+		std::vector<count_t> bucket_hits;
+		unsigned int index = 0;
+
+		for (IteratorT i = begin; i != end; ++i, ++index)
+		{
+			functions.push_back(to_long_address(i->first), i->second);
+			for (typename IteratorT::value_type::second_type::callees_map::const_iterator j = i->second.callees.begin();
+				j != i->second.callees.end(); ++j)
+			{
+				edges.push_back(to_long_address(j->first), j->second);
+				edge_caller.push_back(index);
+			}
+			for (histogram::const_iterator j = i->second.latencies.begin(); j != i->second.latencies.end(); ++j)
+			{
+				bucket_hits.push_back((*j).second);
+				bucket_function.push_back(index);
+				bucket_index.push_back((*j).first);
+			}
+		}
+
+		const unsigned int header[] = {
+			index,
+			static_cast<unsigned int>(edge_caller.size()),
+			static_cast<unsigned int>(bucket_hits.size()),
+			0
+		};
+
+		writer.write(header, sizeof(header));
+		functions.write(writer);
+		edges.write(writer);
+		write_column(writer, edge_caller);
+		write_column(writer, bucket_hits);
+		write_column(writer, bucket_function);
+		write_column(writer, bucket_index);
+	}
+
+	template <typename AddressT>
+	inline void merge_columnar(statistics_map_detailed_t<AddressT> &statistics,
+		typename function_statistics_detailed_t<AddressT>::callees_map *delta, const columnar_update &update)
+	{
+		using namespace columnar;
+
+		const statistics_columns &f = update.functions, &e = update.edges;
+
+		for (unsigned int i = 0, edge = 0, bucket = 0; i != update.function_count; ++i)
+		{
+			const AddressT address = address_at<AddressT>(f, i);
+			const function_statistics s = f.at(i);
+			typename statistics_map_detailed_t<AddressT>::mapped_type &entry = statistics[address];
+			const unsigned int first_edge = edge;
+
+			entry += s;
+			if (delta)
+				(*delta)[address] += s;
+			for (; bucket != update.bucket_count && update.bucket_function[bucket] == i; ++bucket)
+				entry.latencies.add_bucket(update.bucket_index[bucket], update.bucket_hits[bucket]);
+			for (; edge != update.edge_count && update.edge_caller[edge] == i; ++edge)
+				entry.callees[address_at<AddressT>(e, edge)] += e.at(edge);
+			if (edge != first_edge)
+				statistics.entry_updated(address);
+		}
+	}
+}
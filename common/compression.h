@@ -0,0 +1,44 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+namespace micro_profiler
+{
+	// Dependency-free LZ77-family block compression. A block is a sequence of (literal run, back reference) pairs,
+	// each led by a token byte holding 4-bit literal and match lengths (longer ones are continued with 255-valued
+	// bytes), followed by the literals and a 16-bit little-endian offset. The final pair has no back reference.
+	// The uncompressed size is not stored - it must be transferred alongside.
+
+	// Returns the worst-case size of a compressed block for the specified input size.
+	size_t compress_bound(size_t size) throw();
+
+	// Compresses the data into 'to', which must be at least compress_bound(size) long. Returns the block size.
+	size_t compress(byte *to, const byte *from, size_t size) throw();
+
+	// Returns false if the block is malformed or does not decompress into exactly 'to_size' bytes.
+	bool decompress(byte *to, size_t to_size, const byte *from, size_t from_size) throw();
+
+	// Retrieves the first byte the block decompresses into, without decompressing the rest. Returns false if the
+	// block is empty or malformed.
+	bool decompress_first(byte &first, const byte *from, size_t from_size) throw();
+}
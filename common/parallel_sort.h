@@ -0,0 +1,95 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <wpl/mt/thread.h>
+
+namespace micro_profiler
+{
+	// Returns the number of logical processors available to the process.
+	unsigned int hardware_threads();
+
+	// Sorts [begin, end) with 'less' like std::sort does. Ranges of at least 'threshold' elements are split into
+	// 'workers' chunks sorted concurrently, which are then merged pairwise (the merges of a level run concurrently too).
+	// 'less' is called from several threads at once, so it must not touch shared mutable state.
+	template <typename IteratorT, typename LessT>
+	void parallel_sort(IteratorT begin, IteratorT end, LessT less, size_t threshold, size_t workers);
+
+
+
+	namespace parallel_sort_impl
+	{
+		template <typename IteratorT, typename LessT>
+		inline void sort(IteratorT begin, IteratorT end, LessT less)
+		{	std::sort(begin, end, less);	}
+
+		template <typename IteratorT, typename LessT>
+		inline void merge(IteratorT begin, IteratorT middle, IteratorT end, LessT less)
+		{	std::inplace_merge(begin, middle, end, less);	}
+
+		inline void run(const std::vector< std::function<void ()> > &tasks)
+		{
+			std::vector< std::shared_ptr<wpl::mt::thread> > threads;
+
+			for (size_t i = 1; i < tasks.size(); ++i)
+				threads.push_back(std::shared_ptr<wpl::mt::thread>(new wpl::mt::thread(tasks[i])));
+			if (!tasks.empty())
+				tasks[0]();
+			for (size_t i = 0; i != threads.size(); ++i)
+				threads[i]->join();
+		}
+	}
+
+	template <typename IteratorT, typename LessT>
+	inline void parallel_sort(IteratorT begin, IteratorT end, LessT less, size_t threshold, size_t workers)
+	{
+		const size_t n = end - begin;
+
+		if (n < threshold || workers < 2)
+		{
+			std::sort(begin, end, less);
+			return;
+		}
+
+		std::vector<IteratorT> bounds;
+		std::vector< std::function<void ()> > tasks;
+
+		for (size_t i = 0; i <= workers; ++i)
+			bounds.push_back(begin + n * i / workers);
+		for (size_t i = 0; i != workers; ++i)
+			tasks.push_back(std::bind(&parallel_sort_impl::sort<IteratorT, LessT>, bounds[i], bounds[i + 1], less));
+		parallel_sort_impl::run(tasks);
+		for (size_t width = 1; width < workers; width *= 2)
+		{
+			tasks.clear();
+			for (size_t i = 0; i + width < workers; i += 2 * width)
+			{
+				tasks.push_back(std::bind(&parallel_sort_impl::merge<IteratorT, LessT>, bounds[i], bounds[i + width],
+					bounds[std::min(i + 2 * width, workers)], less));
+			}
+			parallel_sort_impl::run(tasks);
+		}
+	}
+}
@@ -37,8 +37,10 @@ namespace micro_profiler
 		void push_back(const T &element) throw();
 		template <typename InputIterator>
 		void append(InputIterator b, InputIterator e) throw();
+		void resize(size_t new_size) throw();
 		void clear() throw();
 
+		T *data() throw();
 		const T *data() const throw();
 		size_t size() const throw();
 		size_t byte_size() const throw();
@@ -96,10 +98,22 @@ namespace micro_profiler
 			*_end = *b;
 	}
 
+	template <typename T>
+	inline void pod_vector<T>::resize(size_t new_size) throw()
+	{
+		if (new_size > capacity() && !grow(new_size - capacity()))
+			return;
+		_end = _begin + new_size;
+	}
+
 	template <typename T>
 	inline void pod_vector<T>::clear() throw()
 	{	_end = _begin;	}
 
+	template <typename T>
+	inline T *pod_vector<T>::data() throw()
+	{	return _begin;	}
+
 	template <typename T>
 	inline const T *pod_vector<T>::data() const throw()
 	{	return _begin;	}
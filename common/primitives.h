@@ -20,7 +20,11 @@
 
 #pragma once
 
+#include "small_map.h"
+
+#include <iterator>
 #include <unordered_map>
+#include <vector>
 #include <wpl/base/signals.h>
 
 namespace micro_profiler
@@ -35,9 +39,18 @@ namespace micro_profiler
 	{
 		timestamp_t timestamp;
 		const void *callee;	// call address + sizeof(void *) + 1 bytes
+#if defined(MP_RECORD_STACK_POINTERS)
+		const void *stack_ptr;	// location of the instrumented function's return address (zero, if not recorded)
+#endif
 	};
 #pragma pack(pop)
 
+	// Stack pointers let shadow stacks drop the frames left by exceptions/longjmp, but grow each record from 16 to
+	// 24 bytes (12 to 16 bytes on x86). They are recorded only when MP_RECORD_STACK_POINTERS is defined for both
+	// the compiler and the assembler; otherwise the accessors below read zero and ignore writes.
+	const void *stack_pointer(const call_record &record) throw();
+	void set_stack_pointer(call_record &record, const void *stack_ptr) throw();
+
 	struct address_compare
 	{
 		size_t operator ()(unsigned int key) const throw();
@@ -60,14 +73,81 @@ namespace micro_profiler
 		timestamp_t max_call_time;
 	};
 
+	// Log-linear histogram of call times: values below 8 ticks are counted exactly, while every power-of-two
+	// octave above is split into 8 linear sub-buckets. Bucket boundaries are fixed, so histograms are merged by
+	// adding counters bucketwise. Storage covers only the range of buckets hit so far.
+	class histogram
+	{
+	public:
+		class const_iterator;
+		typedef std::pair<unsigned int /*bucket index*/, count_t> value_type;
+
+		enum {
+			precision_bits = 3,
+			buckets_per_octave = 1 << precision_bits,
+			max_buckets = (62 - precision_bits + 2) * buckets_per_octave,
+		};
+
+	public:
+		histogram();
+
+		void add(timestamp_t value, count_t times = 1);
+		void add_bucket(unsigned int index, count_t count);
+		void operator +=(const histogram &rhs);
+		void clear() throw();
+
+		count_t total() const throw();
+		timestamp_t percentile(double p) const throw();
+
+		size_t size() const throw();
+		const_iterator begin() const throw();
+		const_iterator end() const throw();
+
+		static unsigned int bucket_index(timestamp_t value) throw();
+		static timestamp_t bucket_upper_bound(unsigned int index) throw();
+
+	private:
+		unsigned int _offset;
+		std::vector<count_t> _buckets;
+		count_t _total;
+		size_t _nonempty;
+	};
+
+	class histogram::const_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef histogram::value_type value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const value_type *pointer;
+		typedef const value_type &reference;
+
+	public:
+		const_iterator(unsigned int offset, const count_t *current, const count_t *end);
+
+		value_type operator *() const;
+		const_iterator &operator ++();
+		bool operator ==(const const_iterator &rhs) const;
+		bool operator !=(const const_iterator &rhs) const;
+
+	private:
+		void skip_empty();
+
+	private:
+		unsigned int _index;
+		const count_t *_current, *_end;
+	};
+
+	// Most functions call only a couple of others, so callees are kept inline up to small_map's default capacity.
+	// Callers are not stored: a parents view builds its own callers_map from the callees of all entries.
 	template <typename AddressT>
 	struct function_statistics_detailed_t : function_statistics
 	{
-		typedef std::unordered_map<AddressT, function_statistics, address_compare> callees_map;
+		typedef small_map<AddressT, function_statistics, address_compare> callees_map;
 		typedef std::unordered_map<AddressT, count_t, address_compare> callers_map;
 
 		callees_map callees;
-		callers_map callers;
+		histogram latencies;
 	};
 
 	template <typename AddressT>
@@ -76,6 +156,38 @@ namespace micro_profiler
 		wpl::signal<void (AddressT updated_function)> entry_updated;
 	};
 
+	// Cumulative statistics being updated along with the map receiving the flat per-function delta of the update.
+	template <typename AddressT>
+	struct statistics_update_t
+	{
+		statistics_map_detailed_t<AddressT> &statistics;
+		typename function_statistics_detailed_t<AddressT>::callees_map &delta;
+	};
+
+	// Deserialization target for statistics saved before latency histograms were introduced (no histograms follow
+	// the callees).
+	template <typename AddressT>
+	struct statistics_without_latencies_t
+	{
+		statistics_map_detailed_t<AddressT> &statistics;
+	};
+
+
+
+	// call_record - inline definitions
+#if defined(MP_RECORD_STACK_POINTERS)
+	inline const void *stack_pointer(const call_record &record) throw()
+	{	return record.stack_ptr;	}
+
+	inline void set_stack_pointer(call_record &record, const void *stack_ptr) throw()
+	{	record.stack_ptr = stack_ptr;	}
+#else
+	inline const void *stack_pointer(const call_record &/*record*/) throw()
+	{	return 0;	}
+
+	inline void set_stack_pointer(call_record &/*record*/, const void * /*stack_ptr*/) throw()
+	{	}
+#endif
 
 
 	// address_compare - inline definitions
@@ -118,15 +230,147 @@ namespace micro_profiler
 	}
 
 
+	// histogram - inline definitions
+	inline histogram::histogram()
+		: _offset(0), _total(0), _nonempty(0)
+	{	}
+
+	inline void histogram::add(timestamp_t value, count_t times)
+	{	add_bucket(bucket_index(value), times);	}
+
+	inline void histogram::add_bucket(unsigned int index, count_t count)
+	{
+		if (!count || index >= max_buckets)
+			return;
+		if (_buckets.empty())
+			_offset = index;
+		if (index < _offset)
+			_buckets.insert(_buckets.begin(), _offset - index, 0), _offset = index;
+		if (index - _offset >= _buckets.size())
+			_buckets.resize(index - _offset + 1);
+
+		count_t &bucket = _buckets[index - _offset];
+
+		_nonempty += !bucket;
+		bucket += count;
+		_total += count;
+	}
+
+	inline void histogram::operator +=(const histogram &rhs)
+	{
+		for (const_iterator i = rhs.begin(), e = rhs.end(); i != e; ++i)
+			add_bucket((*i).first, (*i).second);
+	}
+
+	inline void histogram::clear() throw()
+	{
+		_buckets.clear();
+		_offset = 0;
+		_total = 0;
+		_nonempty = 0;
+	}
+
+	inline count_t histogram::total() const throw()
+	{	return _total;	}
+
+	inline timestamp_t histogram::percentile(double p) const throw()
+	{
+		if (!_total)
+			return 0;
+
+		count_t rank = static_cast<count_t>(p * _total);
+
+		rank += rank < p * _total || !rank;
+		for (size_t i = 0; i != _buckets.size(); ++i)
+		{
+			if (rank <= _buckets[i])
+				return bucket_upper_bound(_offset + static_cast<unsigned int>(i));
+			rank -= _buckets[i];
+		}
+		return bucket_upper_bound(_offset + static_cast<unsigned int>(_buckets.size()) - 1);
+	}
+
+	inline size_t histogram::size() const throw()
+	{	return _nonempty;	}
+
+	inline histogram::const_iterator histogram::begin() const throw()
+	{
+		return _buckets.empty() ? end()
+			: const_iterator(_offset, &_buckets[0], &_buckets[0] + _buckets.size());
+	}
+
+	inline histogram::const_iterator histogram::end() const throw()
+	{	return const_iterator(0, 0, 0);	}
+
+	inline unsigned int histogram::bucket_index(timestamp_t value) throw()
+	{
+		if (value < buckets_per_octave)
+			return value > 0 ? static_cast<unsigned int>(value) : 0;
+
+		unsigned long long v = static_cast<unsigned long long>(value);
+		unsigned int msb = 0;
+
+		for (unsigned int step = 32; step; step >>= 1)
+		{
+			if (v >> (msb + step))
+				msb += step;
+		}
+		return (msb - precision_bits + 1) * buckets_per_octave
+			+ static_cast<unsigned int>((v >> (msb - precision_bits)) & (buckets_per_octave - 1));
+	}
+
+	inline timestamp_t histogram::bucket_upper_bound(unsigned int index) throw()
+	{
+		if (index < buckets_per_octave)
+			return index;
+
+		const unsigned int shift = index / buckets_per_octave - 1;
+		const unsigned long long lower = static_cast<unsigned long long>(buckets_per_octave
+			+ index % buckets_per_octave) << shift;
+
+		return static_cast<timestamp_t>(lower + (1ull << shift) - 1);
+	}
+
+
+	// histogram::const_iterator - inline definitions
+	inline histogram::const_iterator::const_iterator(unsigned int offset, const count_t *current, const count_t *end)
+		: _index(offset), _current(current), _end(end)
+	{	skip_empty();	}
+
+	inline histogram::value_type histogram::const_iterator::operator *() const
+	{	return std::make_pair(_index, *_current);	}
+
+	inline histogram::const_iterator &histogram::const_iterator::operator ++()
+	{
+		++_index, ++_current;
+		skip_empty();
+		return *this;
+	}
+
+	inline bool histogram::const_iterator::operator ==(const const_iterator &rhs) const
+	{	return _current == rhs._current;	}
+
+	inline bool histogram::const_iterator::operator !=(const const_iterator &rhs) const
+	{	return _current != rhs._current;	}
+
+	inline void histogram::const_iterator::skip_empty()
+	{
+		while (_current != _end && !*_current)
+			++_index, ++_current;
+		if (_current == _end)
+			_current = 0;
+	}
+
+
 	// helper methods - inline definitions
+	inline void add_latency(function_statistics &/*s*/, timestamp_t /*inclusive_time*/)
+	{	}
+
+	template <typename AddressT>
+	inline void add_latency(function_statistics_detailed_t<AddressT> &s, timestamp_t inclusive_time)
+	{	s.latencies.add(inclusive_time);	}
+
 	template <typename AddressT>
 	inline void add_child_statistics(function_statistics_detailed_t<AddressT> &s, AddressT function, unsigned int level, timestamp_t inclusive_time, timestamp_t exclusive_time)
 	{	s.callees[function].add_call(level, inclusive_time, exclusive_time);	}
-
-	template <typename AddressT, typename AddressCompareT>
-	inline void update_parent_statistics(std::unordered_map<AddressT, function_statistics_detailed_t<AddressT>, AddressCompareT> &s, AddressT address, const function_statistics_detailed_t<AddressT> &f)
-	{
-		for (typename function_statistics_detailed_t<AddressT>::callees_map::const_iterator i = f.callees.begin(); i != f.callees.end(); ++i)
-			s[i->first].callers[address] = i->second.times_called;
-	}
 }
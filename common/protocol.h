@@ -31,13 +31,28 @@ namespace micro_profiler
 		init,
 		modules_loaded,
 		update_statistics,
-		modules_unloaded
+		modules_unloaded,
+		update_call_paths,
+		compressed,	// Wraps another message: its uncompressed size followed by its LZ-compressed block.
+		register_addresses	// Assigns the next consecutive ids to the listed addresses (update_format_indexed).
+	};
+
+	// The largest message that may be sent compressed. Receivers reject compressed messages claiming more, as well
+	// as compressed messages nested into compressed ones.
+	const unsigned int c_max_uncompressed_size = 64 * 1024 * 1024;
+
+	// Layout of update_statistics payloads, announced by the collector in initialization_data.
+	enum update_formats {
+		update_format_varint,
+		update_format_columnar,
+		update_format_indexed	// As varint, but with function addresses replaced by ids from register_addresses.
 	};
 
 	struct initialization_data
 	{
 		std::wstring executable;
 		timestamp_t ticks_per_second;
+		update_formats statistics_format;
 	};
 
 	struct module_info
@@ -48,4 +63,6 @@ namespace micro_profiler
 	typedef std::vector<module_info> loaded_modules;
 
 	typedef std::vector<long_address_t> unloaded_modules;
+
+	typedef std::vector<long_address_t> registered_addresses;
 }
@@ -0,0 +1,101 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+#include <vector>
+
+namespace micro_profiler
+{
+	// A raw trace segment holds call records of a single thread in the order they were read from the collector. It
+	// starts with a raw_trace_header, followed by 'size' bytes of packed records. Each record is three LEB128
+	// varints: the zigzag-encoded timestamp delta from the previous record; zero for an exit, or the zigzag-encoded
+	// delta of the callee from the previous entry's callee plus one; the zigzag-encoded stack pointer delta from the
+	// previous record. Deltas of a segment's first record are taken from zeroes, so each segment decodes on its own.
+	enum {
+		raw_trace_signature = 0x5254504D,	// 'MPTR'
+		max_packed_call_record_size = 3 * 10,
+	};
+
+	struct raw_trace_header
+	{
+		unsigned int signature;
+		unsigned int threadid;
+		unsigned long long size;
+		unsigned long long records;
+		timestamp_t first_timestamp, last_timestamp;
+	};
+
+	// The index of a raw trace recording starts with this header, followed by a raw_trace_index_entry for each
+	// segment opened.
+	struct raw_trace_index_header
+	{
+		unsigned int signature;
+		unsigned int reserved;
+		timestamp_t ticks_per_second;
+		timestamp_t profiler_latency;
+	};
+
+	// Describes a segment in the index of a raw trace recording. The record count and time range are filled in when
+	// the segment is closed - for a segment that was not (the recording process was terminated), they are zero and
+	// the segment's own header has them.
+	struct raw_trace_index_entry
+	{
+		unsigned int threadid;
+		unsigned int segment;
+		unsigned long long records;
+		timestamp_t first_timestamp, last_timestamp;
+	};
+
+	class raw_trace_encoder
+	{
+	public:
+		raw_trace_encoder();
+
+		// Packs the records into 'to', which must hold at least count * max_packed_call_record_size bytes. Returns the
+		// number of bytes written.
+		size_t encode(byte *to, const call_record *calls, size_t count) throw();
+
+		// Starts a new segment.
+		void reset() throw();
+
+	private:
+		timestamp_t _timestamp;
+		long_address_t _callee, _stack_ptr;
+	};
+
+	class raw_trace_decoder
+	{
+	public:
+		raw_trace_decoder();
+
+		// Unpacks the records, appending them to 'calls'. Returns false if the data is truncated or malformed.
+		bool decode(std::vector<call_record> &calls, const void *data, size_t size);
+
+		// Starts a new segment.
+		void reset() throw();
+
+	private:
+		timestamp_t _timestamp;
+		long_address_t _callee, _stack_ptr;
+	};
+}
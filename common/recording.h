@@ -0,0 +1,72 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "call_paths.h"
+#include "primitives.h"
+#include "types.h"
+
+#include <functional>
+#include <vector>
+
+namespace micro_profiler
+{
+	// A recording stores the messages a collector sends to its frontend, so that they can be loaded later. Each
+	// message is framed by its 32-bit little-endian size. A recording is split into segments: once the current one
+	// reaches the segment limit, the next message starts a new segment. Each segment opens with the state the
+	// messages in it rely on, so that it remains loadable on its own: copies of the init, modules_loaded,
+	// modules_unloaded and register_addresses messages written so far (compressed ones are looked into), followed by
+	// a single update_call_paths message with all the call path nodes received so far and no times.
+	class recording_writer
+	{
+	public:
+		typedef std::function<void (unsigned int segment, const void *buffer, size_t size)> sink_t;
+
+	public:
+		// A zero segment_limit makes a recording of a single segment.
+		recording_writer(const sink_t &sink, size_t segment_limit);
+
+		void write(const void *message, size_t size);
+
+	private:
+		recording_writer(const recording_writer &other);
+		void operator =(const recording_writer &rhs);
+
+		void write_head();
+		void write_frame(const void *message, size_t size);
+		void track_state(const byte *message, size_t size);
+		void keep_state(const byte *message, size_t size);
+
+	private:
+		const sink_t _sink;
+		const size_t _segment_limit;
+		std::vector<byte> _state_messages;
+		call_paths _paths;
+		unsigned int _segment;
+		size_t _segment_size;
+	};
+
+
+	// Passes the messages of a recording segment to the channel in order. Returns false if the channel refuses a
+	// message or the last frame is truncated (e.g., the collector was terminated while writing). The frontend opens a
+	// segment with load_recording() (see frontend/message_processor.h).
+	bool read_recording(const channel_t &channel, const void *data, size_t size);
+}
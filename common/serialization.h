@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "address_dictionary.h"
+#include "call_paths.h"
 #include "protocol.h"
 
 #include <strmd/deserializer.h>
@@ -35,11 +37,21 @@ namespace strmd
 	using namespace std;
 
 	template <> struct is_container<analyzer> { static const bool value = true; };
+	template <typename AddressT> struct is_container< address_index<AddressT> > { static const bool value = true; };
+	template <> struct is_container<call_paths::pending_nodes> { static const bool value = true; };
+	template <> struct is_container<call_paths::pending_times> { static const bool value = true; };
+	template <> struct is_container<histogram> { static const bool value = true; };
 	template <typename AddressT> struct is_container< statistics_map_detailed_t<AddressT> > { static const bool value = true; };
+	template <typename AddressT> struct is_container< statistics_update_t<AddressT> > { static const bool value = true; };
+	template <typename AddressT>
+	struct is_container< statistics_without_latencies_t<AddressT> > { static const bool value = true; };
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	struct is_container< small_map<KeyT, ValueT, HashT, inline_capacity> > { static const bool value = true; };
 
-	template <typename AddressT> struct container_reader< unordered_map<AddressT, function_statistics, address_compare> >
+	template <typename AddressT, size_t inline_capacity>
+	struct container_reader< small_map<AddressT, function_statistics, address_compare, inline_capacity> >
 	{
-		typedef unordered_map<AddressT, function_statistics, address_compare> data_t;
+		typedef small_map<AddressT, function_statistics, address_compare, inline_capacity> data_t;
 
 		template <typename ArchiveT>
 		void operator()(ArchiveT &archive, size_t count, data_t &data)
@@ -54,12 +66,77 @@ namespace strmd
 		}
 	};
 
+	template <typename AddressT> struct container_reader< address_index<AddressT> >
+	{
+		template <typename ArchiveT>
+		void operator()(ArchiveT &archive, size_t count, address_index<AddressT> &data)
+		{
+			long_address_t address;
+
+			while (count--)
+			{
+				archive(address);
+				data.append(address);
+			}
+		}
+	};
+
+	template <> struct container_reader<histogram>
+	{
+		template <typename ArchiveT>
+		void operator()(ArchiveT &archive, size_t count, histogram &data)
+		{
+			histogram::value_type bucket;
+
+			while (count--)
+			{
+				archive(bucket);
+				data.add_bucket(bucket.first, bucket.second);
+			}
+		}
+	};
+
+	template <> struct container_reader<call_paths::pending_nodes>
+	{
+		template <typename ArchiveT>
+		void operator()(ArchiveT &archive, size_t count, call_paths::pending_nodes &data)
+		{
+			call_paths::node n;
+
+			while (count--)
+			{
+				archive(n);
+				data.append(n);
+			}
+		}
+	};
+
+	template <> struct container_reader<call_paths::pending_times>
+	{
+		template <typename ArchiveT>
+		void operator()(ArchiveT &archive, size_t count, call_paths::pending_times &data)
+		{
+			call_paths::pending_times::value_type time;
+
+			while (count--)
+			{
+				archive(time);
+				data.append(time);
+			}
+		}
+	};
+
 	template <typename AddressT> struct container_reader< statistics_map_detailed_t<AddressT> >
 	{
 		typedef statistics_map_detailed_t<AddressT> data_t;
 
 		template <typename ArchiveT>
 		void operator()(ArchiveT &archive, size_t count, data_t &data)
+		{	read(archive, count, data, 0, true);	}
+
+		template <typename ArchiveT>
+		static void read(ArchiveT &archive, size_t count, data_t &data,
+			typename function_statistics_detailed_t<AddressT>::callees_map *delta, bool latencies)
 		{
 			pair<typename data_t::key_type, function_statistics> value;
 
@@ -68,15 +145,36 @@ namespace strmd
 				archive(value);
 				typename data_t::mapped_type &entry = data[value.first];
 				entry += value.second;
-				if (archive.process_container(entry.callees))
-				{
-					update_parent_statistics(data, value.first, entry);
+				if (delta)
+					(*delta)[value.first] += value.second;
+
+				const bool has_callees = archive.process_container(entry.callees);
+
+				if (latencies)
+					archive(entry.latencies);
+				if (has_callees)
 					data.entry_updated(value.first);
-				}
 			}
 		}
 	};
 
+	template <typename AddressT> struct container_reader< statistics_update_t<AddressT> >
+	{
+		template <typename ArchiveT>
+		void operator()(ArchiveT &archive, size_t count, statistics_update_t<AddressT> &data)
+		{
+			container_reader< statistics_map_detailed_t<AddressT> >::read(archive, count, data.statistics, &data.delta,
+				true);
+		}
+	};
+
+	template <typename AddressT> struct container_reader< statistics_without_latencies_t<AddressT> >
+	{
+		template <typename ArchiveT>
+		void operator()(ArchiveT &archive, size_t count, statistics_without_latencies_t<AddressT> &data)
+		{	container_reader< statistics_map_detailed_t<AddressT> >::read(archive, count, data.statistics, 0, false);	}
+	};
+
 	template <typename ArchiveT>
 	void serialize(ArchiveT &archive, const void *&data)
 	{	archive(reinterpret_cast<uintptr_t &>(data));	}
@@ -91,6 +189,7 @@ namespace micro_profiler
 	{
 		archive(data.executable);
 		archive(data.ticks_per_second);
+		archive(reinterpret_cast<int &>(data.statistics_format));
 	}	
 
 	template <typename ArchiveT>
@@ -108,6 +207,78 @@ namespace micro_profiler
 	{
 		archive(static_cast<function_statistics &>(data));
 		archive(data.callees);
+		archive(data.latencies);
+	}
+
+	template <typename ArchiveT, typename ContainerT>
+	void serialize(ArchiveT &archive, indexed_statistics_t<ContainerT> &data)
+	{
+		typedef typename ContainerT::const_iterator::value_type::second_type::callees_map callees_map;
+
+		unsigned int count = static_cast<unsigned int>(data.statistics.size()), id;
+
+		archive(count);
+		for (typename ContainerT::const_iterator i = data.statistics.begin(); i != data.statistics.end(); ++i)
+		{
+			id = data.dictionary[i->first];
+			count = static_cast<unsigned int>(i->second.callees.size());
+			archive(id);
+			archive(static_cast<const function_statistics &>(i->second));
+			archive(count);
+			for (typename callees_map::const_iterator j = i->second.callees.begin(); j != i->second.callees.end(); ++j)
+			{
+				id = data.dictionary[j->first];
+				archive(id);
+				archive(j->second);
+			}
+			archive(i->second.latencies);
+		}
+	}
+
+	template <typename ArchiveT, typename AddressT>
+	void serialize(ArchiveT &archive, indexed_update_t<AddressT> &data)
+	{
+		unsigned int count, callees_count, id, callee_id;
+		function_statistics value;
+
+		archive(count);
+		while (count--)
+		{
+			archive(id);
+			archive(value);
+
+			typename address_index<AddressT>::entry_type &entry = data.index.entry(data.statistics, id);
+
+			entry += value;
+			data.delta[data.index[id]] += value;
+			archive(callees_count);
+			for (unsigned int n = callees_count; n; --n)
+			{
+				archive(callee_id);
+				archive(value);
+				entry.callees[data.index[callee_id]] += value;
+			}
+			archive(entry.latencies);
+			if (callees_count)
+				data.statistics.entry_updated(data.index[id]);
+		}
+	}
+
+	template <typename ArchiveT>
+	void serialize(ArchiveT &archive, call_paths::node &data)
+	{
+		archive(data.parent);
+		archive(data.function);
+	}
+
+	template <typename ArchiveT>
+	void serialize(ArchiveT &archive, call_paths &data)
+	{
+		call_paths::pending_nodes nodes(data);
+		call_paths::pending_times times(data);
+
+		archive(nodes);
+		archive(times);
 	}
 
 	template <typename ArchiveT>
@@ -0,0 +1,350 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace micro_profiler
+{
+	// An associative container for small mappings (like call graph edges). Up to 'inline_capacity' entries are kept
+	// sorted by key in an array embedded into the object, so no allocations happen for them. Past that threshold the
+	// entries are moved to a heap array indexed by an open-addressing hash table (holding positions plus one, zero marks
+	// a free slot). Iterators are plain pointers and are invalidated by insertions and erasures. Keys must not be modified
+	// through iterators.
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity = 2>
+	class small_map
+	{
+	public:
+		typedef KeyT key_type;
+		typedef ValueT mapped_type;
+		typedef std::pair<KeyT, ValueT> value_type;
+		typedef value_type *iterator;
+		typedef const value_type *const_iterator;
+
+	public:
+		small_map();
+		small_map(const small_map &other);
+		~small_map();
+
+		const small_map &operator =(const small_map &rhs);
+
+		mapped_type &operator [](const key_type &key);
+		iterator find(const key_type &key);
+		const_iterator find(const key_type &key) const;
+		size_t erase(const key_type &key);
+		void clear();
+		void swap(small_map &other);
+
+		iterator begin();
+		iterator end();
+		const_iterator begin() const;
+		const_iterator end() const;
+		size_t size() const throw();
+		bool empty() const throw();
+
+	private:
+		struct key_less;
+
+		union inline_storage
+		{
+			char bytes[inline_capacity * sizeof(value_type)];
+			long long _unused1;
+			double _unused2;
+			void *_unused3;
+		};
+
+	private:
+		value_type *inline_data() const throw();
+		void assign_inline(const small_map &from);
+		void destroy_inline() throw();
+		void spill();
+		void rehash(size_t slots);
+		size_t find_slot(const key_type &key) const;
+
+	private:
+		inline_storage _inline;
+		size_t _inline_size;
+		std::vector<value_type> _spilled;
+		std::vector<unsigned int> _index;
+	};
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	struct small_map<KeyT, ValueT, HashT, inline_capacity>::key_less
+	{
+		bool operator ()(const value_type &lhs, const key_type &rhs) const
+		{	return std::less<key_type>()(lhs.first, rhs);	}
+
+		bool operator ()(const key_type &lhs, const value_type &rhs) const
+		{	return std::less<key_type>()(lhs, rhs.first);	}
+
+		bool operator ()(const value_type &lhs, const value_type &rhs) const
+		{	return std::less<key_type>()(lhs.first, rhs.first);	}
+	};
+
+
+
+	// small_map - inline definitions
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline small_map<KeyT, ValueT, HashT, inline_capacity>::small_map()
+		: _inline_size(0)
+	{	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline small_map<KeyT, ValueT, HashT, inline_capacity>::small_map(const small_map &other)
+		: _inline_size(0), _spilled(other._spilled), _index(other._index)
+	{	assign_inline(other);	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline small_map<KeyT, ValueT, HashT, inline_capacity>::~small_map()
+	{	destroy_inline();	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline const small_map<KeyT, ValueT, HashT, inline_capacity> &small_map<KeyT, ValueT, HashT, inline_capacity>::operator =(
+		const small_map &rhs)
+	{
+		if (this != &rhs)
+		{
+			assign_inline(rhs);
+			_spilled = rhs._spilled;
+			_index = rhs._index;
+		}
+		return *this;
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline ValueT &small_map<KeyT, ValueT, HashT, inline_capacity>::operator [](const key_type &key)
+	{
+		if (_spilled.empty())
+		{
+			value_type * const b = inline_data(), * const e = b + _inline_size;
+			value_type * const p = std::lower_bound(b, e, key, key_less());
+
+			if (p != e && p->first == key)
+				return p->second;
+			if (_inline_size < inline_capacity)
+			{
+				if (p == e)
+				{
+					new (e) value_type(key, mapped_type());
+				}
+				else
+				{
+					new (e) value_type(*(e - 1));
+					std::copy_backward(p, e - 1, e);
+					*p = value_type(key, mapped_type());
+				}
+				++_inline_size;
+				return p->second;
+			}
+			spill();
+		}
+
+		size_t slot = find_slot(key);
+
+		if (_index[slot])
+			return _spilled[_index[slot] - 1].second;
+		if (2 * (_spilled.size() + 1) > _index.size())
+		{
+			rehash(2 * _index.size());
+			slot = find_slot(key);
+		}
+		_spilled.push_back(value_type(key, mapped_type()));
+		_index[slot] = static_cast<unsigned int>(_spilled.size());
+		return _spilled.back().second;
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::iterator small_map<KeyT, ValueT, HashT, inline_capacity>::find(
+		const key_type &key)
+	{
+		const const_iterator i = static_cast<const small_map &>(*this).find(key);
+
+		return const_cast<iterator>(i);
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::const_iterator small_map<KeyT, ValueT, HashT, inline_capacity>::find(
+		const key_type &key) const
+	{
+		if (_spilled.empty())
+		{
+			const value_type * const b = inline_data(), * const e = b + _inline_size;
+			const value_type * const p = std::lower_bound(b, e, key, key_less());
+
+			return p != e && p->first == key ? p : e;
+		}
+		else
+		{
+			const unsigned int index = _index[find_slot(key)];
+
+			return index ? &_spilled[index - 1] : end();
+		}
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline size_t small_map<KeyT, ValueT, HashT, inline_capacity>::erase(const key_type &key)
+	{
+		if (_spilled.empty())
+		{
+			value_type * const b = inline_data(), * const e = b + _inline_size;
+			value_type * const p = std::lower_bound(b, e, key, key_less());
+
+			if (p == e || !(p->first == key))
+				return 0;
+			std::copy(p + 1, e, p);
+			(e - 1)->~value_type();
+			--_inline_size;
+			return 1;
+		}
+
+		const size_t mask = _index.size() - 1;
+		size_t hole = find_slot(key);
+
+		if (!_index[hole])
+			return 0;
+
+		const unsigned int position = _index[hole] - 1, last = static_cast<unsigned int>(_spilled.size() - 1);
+
+		if (position != last)
+		{
+			_index[find_slot(_spilled[last].first)] = position + 1;
+			_spilled[position] = _spilled[last];
+		}
+		_spilled.pop_back();
+
+		// Backward-shift deletion: pull up the entries of the probe run that may take the hole.
+		for (size_t slot = (hole + 1) & mask; _index[slot]; slot = (slot + 1) & mask)
+		{
+			const size_t home = HashT()(_spilled[_index[slot] - 1].first) & mask;
+
+			if (((slot - home) & mask) >= ((slot - hole) & mask))
+				_index[hole] = _index[slot], hole = slot;
+		}
+		_index[hole] = 0;
+		if (_spilled.empty())
+			std::vector<unsigned int>().swap(_index);
+		return 1;
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline void small_map<KeyT, ValueT, HashT, inline_capacity>::clear()
+	{
+		destroy_inline();
+		std::vector<value_type>().swap(_spilled);
+		std::vector<unsigned int>().swap(_index);
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline void small_map<KeyT, ValueT, HashT, inline_capacity>::swap(small_map &other)
+	{
+		small_map inline_part;
+
+		inline_part.assign_inline(*this);
+		assign_inline(other);
+		other.assign_inline(inline_part);
+		_spilled.swap(other._spilled);
+		_index.swap(other._index);
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::iterator small_map<KeyT, ValueT, HashT, inline_capacity>::begin()
+	{	return _spilled.empty() ? inline_data() : &_spilled[0];	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::iterator small_map<KeyT, ValueT, HashT, inline_capacity>::end()
+	{	return begin() + size();	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::const_iterator small_map<KeyT, ValueT, HashT, inline_capacity>::begin() const
+	{	return _spilled.empty() ? inline_data() : &_spilled[0];	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::const_iterator small_map<KeyT, ValueT, HashT, inline_capacity>::end() const
+	{	return begin() + size();	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline size_t small_map<KeyT, ValueT, HashT, inline_capacity>::size() const throw()
+	{	return _spilled.empty() ? _inline_size : _spilled.size();	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline bool small_map<KeyT, ValueT, HashT, inline_capacity>::empty() const throw()
+	{	return !size();	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline typename small_map<KeyT, ValueT, HashT, inline_capacity>::value_type *small_map<KeyT, ValueT, HashT, inline_capacity>::inline_data() const throw()
+	{	return reinterpret_cast<value_type *>(const_cast<char *>(_inline.bytes));	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline void small_map<KeyT, ValueT, HashT, inline_capacity>::assign_inline(const small_map &from)
+	{
+		const value_type *source = from.inline_data();
+		value_type *target = inline_data();
+
+		destroy_inline();
+		for (size_t i = 0; i != from._inline_size; ++i, ++_inline_size)
+			new (target + i) value_type(source[i]);
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline void small_map<KeyT, ValueT, HashT, inline_capacity>::destroy_inline() throw()
+	{
+		for (value_type *i = inline_data(), *e = i + _inline_size; i != e; ++i)
+			i->~value_type();
+		_inline_size = 0;
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline void small_map<KeyT, ValueT, HashT, inline_capacity>::spill()
+	{
+		size_t slots = 4;
+
+		while (slots < 4 * inline_capacity)
+			slots <<= 1;
+		_spilled.reserve(2 * inline_capacity);
+		_spilled.assign(inline_data(), inline_data() + _inline_size);
+		destroy_inline();
+		rehash(slots);
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline void small_map<KeyT, ValueT, HashT, inline_capacity>::rehash(size_t slots)
+	{
+		_index.assign(slots, 0);
+		for (size_t i = 0, count = _spilled.size(); i != count; ++i)
+			_index[find_slot(_spilled[i].first)] = static_cast<unsigned int>(i + 1);
+	}
+
+	template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+	inline size_t small_map<KeyT, ValueT, HashT, inline_capacity>::find_slot(const key_type &key) const
+	{
+		const size_t mask = _index.size() - 1;
+
+		for (size_t slot = HashT()(key) & mask; ; slot = (slot + 1) & mask)
+		{
+			if (!_index[slot] || _spilled[_index[slot] - 1].first == key)
+				return slot;
+		}
+	}
+}
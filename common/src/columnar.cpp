@@ -0,0 +1,74 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <common/columnar.h>
+
+namespace micro_profiler
+{
+	namespace
+	{
+		size_t padded(size_t count)
+		{	return (count + 1) & ~static_cast<size_t>(1);	}
+
+		class column_reader
+		{
+		public:
+			column_reader(const void *data, size_t size)
+				: _ptr(static_cast<const unsigned char *>(data)), _remaining(size)
+			{	}
+
+			template <typename T>
+			bool take(column<T> &column_, size_t count)
+			{
+				if (count > _remaining / sizeof(T))
+					return false;
+				column_.data = _ptr;
+				_ptr += count * sizeof(T);
+				_remaining -= count * sizeof(T);
+				return true;
+			}
+
+			bool take(statistics_columns &columns, size_t count)
+			{
+				return take(columns.address, count) && take(columns.times_called, count)
+					&& take(columns.inclusive_time, count) && take(columns.exclusive_time, count)
+					&& take(columns.max_call_time, count) && take(columns.max_reentrance, padded(count));
+			}
+
+		private:
+			const unsigned char *_ptr;
+			size_t _remaining;
+		};
+	}
+
+	bool columnar_update::parse(const void *data, size_t size) throw()
+	{
+		column_reader reader(data, size);
+		column<unsigned int> header;
+
+		if (!reader.take(header, 4))
+			return false;
+		function_count = header[0], edge_count = header[1], bucket_count = header[2];
+		return reader.take(functions, function_count)
+			&& reader.take(edges, edge_count) && reader.take(edge_caller, padded(edge_count))
+			&& reader.take(bucket_hits, bucket_count) && reader.take(bucket_function, padded(bucket_count))
+			&& reader.take(bucket_index, padded(bucket_count));
+	}
+}
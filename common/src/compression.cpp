@@ -0,0 +1,191 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <common/compression.h>
+
+#include <string.h>
+
+namespace micro_profiler
+{
+	namespace
+	{
+		enum {
+			min_match = 4,
+			max_offset = 0xFFFF,
+			hash_bits = 12,
+			skip_trigger = 6,
+		};
+
+		const size_t c_length_mask = 0x0F;
+
+		unsigned int read32(const byte *p) throw()
+		{
+			unsigned int value;
+
+			memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		unsigned int hash(unsigned int value) throw()
+		{	return (value * 2654435761u) >> (32 - hash_bits);	}
+
+		byte *write_length(byte *to, size_t length) throw()
+		{
+			for (; length >= 0xFF; length -= 0xFF)
+				*to++ = 0xFF;
+			*to++ = static_cast<byte>(length);
+			return to;
+		}
+
+		byte *write_sequence(byte *to, const byte *literals, size_t literals_length, size_t offset,
+			size_t match_length) throw()
+		{
+			byte &token = *to++;
+
+			token = static_cast<byte>((literals_length < c_length_mask ? literals_length : c_length_mask) << 4);
+			if (literals_length >= c_length_mask)
+				to = write_length(to, literals_length - c_length_mask);
+			memcpy(to, literals, literals_length);
+			to += literals_length;
+			if (offset)
+			{
+				match_length -= min_match;
+				token |= static_cast<byte>(match_length < c_length_mask ? match_length : c_length_mask);
+				*to++ = static_cast<byte>(offset);
+				*to++ = static_cast<byte>(offset >> 8);
+				if (match_length >= c_length_mask)
+					to = write_length(to, match_length - c_length_mask);
+			}
+			return to;
+		}
+
+		bool read_length(const byte *&from, const byte *end, size_t &length) throw()
+		{
+			if (length == c_length_mask)
+			{
+				byte b;
+
+				do
+				{
+					if (from == end)
+						return false;
+					b = *from++;
+					length += b;
+				} while (b == 0xFF);
+			}
+			return true;
+		}
+	}
+
+	size_t compress_bound(size_t size) throw()
+	{	return size + size / 0xFF + 16;	}
+
+	size_t compress(byte *to, const byte *from, size_t size) throw()
+	{
+		unsigned int table[1 << hash_bits] = { };
+		const byte *i = from, *anchor = from, *const end = from + size;
+		const byte *const match_limit = size > min_match ? end - min_match : from;
+		byte *o = to;
+
+		while (i < match_limit)
+		{
+			const unsigned int value = read32(i);
+			unsigned int &slot = table[hash(value)];
+			const byte *candidate = from + slot;
+
+			slot = static_cast<unsigned int>(i - from);
+			if (candidate < i && i - candidate <= max_offset && read32(candidate) == value)
+			{
+				const byte *match = candidate + min_match, *match_end = i + min_match;
+
+				for (; match_end < end && *match_end == *match; ++match_end, ++match)
+				{	}
+				o = write_sequence(o, anchor, i - anchor, i - candidate, match_end - i);
+				i = anchor = match_end;
+			}
+			else
+			{
+				// Step over incompressible data faster the longer the current literal run is.
+				i += 1 + ((i - anchor) >> skip_trigger);
+			}
+		}
+		return write_sequence(o, anchor, end - anchor, 0, 0) - to;
+	}
+
+	bool decompress(byte *to, size_t to_size, const byte *from, size_t from_size) throw()
+	{
+		const byte *i = from, *const end = from + from_size;
+		byte *o = to, *const to_end = to + to_size;
+
+		while (i != end)
+		{
+			const byte token = *i++;
+			size_t length = token >> 4;
+
+			if (!read_length(i, end, length) || length > static_cast<size_t>(end - i)
+				|| length > static_cast<size_t>(to_end - o))
+			{
+				return false;
+			}
+			memcpy(o, i, length);
+			o += length;
+			i += length;
+			if (i == end)
+				return o == to_end;
+			if (end - i < 2)
+				return false;
+
+			const size_t offset = i[0] | (i[1] << 8);
+
+			i += 2;
+			length = token & c_length_mask;
+			if (!offset || offset > static_cast<size_t>(o - to) || !read_length(i, end, length)
+				|| (length += min_match) > static_cast<size_t>(to_end - o))
+			{
+				return false;
+			}
+
+			const byte *match = o - offset;
+
+			if (offset >= length)
+				memcpy(o, match, length), o += length;
+			else
+				while (length--)	// An overlapping reference repeats the last 'offset' bytes.
+					*o++ = *match++;
+		}
+		return false;
+	}
+
+	bool decompress_first(byte &first, const byte *from, size_t from_size) throw()
+	{
+		const byte *i = from, *const end = from + from_size;
+
+		if (i == end)
+			return false;
+
+		size_t length = *i++ >> 4;
+
+		// A block cannot start with a back reference, so its first byte is always the first literal.
+		if (!read_length(i, end, length) || !length || i == end)
+			return false;
+		first = *i;
+		return true;
+	}
+}
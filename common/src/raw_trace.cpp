@@ -0,0 +1,128 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <common/raw_trace.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		inline unsigned long long zigzag(long long value) throw()
+		{	return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);	}
+
+		inline long long unzigzag(unsigned long long value) throw()
+		{	return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);	}
+
+		inline byte *put_varint(byte *to, unsigned long long value) throw()
+		{
+			for (; value >= 0x80; value >>= 7)
+				*to++ = static_cast<byte>(value | 0x80);
+			*to++ = static_cast<byte>(value);
+			return to;
+		}
+
+		inline bool get_varint(unsigned long long &value, const byte *&from, const byte *end) throw()
+		{
+			value = 0;
+			for (unsigned int shift = 0; from != end && shift < 64; shift += 7)
+			{
+				const byte b = *from++;
+
+				value |= static_cast<unsigned long long>(b & 0x7F) << shift;
+				if (!(b & 0x80))
+					return true;
+			}
+			return false;
+		}
+
+		inline long_address_t to_address(const void *ptr) throw()
+		{	return reinterpret_cast<size_t>(ptr);	}
+
+		inline const void *from_address(long_address_t address) throw()
+		{	return reinterpret_cast<const void *>(static_cast<size_t>(address));	}
+	}
+
+	raw_trace_encoder::raw_trace_encoder()
+	{	reset();	}
+
+	size_t raw_trace_encoder::encode(byte *to, const call_record *calls, size_t count) throw()
+	{
+		byte * const start = to;
+
+		for (const call_record *const end = calls + count; calls != end; ++calls)
+		{
+			const long_address_t callee = to_address(calls->callee), stack_ptr = to_address(stack_pointer(*calls));
+
+			to = put_varint(to, zigzag(calls->timestamp - _timestamp));
+			if (callee)
+				to = put_varint(to, zigzag(static_cast<long long>(callee - _callee)) + 1), _callee = callee;
+			else
+				*to++ = 0;
+			to = put_varint(to, zigzag(static_cast<long long>(stack_ptr - _stack_ptr)));
+			_timestamp = calls->timestamp;
+			_stack_ptr = stack_ptr;
+		}
+		return to - start;
+	}
+
+	void raw_trace_encoder::reset() throw()
+	{
+		_timestamp = 0;
+		_callee = _stack_ptr = 0;
+	}
+
+
+	raw_trace_decoder::raw_trace_decoder()
+	{	reset();	}
+
+	bool raw_trace_decoder::decode(vector<call_record> &calls, const void *data, size_t size)
+	{
+		const byte *from = static_cast<const byte *>(data), *const end = from + size;
+
+		while (from != end)
+		{
+			unsigned long long timestamp_delta, callee, stack_delta;
+			call_record record;
+
+			if (!get_varint(timestamp_delta, from, end) || !get_varint(callee, from, end)
+				|| !get_varint(stack_delta, from, end))
+			{
+				return false;
+			}
+			_timestamp += unzigzag(timestamp_delta);
+			if (callee)
+				_callee += unzigzag(callee - 1);
+			_stack_ptr += unzigzag(stack_delta);
+			record.timestamp = _timestamp;
+			record.callee = callee ? from_address(_callee) : 0;
+			set_stack_pointer(record, from_address(_stack_ptr));
+			calls.push_back(record);
+		}
+		return true;
+	}
+
+	void raw_trace_decoder::reset() throw()
+	{
+		_timestamp = 0;
+		_callee = _stack_ptr = 0;
+	}
+}
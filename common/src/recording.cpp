@@ -0,0 +1,221 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <common/recording.h>
+
+#include <common/compression.h>
+#include <common/serialization.h>
+
+#include <stdexcept>
+#include <strmd/serializer.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		enum {	frame_header_size = 4	};
+
+		class buffer_reader
+		{
+		public:
+			buffer_reader(const byte *data, size_t size)
+				: _ptr(data), _remaining(size)
+			{	}
+
+			void read(void *data, size_t size)
+			{
+				if (size > _remaining)
+					throw out_of_range("A message is truncated!");
+				memcpy(data, _ptr, size);
+				_ptr += size;
+				_remaining -= size;
+			}
+
+			const byte *ptr() const throw()
+			{	return _ptr;	}
+
+			size_t remaining() const throw()
+			{	return _remaining;	}
+
+		private:
+			const byte *_ptr;
+			size_t _remaining;
+		};
+
+		class vector_writer
+		{
+		public:
+			vector_writer(vector<byte> &buffer)
+				: _buffer(buffer)
+			{	}
+
+			void write(const void *data, size_t size)
+			{
+				const byte *data_ = static_cast<const byte *>(data);
+
+				_buffer.insert(_buffer.end(), data_, data_ + size);
+			}
+
+		private:
+			void operator =(const vector_writer &rhs);
+
+		private:
+			vector<byte> &_buffer;
+		};
+
+		bool is_state_command(unsigned int command)
+		{
+			return command == init || command == modules_loaded || command == modules_unloaded
+				|| command == register_addresses;
+		}
+
+		void make_header(byte (&header)[frame_header_size], size_t size)
+		{
+			const unsigned int size32 = static_cast<unsigned int>(size);
+
+			header[0] = static_cast<byte>(size32), header[1] = static_cast<byte>(size32 >> 8);
+			header[2] = static_cast<byte>(size32 >> 16), header[3] = static_cast<byte>(size32 >> 24);
+		}
+	}
+
+	recording_writer::recording_writer(const sink_t &sink, size_t segment_limit)
+		: _sink(sink), _segment_limit(segment_limit), _segment(0), _segment_size(0)
+	{	}
+
+	void recording_writer::write(const void *message, size_t size)
+	{
+		if (_segment_limit && _segment_size >= _segment_limit)
+		{
+			++_segment;
+			write_head();
+			_segment_size = 0;
+		}
+		write_frame(message, size);
+		try
+		{
+			track_state(static_cast<const byte *>(message), size);
+		}
+		catch (const out_of_range &)
+		{
+			// A malformed message is recorded as is, but does not contribute to the heads of the next segments.
+		}
+	}
+
+	void recording_writer::write_head()
+	{
+		if (!_state_messages.empty())
+			_sink(_segment, &_state_messages[0], _state_messages.size());
+		if (_paths.size() > 1)
+		{
+			vector<byte> buffer;
+			vector_writer writer(buffer);
+			strmd::serializer<vector_writer, packer> archive(writer);
+			commands c = update_call_paths;
+
+			archive(c);
+			archive(_paths);
+			write_frame(&buffer[0], buffer.size());
+		}
+	}
+
+	void recording_writer::write_frame(const void *message, size_t size)
+	{
+		byte header[frame_header_size];
+
+		make_header(header, size);
+		_sink(_segment, header, sizeof(header));
+		if (size)
+			_sink(_segment, message, size);
+		_segment_size += sizeof(header) + size;
+	}
+
+	void recording_writer::track_state(const byte *message, size_t size)
+	{
+		// Commands are small enough for their varint to be a single byte, so the irrelevant ones are cheap to skip.
+		if (!size || (!is_state_command(*message) && *message != update_call_paths && *message != compressed))
+			return;
+
+		buffer_reader reader(message, size);
+		strmd::deserializer<buffer_reader, packer> archive(reader);
+		unsigned int uncompressed_size;
+		byte inner;
+		commands c;
+
+		archive(c);
+		if (is_state_command(c))
+		{
+			keep_state(message, size);
+		}
+		else if (c == update_call_paths)
+		{
+			archive(_paths);
+			_paths.reset_times();
+		}
+		else if (c == compressed)
+		{
+			archive(uncompressed_size);
+			if (!uncompressed_size || uncompressed_size > c_max_uncompressed_size
+				|| !decompress_first(inner, reader.ptr(), reader.remaining()))
+			{
+				return;
+			}
+			if (is_state_command(inner))
+			{
+				keep_state(message, size);
+			}
+			else if (inner == update_call_paths)
+			{
+				vector<byte> decompressed(uncompressed_size);
+
+				if (decompress(&decompressed[0], uncompressed_size, reader.ptr(), reader.remaining()))
+					track_state(&decompressed[0], uncompressed_size);
+			}
+		}
+	}
+
+	void recording_writer::keep_state(const byte *message, size_t size)
+	{
+		byte header[frame_header_size];
+
+		make_header(header, size);
+		_state_messages.insert(_state_messages.end(), header, header + frame_header_size);
+		_state_messages.insert(_state_messages.end(), message, message + size);
+	}
+
+
+	bool read_recording(const channel_t &channel, const void *data, size_t size)
+	{
+		for (const byte *ptr = static_cast<const byte *>(data); size; )
+		{
+			if (size < frame_header_size)
+				return false;
+
+			const size_t message_size = ptr[0] | ptr[1] << 8 | ptr[2] << 16 | static_cast<unsigned int>(ptr[3]) << 24;
+
+			ptr += frame_header_size, size -= frame_header_size;
+			if (size < message_size || !channel(ptr, message_size))
+				return false;
+			ptr += message_size, size -= message_size;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,186 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <common/trace_events.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		const char c_prologue[] = "{\"traceEvents\":[";
+		const char c_epilogue[] = "\n]}\n";
+		const char c_hex_digits[] = "0123456789abcdef";
+	}
+
+	trace_events_writer::trace_events_writer(const sink_t &sink, timestamp_t ticks_per_second, timestamp_t origin,
+			unsigned int pid, size_t chunk_size)
+		: _sink(sink), _nanoseconds_per_tick(1e9 / ticks_per_second), _origin(origin), _pid(pid),
+			_chunk_size(chunk_size ? chunk_size : 1), _first(true), _closed(false)
+	{
+		_chunk.reserve(_chunk_size);
+		append(c_prologue);
+	}
+
+	trace_events_writer::~trace_events_writer()
+	{
+		if (!_closed)
+			close();
+	}
+
+	void trace_events_writer::thread_name(unsigned int threadid, const char *name)
+	{
+		event_prologue('M', threadid);
+		append(",\"name\":\"thread_name\",\"args\":{\"name\":\"");
+		append_escaped(name);
+		append("\"}}");
+	}
+
+	void trace_events_writer::begin(unsigned int threadid, timestamp_t timestamp, long_address_t function)
+	{
+		event_prologue('B', threadid);
+		append(",\"ts\":");
+		append_timestamp(timestamp);
+		append(",\"name\":\"0x");
+		append_hex(function);
+		append("\"}");
+	}
+
+	void trace_events_writer::begin(unsigned int threadid, timestamp_t timestamp, const char *name)
+	{
+		event_prologue('B', threadid);
+		append(",\"ts\":");
+		append_timestamp(timestamp);
+		append(",\"name\":\"");
+		append_escaped(name);
+		append("\"}");
+	}
+
+	void trace_events_writer::end(unsigned int threadid, timestamp_t timestamp)
+	{
+		event_prologue('E', threadid);
+		append(",\"ts\":");
+		append_timestamp(timestamp);
+		append('}');
+	}
+
+	void trace_events_writer::write(unsigned int threadid, const call_record *calls, size_t count)
+	{
+		for (const call_record *i = calls, *e = calls + count; i != e; ++i)
+		{
+			if (i->callee)
+				begin(threadid, i->timestamp, reinterpret_cast<size_t>(i->callee));
+			else
+				end(threadid, i->timestamp);
+		}
+	}
+
+	void trace_events_writer::close()
+	{
+		append(c_epilogue);
+		flush();
+		_closed = true;
+	}
+
+	void trace_events_writer::event_prologue(char phase, unsigned int threadid)
+	{
+		append(_first ? "\n{\"ph\":\"" : ",\n{\"ph\":\"");
+		append(phase);
+		append("\",\"pid\":");
+		append_decimal(_pid);
+		append(",\"tid\":");
+		append_decimal(threadid);
+		_first = false;
+	}
+
+	void trace_events_writer::append(const char *text)
+	{
+		while (*text)
+			append(*text++);
+	}
+
+	void trace_events_writer::append(char c)
+	{
+		_chunk.push_back(c);
+		if (_chunk.size() == _chunk_size)
+			flush();
+	}
+
+	void trace_events_writer::append_escaped(const char *text)
+	{
+		for (; *text; ++text)
+		{
+			const unsigned char c = static_cast<unsigned char>(*text);
+
+			if (c == '"' || c == '\\')
+				append('\\'), append(*text);
+			else if (c < 0x20)
+				append("\\u00"), append(c_hex_digits[c >> 4]), append(c_hex_digits[c & 0x0F]);
+			else
+				append(*text);
+		}
+	}
+
+	void trace_events_writer::append_decimal(unsigned long long value)
+	{
+		char buffer[24], *p = buffer + sizeof(buffer);
+
+		*--p = 0;
+		do
+			*--p = static_cast<char>('0' + value % 10);
+		while (value /= 10);
+		append(p);
+	}
+
+	void trace_events_writer::append_hex(unsigned long long value)
+	{
+		char buffer[24], *p = buffer + sizeof(buffer);
+
+		*--p = 0;
+		do
+			*--p = c_hex_digits[value & 0x0F];
+		while (value >>= 4);
+		append(p);
+	}
+
+	void trace_events_writer::append_timestamp(timestamp_t timestamp)
+	{
+		const double ns = static_cast<double>(timestamp - _origin) * _nanoseconds_per_tick;
+		const long long rounded = static_cast<long long>(ns < 0 ? ns - 0.5 : ns + 0.5);
+		const unsigned long long magnitude = rounded < 0 ? -rounded : rounded;
+		const unsigned int fraction = static_cast<unsigned int>(magnitude % 1000);
+
+		if (rounded < 0)
+			append('-');
+		append_decimal(magnitude / 1000);
+		append('.');
+		append(static_cast<char>('0' + fraction / 100));
+		append(static_cast<char>('0' + fraction / 10 % 10));
+		append(static_cast<char>('0' + fraction % 10));
+	}
+
+	void trace_events_writer::flush()
+	{
+		if (!_chunk.empty())
+			_sink(&_chunk[0], _chunk.size());
+		_chunk.clear();
+	}
+}
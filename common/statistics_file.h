@@ -0,0 +1,49 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "call_paths.h"
+#include "primitives.h"
+
+#include <utility>
+
+namespace micro_profiler
+{
+	// Files saved before the format was versioned start with ticks per second, which is never zero. Versioned files
+	// start with a zero followed by this version: version 1 added latency histograms and call paths.
+	const unsigned int c_statistics_file_version = 1;
+
+	// Writes a statistics file read by functions_list::load(): the header, the name of each function (as returned by
+	// 'name' for its address), the detailed statistics and the call paths.
+	template <typename ArchiveT, typename StatisticsT, typename NameT>
+	inline void save_statistics_file(ArchiveT &archive, timestamp_t ticks_per_second, const StatisticsT &statistics,
+		const call_paths &paths, const NameT &name)
+	{
+		archive(static_cast<timestamp_t>(0));
+		archive(c_statistics_file_version);
+		archive(ticks_per_second);
+		archive(statistics.size());
+		for (typename StatisticsT::const_iterator i = statistics.begin(); i != statistics.end(); ++i)
+			archive(std::make_pair(i->first, name(i->first)));
+		archive(statistics);
+		archive(paths);
+	}
+}
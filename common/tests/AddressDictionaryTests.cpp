@@ -0,0 +1,202 @@
+#include <common/address_dictionary.h>
+
+#include <common/serialization.h>
+#include <test-helpers/helpers.h>
+
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <strmd/serializer.h>
+#include <strmd/deserializer.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			typedef map<const void *, function_statistics_detailed_t<const void *> > source_map;
+			typedef statistics_map_detailed_t<long_address_t> target_map;
+
+			void log_update(vector<long_address_t> &log, long_address_t address)
+			{	log.push_back(address);	}
+		}
+
+		begin_test_suite( AddressDictionaryTests )
+			test( IdsAreAssignedDenselyInOrderOfFirstAppearance )
+			{
+				// INIT
+				address_dictionary d;
+				registered_addresses registered;
+				source_map s;
+
+				s[(void *)0x1000].callees[(void *)0x3000];
+				s[(void *)0x2000].callees[(void *)0x1000];
+
+				// ACT
+				d.register_addresses(s, registered);
+
+				// ASSERT
+				long_address_t reference1[] = {	0x1000, 0x3000, 0x2000,	};
+
+				assert_equal(reference1, registered);
+				assert_equal(3u, d.size());
+				assert_equal(0u, d[(void *)0x1000]);
+				assert_equal(1u, d[(void *)0x3000]);
+				assert_equal(2u, d[(void *)0x2000]);
+
+				// INIT
+				s.clear();
+				s[(void *)0x3000].callees[(void *)0x4000];
+				s[(void *)0x5000];
+
+				// ACT
+				d.register_addresses(s, registered);
+
+				// ASSERT
+				long_address_t reference2[] = {	0x4000, 0x5000,	};
+
+				assert_equal(reference2, registered);
+				assert_equal(1u, d[(void *)0x3000]);
+				assert_equal(3u, d[(void *)0x4000]);
+				assert_equal(4u, d[(void *)0x5000]);
+
+				// INIT
+				s.erase((void *)0x5000);
+
+				// ACT
+				d.register_addresses(s, registered);
+
+				// ASSERT
+				assert_is_empty(registered);
+				assert_equal(5u, d.size());
+			}
+
+
+			test( IndexResolvesIdsAndRefersToEntriesUntilReset )
+			{
+				// INIT
+				address_index<long_address_t> index;
+				target_map m;
+
+				index.append(0x1234);
+				index.append(0x5678);
+
+				// ACT
+				target_map::mapped_type &e1 = index.entry(m, 1);
+
+				// ASSERT
+				assert_equal(2u, index.size());
+				assert_equal(0x1234u, index[0]);
+				assert_equal(0x5678u, index[1]);
+				assert_equal(1u, m.size());
+				assert_equal(&m[0x5678], &e1);
+
+				// ACT
+				e1.times_called = 3;
+
+				// ASSERT
+				assert_equal(&e1, &index.entry(m, 1));
+				assert_equal(1u, m.size());
+
+				// INIT
+				target_map m2;
+
+				// ACT
+				index.reset_entries();
+				target_map::mapped_type &e2 = index.entry(m2, 1);
+
+				// ASSERT
+				assert_equal(&m2[0x5678], &e2);
+				assert_equal(0u, e2.times_called);
+			}
+
+
+			test( IndexedStatisticsAreMergedIntoExistingWithDelta )
+			{
+				// INIT
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+				strmd::deserializer<vector_adapter, packer> ds(buffer);
+				address_dictionary d;
+				registered_addresses registered;
+				address_index<long_address_t> index;
+				source_map source;
+				target_map target;
+				function_statistics_detailed_t<long_address_t>::callees_map delta;
+				vector<long_address_t> log;
+				wpl::slot_connection c = target.entry_updated += bind(&log_update, ref(log), _1);
+
+				static_cast<function_statistics &>(source[(void *)0x1000]) = function_statistics(11, 2, 1000, 300, 70);
+				source[(void *)0x1000].callees[(void *)0x2000] = function_statistics(3, 0, 500, 500, 200);
+				source[(void *)0x1000].latencies.add(70, 1);
+				static_cast<function_statistics &>(source[(void *)0x2000]) = function_statistics(3, 0, 500, 500, 200);
+				static_cast<function_statistics &>(target[0x2000]) = function_statistics(1, 0, 10, 10, 10);
+
+				d.register_addresses(source, registered);
+				s(registered);
+
+				indexed_statistics_t<source_map> update = {	source, d	};
+				indexed_update_t<long_address_t> target_update = {	target, delta, index	};
+
+				// ACT
+				ds(index);
+				s(update);
+				ds(target_update);
+
+				// ASSERT
+				assert_equal(2u, index.size());
+				assert_equal(2u, target.size());
+				assert_equal(11u, target[0x1000].times_called);
+				assert_equal(1000, target[0x1000].inclusive_time);
+				assert_equal(1u, target[0x1000].callees.size());
+				assert_equal(3u, target[0x1000].callees[0x2000].times_called);
+				assert_equal(1u, target[0x1000].latencies.total());
+				assert_equal(4u, target[0x2000].times_called);
+				assert_equal(510, target[0x2000].inclusive_time);
+				assert_equal(200, target[0x2000].max_call_time);
+				assert_equal(2u, delta.size());
+				assert_equal(3u, delta[0x2000].times_called);
+				assert_equal(11u, delta[0x1000].times_called);
+
+				long_address_t reference[] = {	0x1000,	};
+
+				assert_equal(reference, log);
+			}
+
+
+			test( UnknownIdsAreRejected )
+			{
+				// INIT
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+				strmd::deserializer<vector_adapter, packer> ds(buffer);
+				address_dictionary d;
+				registered_addresses registered;
+				address_index<long_address_t> index;
+				source_map source;
+				target_map target;
+				function_statistics_detailed_t<long_address_t>::callees_map delta;
+
+				source[(void *)0x1000].callees[(void *)0x2000] = function_statistics(3, 0, 500, 500, 200);
+				d.register_addresses(source, registered);
+				index.append(0x1000);
+
+				indexed_statistics_t<source_map> update = {	source, d	};
+				indexed_update_t<long_address_t> target_update = {	target, delta, index	};
+
+				s(update);
+
+				// ACT / ASSERT
+				assert_throws(index[1], out_of_range);
+				assert_throws(index.entry(target, 1), out_of_range);
+				assert_throws(ds(target_update), out_of_range);
+			}
+		end_test_suite
+	}
+}
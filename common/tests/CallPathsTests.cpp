@@ -0,0 +1,151 @@
+#include <common/call_paths.h>
+
+#include <common/serialization.h>
+#include <test-helpers/helpers.h>
+
+#include <strmd/serializer.h>
+#include <strmd/deserializer.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		begin_test_suite( CallPathsTests )
+			test( NewPathsContainOnlyRoot )
+			{
+				// INIT / ACT
+				call_paths paths;
+
+				// ASSERT
+				assert_equal(1u, paths.size());
+				assert_is_false(paths.changed());
+			}
+
+
+			test( PathsAreInternedOnce )
+			{
+				// INIT
+				call_paths paths;
+
+				// ACT
+				call_paths::path_id p1 = paths.intern(call_paths::root, 0x100);
+				call_paths::path_id p2 = paths.intern(p1, 0x200);
+				call_paths::path_id p3 = paths.intern(call_paths::root, 0x200);
+				call_paths::path_id p4 = paths.intern(p2, 0x100);
+
+				// ASSERT
+				assert_equal(5u, paths.size());
+				assert_equal(p1, paths.intern(call_paths::root, 0x100));
+				assert_equal(p2, paths.intern(p1, 0x200));
+				assert_equal(p3, paths.intern(call_paths::root, 0x200));
+				assert_equal(p4, paths.intern(p2, 0x100));
+				assert_equal(5u, paths.size());
+				assert_equal(p2, paths[p4].parent);
+				assert_equal(0x100u, paths[p4].function);
+				assert_equal(p1, paths[p2].parent);
+				assert_equal(0x200u, paths[p2].function);
+			}
+
+
+			test( TimesAreAccumulatedAndResetOnCommit )
+			{
+				// INIT
+				call_paths paths;
+				call_paths::path_id p1 = paths.intern(call_paths::root, 0x100);
+				call_paths::path_id p2 = paths.intern(p1, 0x200);
+
+				// ACT
+				paths.add_time(p1, 10);
+				paths.add_time(p2, 3);
+				paths.add_time(p1, 5);
+				paths.add_time(p2, -1);
+
+				// ASSERT
+				assert_equal(15, paths[p1].exclusive_time);
+				assert_equal(3, paths[p2].exclusive_time);
+
+				// ACT
+				paths.commit();
+
+				// ASSERT
+				assert_is_false(paths.changed());
+				assert_equal(0, paths[p1].exclusive_time);
+				assert_equal(0, paths[p2].exclusive_time);
+				assert_equal(3u, paths.size());
+			}
+
+
+			test( OnlyPendingNodesAndTimesAreSerialized )
+			{
+				// INIT
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+				strmd::deserializer<vector_adapter, packer> ds(buffer);
+				call_paths paths, received;
+				call_paths::path_id p1 = paths.intern(call_paths::root, 0x100);
+				call_paths::path_id p2 = paths.intern(p1, 0x200);
+
+				paths.add_time(p2, 7);
+
+				// ACT
+				s(paths);
+				paths.commit();
+				ds(received);
+
+				// ASSERT
+				assert_equal(3u, received.size());
+				assert_equal(p1, received.intern(call_paths::root, 0x100));
+				assert_equal(p2, received.intern(p1, 0x200));
+				assert_equal(0, received[p1].exclusive_time);
+				assert_equal(7, received[p2].exclusive_time);
+
+				// INIT
+				const size_t previous_size = buffer.buffer.size();
+				call_paths::path_id p3 = paths.intern(p2, 0x300);
+
+				paths.add_time(p2, 1);
+				paths.add_time(p3, 11);
+
+				// ACT
+				s(paths);
+				ds(received);
+
+				// ASSERT
+				assert_is_true(buffer.buffer.size() - previous_size < 10u);
+				assert_equal(4u, received.size());
+				assert_equal(p3, received.intern(p2, 0x300));
+				assert_equal(8, received[p2].exclusive_time);
+				assert_equal(11, received[p3].exclusive_time);
+			}
+
+
+			test( NodesWithUnknownParentsAreRejected )
+			{
+				// INIT
+				vector_adapter buffer1, buffer2;
+				strmd::serializer<vector_adapter, packer> s1(buffer1), s2(buffer2);
+				strmd::deserializer<vector_adapter, packer> ds1(buffer1), ds2(buffer2);
+				call_paths paths, received;
+				call_paths::path_id p1 = paths.intern(call_paths::root, 0x100);
+
+				s1(paths);
+				paths.commit();
+				paths.intern(p1, 0x200);
+				s2(paths);
+
+				// ACT / ASSERT
+				assert_throws(ds2(received), out_of_range);
+
+				// ACT
+				ds1(received);
+
+				// ASSERT
+				assert_equal(2u, received.size());
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,210 @@
+#include <common/columnar.h>
+
+#include <common/serialization.h>
+#include <test-helpers/helpers.h>
+
+#include <functional>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			typedef statistics_map_detailed_t<const void *> source_map;
+			typedef statistics_map_detailed_t<long_address_t> target_map;
+
+			void log_update(vector<long_address_t> &log, long_address_t address)
+			{	log.push_back(address);	}
+
+			void make_source(source_map &s)
+			{
+				static_cast<function_statistics &>(s[(void *)0x1000]) = function_statistics(11, 2, 1000, 300, 70);
+				s[(void *)0x1000].callees[(void *)0x2000] = function_statistics(3, 0, 500, 500, 200);
+				s[(void *)0x1000].callees[(void *)0x3000] = function_statistics(7, 1, 200, 150, 40);
+				s[(void *)0x1000].latencies.add(70, 1);
+				s[(void *)0x1000].latencies.add(90, 10);
+				static_cast<function_statistics &>(s[(void *)0x2000]) = function_statistics(3, 0, 500, 500, 200);
+				s[(void *)0x2000].latencies.add(200, 3);
+				static_cast<function_statistics &>(s[(void *)0x3000]) = function_statistics(7, 1, 200, 150, 40);
+			}
+		}
+
+		begin_test_suite( ColumnarTests )
+			test( WrittenUpdateIsMergedIntoEmptyStatisticsAsIs )
+			{
+				// INIT
+				vector_adapter buffer;
+				source_map s;
+				target_map t;
+				columnar_update u;
+
+				make_source(s);
+
+				// ACT
+				write_columnar(buffer, s.begin(), s.end());
+
+				// ASSERT
+				assert_is_true(u.parse(&buffer.buffer[0], buffer.buffer.size()));
+				assert_equal(3u, u.function_count);
+				assert_equal(2u, u.edge_count);
+				assert_equal(3u, u.bucket_count);
+
+				// ACT
+				merge_columnar(t, 0, u);
+
+				// ASSERT
+				assert_equal(3u, t.size());
+				assert_equal(function_statistics(11, 2, 1000, 300, 70), t[0x1000]);
+				assert_equal(function_statistics(3, 0, 500, 500, 200), t[0x2000]);
+				assert_equal(function_statistics(7, 1, 200, 150, 40), t[0x3000]);
+				assert_equal(2u, t[0x1000].callees.size());
+				assert_equal(function_statistics(3, 0, 500, 500, 200), t[0x1000].callees[0x2000]);
+				assert_equal(function_statistics(7, 1, 200, 150, 40), t[0x1000].callees[0x3000]);
+				assert_equal(0u, t[0x2000].callees.size());
+				assert_equal(11u, t[0x1000].latencies.total());
+				assert_equal(histogram::bucket_upper_bound(histogram::bucket_index(90)), t[0x1000].latencies.percentile(0.5));
+				assert_equal(3u, t[0x2000].latencies.total());
+				assert_equal(0u, t[0x3000].latencies.total());
+			}
+
+
+			test( ColumnsAreEightByteAlignedWithinPayload )
+			{
+				// INIT
+				vector_adapter buffer;
+				source_map s;
+				columnar_update u;
+
+				make_source(s);
+				s[(void *)0x4000].times_called = 1;
+				write_columnar(buffer, s.begin(), s.end());
+
+				const unsigned char *base = &buffer.buffer[0];
+
+				// ACT
+				u.parse(base, buffer.buffer.size());
+
+				// ASSERT
+				const void *columns[] = {
+					u.functions.address.data, u.functions.times_called.data, u.functions.max_reentrance.data,
+					u.edges.address.data, u.edges.max_call_time.data, u.edge_caller.data,
+					u.bucket_hits.data, u.bucket_function.data, u.bucket_index.data,
+				};
+
+				assert_equal(0u, buffer.buffer.size() % 8);
+				for (size_t i = 0; i != array_size(columns); ++i)
+					assert_equal(0u, (static_cast<const unsigned char *>(columns[i]) - base) % 8);
+			}
+
+
+			test( PayloadIsParsedAndMergedAtAnyAlignment )
+			{
+				// INIT
+				vector_adapter buffer;
+				source_map s;
+
+				make_source(s);
+				write_columnar(buffer, s.begin(), s.end());
+
+				for (size_t offset = 1; offset != 8; ++offset)
+				{
+					vector<byte> message(offset, 0);
+					target_map t;
+					columnar_update u;
+
+					message.insert(message.end(), buffer.buffer.begin(), buffer.buffer.end());
+
+					// ACT
+					assert_is_true(u.parse(&message[offset], buffer.buffer.size()));
+					merge_columnar(t, 0, u);
+
+					// ASSERT
+					assert_equal(3u, t.size());
+					assert_equal(function_statistics(11, 2, 1000, 300, 70), t[0x1000]);
+					assert_equal(function_statistics(7, 1, 200, 150, 40), t[0x1000].callees[0x3000]);
+					assert_equal(11u, t[0x1000].latencies.total());
+				}
+			}
+
+
+			test( TruncatedPayloadIsRejected )
+			{
+				// INIT
+				vector_adapter buffer;
+				source_map s;
+				columnar_update u;
+
+				make_source(s);
+				write_columnar(buffer, s.begin(), s.end());
+
+				// ACT / ASSERT
+				for (size_t size = 0; size != buffer.buffer.size(); ++size)
+					assert_is_false(u.parse(&buffer.buffer[0], size));
+				assert_is_true(u.parse(&buffer.buffer[0], buffer.buffer.size()));
+			}
+
+
+			test( EmptyUpdateIsParsedAndMergedAsNoop )
+			{
+				// INIT
+				vector_adapter buffer;
+				source_map s;
+				target_map t;
+				columnar_update u;
+
+				write_columnar(buffer, s.begin(), s.end());
+
+				// ACT
+				assert_is_true(u.parse(&buffer.buffer[0], buffer.buffer.size()));
+				merge_columnar(t, 0, u);
+
+				// ASSERT
+				assert_equal(0u, u.function_count);
+				assert_is_empty(t);
+			}
+
+
+			test( UpdateIsAddedToExistingStatisticsAndDelta )
+			{
+				// INIT
+				vector_adapter buffer;
+				source_map s;
+				target_map t;
+				function_statistics_detailed_t<long_address_t>::callees_map delta;
+				vector<long_address_t> log;
+				columnar_update u;
+				wpl::slot_connection c = t.entry_updated += bind(&log_update, ref(log), _1);
+
+				make_source(s);
+				static_cast<function_statistics &>(t[0x1000]) = function_statistics(1, 3, 100, 10, 100);
+				t[0x1000].callees[0x2000] = function_statistics(1, 0, 90, 90, 90);
+				t[0x1000].latencies.add(90, 1);
+				t[0x5000].times_called = 17;
+				write_columnar(buffer, s.begin(), s.end());
+				u.parse(&buffer.buffer[0], buffer.buffer.size());
+
+				// ACT
+				merge_columnar(t, &delta, u);
+
+				// ASSERT
+				long_address_t reference[] = {	0x1000,	};
+
+				assert_equal(4u, t.size());
+				assert_equal(function_statistics(12, 3, 1100, 310, 100), t[0x1000]);
+				assert_equal(function_statistics(4, 0, 590, 590, 200), t[0x1000].callees[0x2000]);
+				assert_equal(12u, t[0x1000].latencies.total());
+				assert_equal(17u, t[0x5000].times_called);
+				assert_equal(3u, delta.size());
+				assert_equal(function_statistics(11, 2, 1000, 300, 70), delta[0x1000]);
+				assert_equal(function_statistics(7, 1, 200, 150, 40), delta[0x3000]);
+				assert_equal(reference, log);
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,172 @@
+#include <common/compression.h>
+
+#include <test-helpers/helpers.h>
+
+#include <stdlib.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			vector<byte> compress(const vector<byte> &data)
+			{
+				vector<byte> compressed(compress_bound(data.size()));
+
+				compressed.resize(micro_profiler::compress(&compressed[0], data.empty() ? 0 : &data[0], data.size()));
+				return compressed;
+			}
+
+			bool decompress(vector<byte> &data, const vector<byte> &compressed)
+			{
+				return micro_profiler::decompress(data.empty() ? 0 : &data[0], data.size(), &compressed[0],
+					compressed.size());
+			}
+
+			vector<byte> make_random(size_t size, unsigned int seed)
+			{
+				vector<byte> data(size);
+
+				for (size_t i = 0; i != size; ++i)
+					data[i] = static_cast<byte>((seed = seed * 1103515245 + 12345) >> 16);
+				return data;
+			}
+
+			vector<byte> make_statistics_like(size_t records)
+			{
+				vector<byte> data;
+
+				for (size_t i = 0; i != records; ++i)
+				{
+					const unsigned long long address = 0x7FF612340000ull + 0x40 * i;
+					const unsigned int small[] = {	static_cast<unsigned int>(i / 1000), 1, 0, 3,	};
+
+					data.insert(data.end(), reinterpret_cast<const byte *>(&address),
+						reinterpret_cast<const byte *>(&address + 1));
+					data.insert(data.end(), reinterpret_cast<const byte *>(small),
+						reinterpret_cast<const byte *>(array_end(small)));
+				}
+				return data;
+			}
+		}
+
+		begin_test_suite( CompressionTests )
+			test( EmptyDataRoundTrips )
+			{
+				// INIT
+				vector<byte> data, compressed = compress(data);
+
+				// ACT / ASSERT
+				assert_is_true(compressed.size() <= compress_bound(0));
+				assert_is_true(decompress(data, compressed));
+			}
+
+
+			test( DataOfVariousSizesRoundTrips )
+			{
+				// INIT
+				size_t sizes[] = {	1, 3, 4, 5, 15, 16, 17, 270, 271, 1000, 65536, 300001,	};
+
+				for (size_t i = 0; i != array_size(sizes); ++i)
+				{
+					vector<byte> random = make_random(sizes[i], 17), repetitive(sizes[i], 'a');
+					vector<byte> decompressed(sizes[i]);
+
+					// ACT
+					vector<byte> compressed = compress(random);
+
+					// ASSERT
+					assert_is_true(compressed.size() <= compress_bound(sizes[i]));
+					assert_is_true(decompress(decompressed, compressed));
+					assert_equal(random, decompressed);
+
+					// ACT
+					compressed = compress(repetitive);
+
+					// ASSERT
+					assert_is_true(decompress(decompressed, compressed));
+					assert_equal(repetitive, decompressed);
+				}
+			}
+
+
+			test( RepeatedAddressesAndSmallNumbersAreCompressedWell )
+			{
+				// INIT
+				vector<byte> data = make_statistics_like(10000), decompressed(data.size());
+
+				// ACT
+				vector<byte> compressed = compress(data);
+
+				// ASSERT
+				assert_is_true(compressed.size() < data.size() / 3);
+				assert_is_true(decompress(decompressed, compressed));
+				assert_equal(data, decompressed);
+			}
+
+
+			test( LongRunsAndLongLiteralsUseExtendedLengths )
+			{
+				// INIT
+				vector<byte> data = make_random(1000, 3), run(100000, 0), decompressed;
+
+				data.insert(data.end(), run.begin(), run.end());
+				decompressed.resize(data.size());
+
+				// ACT
+				vector<byte> compressed = compress(data);
+
+				// ASSERT
+				assert_is_true(compressed.size() < 1000 + 1000);
+				assert_is_true(decompress(decompressed, compressed));
+				assert_equal(data, decompressed);
+			}
+
+
+			test( MalformedBlocksAreRejected )
+			{
+				// INIT
+				vector<byte> data = make_statistics_like(100), compressed = compress(data);
+				vector<byte> decompressed(data.size()), larger(data.size() + 1), smaller(data.size() - 1);
+				vector<byte> truncated(compressed.begin(), compressed.end() - 1);
+				byte bad_offset[] = {	0x10, 'a', 0x05, 0x00,	};
+				byte no_offset[] = {	0x10, 'a', 0x05,	};
+
+				// ACT / ASSERT
+				assert_is_false(decompress(larger, compressed));
+				assert_is_false(decompress(smaller, compressed));
+				assert_is_false(decompress(decompressed, truncated));
+				assert_is_false(micro_profiler::decompress(&decompressed[0], 10, bad_offset, array_size(bad_offset)));
+				assert_is_false(micro_profiler::decompress(&decompressed[0], 10, no_offset, array_size(no_offset)));
+			}
+
+
+			test( FirstByteIsRetrievedWithoutDecompressing )
+			{
+				// INIT
+				vector<byte> random = make_random(1000, 3), repetitive(300, 'a');
+				vector<byte> compressed_random = compress(random), compressed_repetitive = compress(repetitive);
+				byte first = 0;
+				byte match_first[] = {	0x04, 0x01, 0x00,	};
+				byte long_literals[] = {	0xF0, 0x00,	};
+
+				// ACT / ASSERT
+				assert_is_true(decompress_first(first, &compressed_random[0], compressed_random.size()));
+				assert_equal(random[0], first);
+				assert_is_true(decompress_first(first, &compressed_repetitive[0],
+					compressed_repetitive.size()));
+				assert_equal('a', first);
+
+				// ACT / ASSERT
+				assert_is_false(decompress_first(first, 0, 0));
+				assert_is_false(decompress_first(first, match_first, array_size(match_first)));
+				assert_is_false(decompress_first(first, long_literals, array_size(long_literals)));
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,147 @@
+#include <common/primitives.h>
+
+#include <common/serialization.h>
+#include <test-helpers/helpers.h>
+
+#include <strmd/serializer.h>
+#include <strmd/deserializer.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			typedef pair<unsigned int, count_t> bucket;
+
+			vector<bucket> mkbuckets(const histogram::const_iterator &b, const histogram::const_iterator &e)
+			{	return vector<bucket>(b, e);	}
+		}
+
+		begin_test_suite( HistogramTests )
+			test( NewHistogramIsEmpty )
+			{
+				// INIT
+				histogram h;
+
+				// ACT / ASSERT
+				assert_equal(0u, h.total());
+				assert_equal(0u, h.size());
+				assert_is_true(h.begin() == h.end());
+				assert_equal(0, h.percentile(0.5));
+			}
+
+
+			test( SmallValuesAreCountedExactly )
+			{
+				// INIT / ACT / ASSERT
+				for (timestamp_t v = 0; v != 16; ++v)
+				{
+					assert_equal(static_cast<unsigned int>(v), histogram::bucket_index(v));
+					assert_equal(v, histogram::bucket_upper_bound(histogram::bucket_index(v)));
+				}
+				assert_equal(0u, histogram::bucket_index(-10));
+			}
+
+
+			test( BucketsCoverValuesContiguouslyWithBoundedRelativeError )
+			{
+				// INIT
+				timestamp_t values[] = {	16, 17, 100, 1000, 12345, 1000000, 123456789012, 0x7FFFFFFFFFFFFFFF,	};
+
+				for (size_t i = 0; i != array_size(values); ++i)
+				{
+					// ACT
+					unsigned int index = histogram::bucket_index(values[i]);
+					timestamp_t upper = histogram::bucket_upper_bound(index);
+
+					// ASSERT
+					assert_is_true(index < histogram::max_buckets);
+					assert_is_true(values[i] <= upper);
+					assert_is_true(histogram::bucket_upper_bound(index - 1) < values[i]);
+					assert_is_true(upper - values[i] <= values[i] / histogram::buckets_per_octave);
+				}
+			}
+
+
+			test( PercentilesAreTakenFromCumulativeCounts )
+			{
+				// INIT
+				histogram h;
+
+				// ACT
+				h.add(3, 90);
+				h.add(5, 9);
+				h.add(7, 1);
+
+				// ASSERT
+				assert_equal(100u, h.total());
+				assert_equal(3u, h.size());
+				assert_equal(3, h.percentile(0.5));
+				assert_equal(3, h.percentile(0.9));
+				assert_equal(5, h.percentile(0.95));
+				assert_equal(5, h.percentile(0.99));
+				assert_equal(7, h.percentile(0.999));
+				assert_equal(7, h.percentile(1));
+			}
+
+
+			test( HistogramsAreMergedBucketwise )
+			{
+				// INIT
+				histogram h1, h2;
+
+				h1.add(100, 3);
+				h1.add(10000, 1);
+				h2.add(2);
+				h2.add(100, 2);
+
+				// ACT
+				h1 += h2;
+
+				// ASSERT
+				bucket reference[] = {
+					make_pair(histogram::bucket_index(2), 1),
+					make_pair(histogram::bucket_index(100), 5),
+					make_pair(histogram::bucket_index(10000), 1),
+				};
+
+				assert_equal(7u, h1.total());
+				assert_equal(reference, mkbuckets(h1.begin(), h1.end()));
+			}
+
+
+			test( DeserializedHistogramIsMergedIntoExisting )
+			{
+				// INIT
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+				strmd::deserializer<vector_adapter, packer> ds(buffer);
+				histogram h1, h2;
+
+				h1.add(1000, 7);
+				h1.add(31, 2);
+				h2.add(1000, 1);
+				h2.add(5000000, 1);
+
+				// ACT
+				s(h1);
+				ds(h2);
+
+				// ASSERT
+				bucket reference[] = {
+					make_pair(histogram::bucket_index(31), 2),
+					make_pair(histogram::bucket_index(1000), 8),
+					make_pair(histogram::bucket_index(5000000), 1),
+				};
+
+				assert_equal(11u, h2.total());
+				assert_equal(reference, mkbuckets(h2.begin(), h2.end()));
+			}
+		end_test_suite
+	}
+}
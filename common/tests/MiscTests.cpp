@@ -365,6 +365,34 @@ namespace micro_profiler
 				assert_equal(2112, *(v2.data() + 8));
 				assert_equal(9u, v2.capacity());
 			}
+
+
+			test( ResizingPreservesValuesAndGrowsCapacityOnDemand )
+			{
+				// INIT
+				pod_vector<int> v(4);
+				int ext[] = {	3, 5, 7,	};
+
+				v.append(ext, ext + 3);
+
+				// ACT
+				v.resize(2);
+
+				// ASSERT
+				assert_equal(2u, v.size());
+				assert_equal(4u, v.capacity());
+
+				// ACT
+				v.resize(11);
+				v.data()[10] = 13;
+
+				// ASSERT
+				assert_equal(11u, v.size());
+				assert_equal(11u, v.capacity());
+				assert_equal(3, v.data()[0]);
+				assert_equal(5, v.data()[1]);
+				assert_equal(13, v.data()[10]);
+			}
 		end_test_suite
 
 
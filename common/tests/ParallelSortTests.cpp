@@ -0,0 +1,73 @@
+#include <common/parallel_sort.h>
+
+#include <functional>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			vector<int> make_values(size_t n)
+			{
+				vector<int> values;
+				unsigned int seed = 17;
+
+				for (size_t i = 0; i != n; ++i)
+				{
+					seed = seed * 1103515245 + 12345;
+					values.push_back(static_cast<int>((seed >> 8) % 1000));
+				}
+				return values;
+			}
+		}
+
+		begin_test_suite( ParallelSortTests )
+			test( SmallRangesAreSortedInPlace )
+			{
+				// INIT
+				int data[] = {	5, 3, 9, 1, 3,	};
+				vector<int> values(data, data + 5);
+
+				// ACT
+				parallel_sort(values.begin(), values.end(), less<int>(), 100, 4);
+
+				// ASSERT
+				int reference[] = {	1, 3, 3, 5, 9,	};
+
+				assert_equal(reference, values);
+			}
+
+
+			test( LargeRangesAreSortedForAnyNumberOfWorkers )
+			{
+				size_t workers[] = {	1, 2, 3, 4, 7,	};
+
+				for (size_t i = 0; i != sizeof(workers) / sizeof(workers[0]); ++i)
+				{
+					// INIT
+					vector<int> values = make_values(100000), reference = values;
+
+					sort(reference.begin(), reference.end(), greater<int>());
+
+					// ACT
+					parallel_sort(values.begin(), values.end(), greater<int>(), 1000, workers[i]);
+
+					// ASSERT
+					assert_equal(reference, values);
+				}
+			}
+
+
+			test( HardwareThreadsAreCounted )
+			{
+				// ACT / ASSERT
+				assert_is_true(hardware_threads() >= 1u);
+			}
+		end_test_suite
+	}
+}
@@ -196,74 +196,6 @@ namespace micro_profiler
 				assert_equal(17, s2.callees[(const void *)30].exclusive_time);
 				assert_equal(7, s2.callees[(const void *)30].max_call_time);
 			}
-
-
-			test( AddingParentCallsAddsNewStatisticsForParentFunctions )
-			{
-				// INIT
-				statistics_map_detailed m1, m2;
-				function_statistics_detailed f1, f2;
-
-				f1.callees[(const void *)0x0011] = function_statistics(10);
-				f1.callees[(const void *)0x0013] = function_statistics(11);
-				
-				f2.callees[(const void *)0x0021] = function_statistics(13);
-				f2.callees[(const void *)0x0023] = function_statistics(17);
-				f2.callees[(const void *)0x0027] = function_statistics(0x1000000000);
-
-				// ACT
-				update_parent_statistics(m1, (const void *)0x7011, f1);
-				update_parent_statistics(m2, (const void *)0x5011, f2);
-
-				// ASSERT
-				assert_equal(2u, m1.size());
-				assert_equal(1u, m1[(const void *)0x0011].callers.size());
-				assert_equal(1u, m1[(const void *)0x0013].callers.size());
-				assert_equal(10, m1[(const void *)0x0011].callers[(const void *)0x7011]);
-				assert_equal(11, m1[(const void *)0x0013].callers[(const void *)0x7011]);
-
-				assert_equal(3u, m2.size());
-				assert_equal(1u, m2[(const void *)0x0021].callers.size());
-				assert_equal(1u, m2[(const void *)0x0023].callers.size());
-				assert_equal(1u, m2[(const void *)0x0027].callers.size());
-				assert_equal(13, m2[(const void *)0x0021].callers[(const void *)0x5011]);
-				assert_equal(17, m2[(const void *)0x0023].callers[(const void *)0x5011]);
-				assert_equal(0x1000000000u, m2[(const void *)0x0027].callers[(const void *)0x5011]);
-			}
-
-
-			test( AddingParentCallsUpdatesExistingStatisticsForParentFunctions )
-			{
-				// INIT
-				statistics_map_detailed m;
-				function_statistics_detailed f;
-
-				(function_statistics &)m[(const void *)0x0021] = function_statistics(10, 0, 17, 11, 30);
-				m[(const void *)0x0021].callers[(const void *)0x0191] = 123;
-				m[(const void *)0x0023].callers[(const void *)0x0791] = 88;
-				m[(const void *)0x0027].callers[(const void *)0x0191] = 0x0231;
-				
-				f.callees[(const void *)0x0021] = function_statistics(13);
-				f.callees[(const void *)0x0023] = function_statistics(17);
-				f.callees[(const void *)0x0027] = function_statistics(0x1000000000);
-
-				// ACT
-				update_parent_statistics(m, (const void *)0x0191, f);
-
-				// ASSERT
-				assert_equal(3u, m.size());
-				assert_equal(1u, m[(const void *)0x0021].callers.size());
-				assert_equal(2u, m[(const void *)0x0023].callers.size());
-				assert_equal(1u, m[(const void *)0x0027].callers.size());
-				assert_equal(13, m[(const void *)0x0021].callers[(const void *)0x0191]);
-				assert_equal(17, m[(const void *)0x0023].callers[(const void *)0x0191]);
-				assert_equal(88, m[(const void *)0x0023].callers[(const void *)0x0791]);
-				assert_equal(0x1000000000u, m[(const void *)0x0027].callers[(const void *)0x0191]);
-
-				assert_equal(17, m[(const void *)0x0021].inclusive_time);
-				assert_equal(11, m[(const void *)0x0021].exclusive_time);
-				assert_equal(30, m[(const void *)0x0021].max_call_time);
-			}
 		end_test_suite
 	}
 }
@@ -0,0 +1,126 @@
+#include <common/raw_trace.h>
+
+#include <test-helpers/helpers.h>
+
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			call_record make_call(timestamp_t timestamp, size_t callee, size_t stack_ptr)
+			{
+				call_record call = {	timestamp, reinterpret_cast<const void *>(callee)	};
+
+				set_stack_pointer(call, reinterpret_cast<const void *>(stack_ptr));
+				return call;
+			}
+		}
+
+		begin_test_suite( RawTraceTests )
+			test( PackedRecordsAreUnpackedIntact )
+			{
+				// INIT
+				call_record calls[] = {
+					make_call(1000, 0x10001234, 0x7FF000),
+					make_call(1007, 0x10005678, 0x7FEFF0),
+					make_call(1010, 0, 0x7FEFF0),
+					make_call(1011, 0x10000010, 0x7FEFF0),
+					make_call(1030, 0, 0x7FEFF0),
+					make_call(1031, 0, 0x7FF000),
+					make_call(1029, 0x20000000, 0),	// Timestamps may go back, if threads migrate across cores.
+				};
+				vector<byte> buffer(7 * max_packed_call_record_size);
+				raw_trace_encoder e;
+				raw_trace_decoder d;
+				vector<call_record> unpacked;
+
+				// ACT
+				const size_t size = e.encode(&buffer[0], calls, 7);
+
+				// ASSERT
+				assert_is_true(d.decode(unpacked, &buffer[0], size));
+				assert_equal(calls, unpacked);
+			}
+
+
+			test( RecordsArePackedAcrossEncodingCallsAndDecodedInPieces )
+			{
+				// INIT
+				vector<call_record> calls;
+				vector<byte> buffer(1000 * max_packed_call_record_size);
+				raw_trace_encoder e;
+				raw_trace_decoder d;
+				vector<call_record> unpacked;
+
+				for (int i = 0; i != 1000; ++i)
+					calls.push_back(make_call(100000 + 13 * i, i % 2 ? 0 : 0x401000 + 16 * (i % 20), 0x12FF00 - 8 * (i % 7)));
+
+				// ACT
+				size_t size = e.encode(&buffer[0], &calls[0], 300);
+				const size_t split = size;
+
+				size += e.encode(&buffer[size], &calls[300], 700);
+
+				// ASSERT
+				assert_is_true(size < 1000 * sizeof(call_record) / 4);
+
+				// ACT
+				assert_is_true(d.decode(unpacked, &buffer[0], split));
+				assert_is_true(d.decode(unpacked, &buffer[split], size - split));
+
+				// ASSERT
+				assert_equal(calls, unpacked);
+			}
+
+
+			test( ResetStartsAnIndependentlyDecodableSegment )
+			{
+				// INIT
+				call_record calls[] = {
+					make_call(1000, 0x10001234, 0x7FF000),
+					make_call(2000, 0x10005678, 0x7FEFF0),
+				};
+				vector<byte> buffer(2 * max_packed_call_record_size);
+				raw_trace_encoder e;
+				raw_trace_decoder d;
+				vector<call_record> unpacked;
+
+				e.encode(&buffer[0], calls, 1);
+
+				// ACT
+				e.reset();
+				const size_t size = e.encode(&buffer[0], calls + 1, 1);
+
+				// ASSERT
+				assert_is_true(d.decode(unpacked, &buffer[0], size));
+				assert_equal(1u, unpacked.size());
+				assert_is_true(calls[1] == unpacked[0]);
+			}
+
+
+			test( TruncatedRecordIsReportedAsMalformed )
+			{
+				// INIT
+				call_record calls[] = {
+					make_call(1000, 0x10001234, 0x7FF000),
+					make_call(100000000, 0x10005678, 0x7FEFF0),
+				};
+				vector<byte> buffer(2 * max_packed_call_record_size);
+				raw_trace_encoder e;
+				raw_trace_decoder d;
+				vector<call_record> unpacked;
+				const size_t size = e.encode(&buffer[0], calls, 2);
+
+				// ACT / ASSERT
+				assert_is_false(d.decode(unpacked, &buffer[0], size - 1));
+				assert_equal(1u, unpacked.size());
+			}
+		end_test_suite
+	}
+}
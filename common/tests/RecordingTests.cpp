@@ -0,0 +1,306 @@
+#include <common/recording.h>
+
+#include <common/compression.h>
+#include <common/serialization.h>
+
+#include <test-helpers/helpers.h>
+
+#include <string>
+#include <string.h>
+#include <strmd/serializer.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			void append_to_segment(vector<string> &segments, unsigned int segment, const void *buffer, size_t size)
+			{
+				if (segments.size() <= segment)
+					segments.resize(segment + 1);
+				segments[segment].append(static_cast<const char *>(buffer), size);
+			}
+
+			bool log_message(vector<string> &messages, const void *buffer, size_t size)
+			{
+				messages.push_back(string(static_cast<const char *>(buffer), size));
+				return true;
+			}
+
+			bool refuse_message(int &calls, const void *, size_t)
+			{	return ++calls, false;	}
+
+			void write(recording_writer &w, const char *message)
+			{	w.write(message, strlen(message));	}
+
+			vector<string> read(const string &segment, bool expect_success = true)
+			{
+				vector<string> messages;
+
+				assert_equal(expect_success, read_recording(bind(&log_message, ref(messages), _1, _2), segment.data(),
+					segment.size()));
+				return messages;
+			}
+
+			string to_string(const vector_adapter &buffer)
+			{	return string(buffer.buffer.begin(), buffer.buffer.end());	}
+
+			string make_message(commands c, const string &payload)
+			{
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+
+				s(c);
+				return to_string(buffer) + payload;
+			}
+
+			string make_message(call_paths &paths)
+			{
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+				commands c = update_call_paths;
+
+				s(c);
+				s(paths);
+				return to_string(buffer);
+			}
+
+			string make_compressed(const string &message)
+			{
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> s(buffer);
+				commands c = compressed;
+				unsigned int size = static_cast<unsigned int>(message.size());
+				vector<byte> block(compress_bound(message.size()));
+
+				s(c);
+				s(size);
+				block.resize(compress(&block[0], reinterpret_cast<const byte *>(message.data()), message.size()));
+				return to_string(buffer) + string(block.begin(), block.end());
+			}
+
+			void write(recording_writer &w, const string &message)
+			{	w.write(message.data(), message.size());	}
+		}
+
+		begin_test_suite( RecordingTests )
+			test( MessagesAreFramedWithLittleEndianSizes )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 0);
+
+				// ACT
+				write(w, "init");
+				write(w, "");
+				write(w, "lorem ipsum");
+
+				// ASSERT
+				assert_equal(1u, segments.size());
+				assert_equal(string("\x04\0\0\0init" "\0\0\0\0" "\x0B\0\0\0lorem ipsum", 27), segments[0]);
+			}
+
+
+			test( RecordedMessagesAreReadInOrder )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 0);
+				string long_message(70000, 'x');
+
+				write(w, "init");
+				write(w, "");
+				w.write(long_message.data(), long_message.size());
+				write(w, "amet");
+
+				// ACT
+				vector<string> messages = read(segments[0]);
+
+				// ASSERT
+				string reference[] = {	"init", "", long_message, "amet",	};
+
+				assert_equal(reference, messages);
+			}
+
+
+			test( SegmentsAreRotatedBySizeAndStartWithTheStateReceivedSoFar )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 20);
+				const string init_ = make_message(init, "abc");
+				const string loaded = make_message(modules_loaded, "m1");
+				const string update1 = make_message(update_statistics, "lorem ipsum");
+				const string update2 = make_message(update_statistics, "dolor sit amet");
+				const string update3 = make_message(update_statistics, "x");
+
+				// ACT
+				write(w, init_);	// 8 bytes
+				write(w, update1);	// 24 bytes - the limit is reached, but the message stays in the segment.
+				write(w, loaded);
+				write(w, update2);
+				write(w, update3);
+
+				// ASSERT
+				string reference0[] = {	init_, update1,	};
+				string reference1[] = {	init_, loaded, update2,	};
+				string reference2[] = {	init_, loaded, update3,	};
+
+				assert_equal(3u, segments.size());
+				assert_equal(reference0, read(segments[0]));
+				assert_equal(reference1, read(segments[1]));
+				assert_equal(reference2, read(segments[2]));
+			}
+
+
+			test( StateMessagesAreReplayedInArrivalOrder )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 1);
+				const string init_ = make_message(init, "abc");
+				const string registered = make_message(register_addresses, "r");
+				const string unloaded = make_message(modules_unloaded, "u");
+				const string update1 = make_message(update_statistics, "s");
+				const string update2 = make_message(update_statistics, "t");
+
+				// ACT
+				write(w, init_);
+				write(w, registered);
+				write(w, unloaded);
+				write(w, update1);
+				write(w, update2);
+
+				// ASSERT
+				string reference1[] = {	init_, registered,	};
+				string reference2[] = {	init_, registered, unloaded,	};
+				string reference3[] = {	init_, registered, unloaded, update1,	};
+				string reference4[] = {	init_, registered, unloaded, update2,	};
+
+				assert_equal(5u, segments.size());
+				assert_equal(reference1, read(segments[1]));
+				assert_equal(reference2, read(segments[2]));
+				assert_equal(reference3, read(segments[3]));
+				assert_equal(reference4, read(segments[4]));
+			}
+
+
+			test( CompressedStateMessagesAreReplayedAsTheyWereReceived )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 1);
+				const string init_ = make_message(init, "abc");
+				const string loaded = make_compressed(make_message(modules_loaded, string(100, 'm')));
+				const string update1 = make_compressed(make_message(update_statistics, string(100, 's')));
+				const string update2 = make_message(update_statistics, "t");
+
+				// ACT
+				write(w, init_);
+				write(w, loaded);
+				write(w, update1);
+				write(w, update2);
+
+				// ASSERT
+				string reference[] = {	init_, loaded, update2,	};
+
+				assert_equal(reference, read(segments[3]));
+			}
+
+
+			test( CallPathNodesReceivedSoFarAreReplayedWithoutTimes )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 1);
+				call_paths paths;
+				const string init_ = make_message(init, "abc");
+				const string update = make_message(update_statistics, "t");
+
+				paths.add_time(paths.intern(call_paths::root, 0x1000), 10);
+				paths.add_time(paths.intern(1, 0x2000), 3);
+
+				const string update_paths1 = make_message(paths);
+
+				paths.commit();
+				paths.add_time(paths.intern(1, 0x3000), 7);
+				paths.add_time(1, 11);
+
+				const string update_paths2 = make_compressed(make_message(paths));
+
+				// ACT
+				write(w, init_);
+				write(w, update_paths1);
+				write(w, update_paths2);
+				write(w, update);
+
+				// ASSERT
+				vector<string> messages = read(segments[3]);
+				vector_adapter buffer;
+				strmd::deserializer<vector_adapter, packer> ds(buffer);
+				call_paths replayed;
+				commands c;
+
+				assert_equal(3u, messages.size());
+				assert_equal(init_, messages[0]);
+				assert_equal(update, messages[2]);
+
+				buffer.buffer.assign(messages[1].begin(), messages[1].end());
+				ds(c);
+				ds(replayed);
+
+				assert_equal(update_call_paths, c);
+				assert_equal(4u, replayed.size());
+				assert_equal(0u, replayed[1].parent);
+				assert_equal(0x1000u, replayed[1].function);
+				assert_equal(1u, replayed[2].parent);
+				assert_equal(0x2000u, replayed[2].function);
+				assert_equal(1u, replayed[3].parent);
+				assert_equal(0x3000u, replayed[3].function);
+				for (call_paths::path_id i = 0; i != 4; ++i)
+					assert_equal(timestamp_t(), replayed[i].exclusive_time);
+			}
+
+
+			test( TruncatedRecordingIsReadUpToTheLastCompleteMessage )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 0);
+
+				write(w, "init");
+				write(w, "lorem");
+
+				// ACT / ASSERT
+				string reference[] = {	"init",	};
+
+				assert_equal(reference, read(segments[0].substr(0, segments[0].size() - 1), false));
+				assert_equal(reference, read(segments[0].substr(0, 10), false));
+				assert_equal(reference, read(segments[0].substr(0, 8)));
+			}
+
+
+			test( ReadingStopsWhenTheChannelRefusesAMessage )
+			{
+				// INIT
+				vector<string> segments;
+				recording_writer w(bind(&append_to_segment, ref(segments), _1, _2, _3), 0);
+				int calls = 0;
+
+				write(w, "init");
+				write(w, "lorem");
+
+				// ACT / ASSERT
+				assert_is_false(read_recording(bind(&refuse_message, ref(calls), _1, _2), segments[0].data(),
+					segments[0].size()));
+				assert_equal(1, calls);
+			}
+		end_test_suite
+	}
+}
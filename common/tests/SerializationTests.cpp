@@ -134,9 +134,6 @@ namespace micro_profiler
 				static_cast<function_statistics &>(s1) = function_statistics(17, 2012, 123123123, 32123, 2213);
 				s1.callees[(void *)7741] = function_statistics(1117, 212, 1231123, 3213, 112213);
 				s1.callees[(void *)141] = function_statistics(17, 12012, 11293123, 132123, 12213);
-				s1.callers[(void *)14100] = 1232;
-				s1.callers[(void *)14101] = 12322;
-				s1.callers[(void *)141000] = 123221;
 
 				// ACT
 				s(s1);
@@ -145,7 +142,6 @@ namespace micro_profiler
 				strmd::deserializer<vector_adapter, packer> ds(buffer);
 				function_statistics_detailed ds1;
 				vector< pair<const void *, function_statistics> > callees;
-				vector< pair<const void *, count_t> > callers;
 
 				// ACT
 				ds(ds1);
@@ -239,49 +235,6 @@ namespace micro_profiler
 			}
 
 
-			test( CallersInDetailedStatisticsMapUpdatedOnDeserialization )
-			{
-				// INIT
-				vector_adapter buffer;
-				strmd::serializer<vector_adapter, packer> s(buffer);
-				statistics_map_detailed ss;
-				statistics_map_detailed dss;
-
-				ss[(void *)1221].callees[(void *)1221] = function_statistics(17, 0, 0, 0, 0);
-				ss[(void *)1221].callees[(void *)1231] = function_statistics(18, 0, 0, 0, 0);
-				ss[(void *)1221].callees[(void *)1241] = function_statistics(19, 0, 0, 0, 0);
-				ss[(void *)1222].callees[(void *)1221] = function_statistics(8, 0, 0, 0, 0);
-				ss[(void *)1222].callees[(void *)1251] = function_statistics(9, 0, 0, 0, 0);
-
-				s(ss);
-
-				strmd::deserializer<vector_adapter, packer> ds(buffer);
-
-				// ACT
-				ds(dss);
-
-				// ASSERT
-				pair<const void *, count_t> reference_1221[] = {
-					make_pair((void *)1221, 17),
-					make_pair((void *)1222, 8),
-				};
-				pair<const void *, count_t> reference_1231[] = {
-					make_pair((void *)1221, 18),
-				};
-				pair<const void *, count_t> reference_1241[] = {
-					make_pair((void *)1221, 19),
-				};
-				pair<const void *, count_t> reference_1251[] = {
-					make_pair((void *)1222, 9),
-				};
-
-				assert_equivalent(reference_1221, mkvector(dss[(void *)1221].callers));
-				assert_equivalent(reference_1231, mkvector(dss[(void *)1231].callers));
-				assert_equivalent(reference_1241, mkvector(dss[(void *)1241].callers));
-				assert_equivalent(reference_1251, mkvector(dss[(void *)1251].callers));
-			}
-
-
 			vector<const void *> updated_entries;
 
 			void entry_updated(const void *updated_function)
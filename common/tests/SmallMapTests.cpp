@@ -0,0 +1,224 @@
+#include <common/small_map.h>
+
+#include <common/primitives.h>
+#include <test-helpers/helpers.h>
+
+#include <map>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			typedef small_map<unsigned int, int, address_compare, 4> test_map;
+			typedef pair<unsigned int, int> entry;
+		}
+
+		begin_test_suite( SmallMapTests )
+			test( NewMapIsEmpty )
+			{
+				// INIT / ACT
+				test_map m;
+
+				// ASSERT
+				assert_is_empty(m);
+				assert_equal(0u, m.size());
+				assert_is_true(m.begin() == m.end());
+				assert_is_true(m.find(10) == m.end());
+			}
+
+
+			test( InlineEntriesAreKeptSortedByKey )
+			{
+				// INIT
+				test_map m;
+
+				// ACT
+				m[30] = 3;
+				m[10] = 1;
+				m[40] = 4;
+				m[20] = 2;
+
+				// ASSERT
+				entry reference[] = {	entry(10, 1), entry(20, 2), entry(30, 3), entry(40, 4),	};
+
+				assert_equal(reference, mkvector(m));
+				assert_equal(3, m.find(30)->second);
+				assert_is_true(m.find(25) == m.end());
+			}
+
+
+			test( ExistingEntriesAreReturnedOnSubscript )
+			{
+				// INIT
+				test_map m;
+
+				m[7] = 1;
+				m[3] = 2;
+
+				// ACT
+				m[7] += 10;
+				m[3] += 20;
+
+				// ASSERT
+				assert_equal(2u, m.size());
+				assert_equal(11, m[7]);
+				assert_equal(22, m[3]);
+			}
+
+
+			test( EntriesArePreservedWhenGrowingPastInlineCapacity )
+			{
+				// INIT
+				test_map m;
+				map<unsigned int, int> reference;
+
+				// ACT
+				for (unsigned int i = 0; i != 1000; ++i)
+				{
+					unsigned int key = (i * 7919) % 1009 * 16;
+
+					m[key] += i;
+					reference[key] += i;
+				}
+
+				// ASSERT
+				assert_equal(reference.size(), m.size());
+				assert_equal(reference, (map<unsigned int, int>(m.begin(), m.end())));
+				for (map<unsigned int, int>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+				{
+					assert_is_true(m.find(i->first) != m.end());
+					assert_equal(i->second, m.find(i->first)->second);
+				}
+				assert_is_true(m.find(17) == m.end());
+			}
+
+
+			test( MapsAreCopiedAndSwapped )
+			{
+				// INIT
+				test_map small, large;
+
+				small[1] = 10;
+				small[2] = 20;
+				for (unsigned int i = 0; i != 10; ++i)
+					large[i * 16] = i;
+
+				// ACT
+				test_map copy(large);
+
+				small.swap(large);
+
+				// ASSERT
+				entry reference[] = {	entry(1, 10), entry(2, 20),	};
+
+				assert_equal(10u, small.size());
+				assert_equal(10u, copy.size());
+				assert_equal(mkvector(copy), mkvector(small));
+				assert_equal(9, small[144]);
+				assert_equal(reference, mkvector(large));
+			}
+
+
+			test( ClearedMapIsEmptyAndReusable )
+			{
+				// INIT
+				test_map m;
+
+				for (unsigned int i = 0; i != 10; ++i)
+					m[i] = i;
+
+				// ACT
+				m.clear();
+
+				// ASSERT
+				assert_is_empty(m);
+				assert_is_true(m.find(3) == m.end());
+
+				// ACT
+				m[5] = 1;
+
+				// ASSERT
+				assert_equal(1u, m.size());
+				assert_equal(1, m[5]);
+			}
+
+
+			test( InlineEntriesAreErasedByKey )
+			{
+				// INIT
+				test_map m;
+
+				m[30] = 3, m[10] = 1, m[20] = 2;
+
+				// ACT / ASSERT
+				assert_equal(1u, m.erase(20));
+				assert_equal(0u, m.erase(20));
+				assert_equal(0u, m.erase(15));
+
+				// ASSERT
+				entry reference1[] = {	entry(10, 1), entry(30, 3),	};
+
+				assert_equal(reference1, mkvector(m));
+
+				// ACT
+				m.erase(10);
+				m.erase(30);
+
+				// ASSERT
+				assert_is_empty(m);
+			}
+
+
+			test( SpilledEntriesAreErasedWithOthersKeptReachable )
+			{
+				// INIT
+				test_map m;
+				map<unsigned int, int> reference;
+
+				for (unsigned int i = 0; i != 300; ++i)
+				{
+					unsigned int key = (i * 7919) % 1009 * 16;
+
+					m[key] = i;
+					reference[key] = i;
+				}
+
+				// ACT
+				for (unsigned int i = 0; i != 1009; i += 3)
+				{
+					assert_equal(reference.erase(i * 16), m.erase(i * 16));
+				}
+
+				// ASSERT
+				assert_equal(reference.size(), m.size());
+				assert_equal(reference, (map<unsigned int, int>(m.begin(), m.end())));
+				for (map<unsigned int, int>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+					assert_equal(i->second, m.find(i->first)->second);
+
+				// ACT
+				while (!reference.empty())
+				{
+					m.erase(reference.begin()->first);
+					reference.erase(reference.begin());
+				}
+
+				// ASSERT
+				assert_is_empty(m);
+				assert_is_true(m.begin() == m.end());
+
+				// ACT
+				m[5] = 1;
+
+				// ASSERT
+				assert_equal(1u, m.size());
+				assert_equal(1, m[5]);
+			}
+		end_test_suite
+	}
+}
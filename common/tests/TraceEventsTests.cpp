@@ -0,0 +1,172 @@
+#include <common/trace_events.h>
+
+#include <test-helpers/helpers.h>
+
+#include <string>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			void append_chunk(vector<string> &chunks, const void *buffer, size_t size)
+			{	chunks.push_back(string(static_cast<const char *>(buffer), size));	}
+
+			string join(const vector<string> &chunks)
+			{
+				string result;
+
+				for (vector<string>::const_iterator i = chunks.begin(); i != chunks.end(); ++i)
+					result += *i;
+				return result;
+			}
+		}
+
+		begin_test_suite( TraceEventsWriterTests )
+			test( ClosingEmptyWriterProducesEmptyEventsList )
+			{
+				// INIT
+				vector<string> chunks;
+				trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000);
+
+				// ACT
+				w.close();
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":[\n]}\n", join(chunks));
+			}
+
+
+			test( WriterIsClosedOnDestruction )
+			{
+				// INIT
+				vector<string> chunks;
+
+				// ACT
+				{
+					trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000);
+
+					// ASSERT
+					assert_is_empty(chunks);
+				}
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":[\n]}\n", join(chunks));
+			}
+
+
+			test( BeginAndEndEventsAreWrittenInMicrosecondsRelativeToOrigin )
+			{
+				// INIT
+				vector<string> chunks;
+				trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000000000, 100000, 17);
+
+				// ACT
+				w.begin(3, 101000, 0x1234);
+				w.begin(3, 101234, 0xABCDEF012345);
+				w.end(3, 1100001);
+				w.end(11, 99990);
+				w.close();
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":17,\"tid\":3,\"ts\":1.000,\"name\":\"0x1234\"},"
+					"\n{\"ph\":\"B\",\"pid\":17,\"tid\":3,\"ts\":1.234,\"name\":\"0xabcdef012345\"},"
+					"\n{\"ph\":\"E\",\"pid\":17,\"tid\":3,\"ts\":1000.001},"
+					"\n{\"ph\":\"E\",\"pid\":17,\"tid\":11,\"ts\":-0.010}"
+					"\n]}\n", join(chunks));
+			}
+
+
+			test( CallRecordsAreWrittenAsBeginEndEvents )
+			{
+				// INIT
+				vector<string> chunks;
+				trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000);
+				call_record trace[] = {
+					{	1, (void *)0x100	},
+					{	3, (void *)0	},
+				};
+
+				// ACT
+				w.write(5, trace, array_size(trace));
+				w.close();
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":5,\"ts\":1000.000,\"name\":\"0x100\"},"
+					"\n{\"ph\":\"E\",\"pid\":1,\"tid\":5,\"ts\":3000.000}"
+					"\n]}\n", join(chunks));
+			}
+
+
+			test( ThreadNamesAreEscaped )
+			{
+				// INIT
+				vector<string> chunks;
+				trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000);
+
+				// ACT
+				w.thread_name(7, "a \"worker\"\\\n");
+				w.close();
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"M\",\"pid\":1,\"tid\":7,\"name\":\"thread_name\",\"args\":{\"name\":\"a \\\"worker\\\"\\\\\\u000a\"}}"
+					"\n]}\n", join(chunks));
+			}
+
+
+			test( NamedBeginEventsAreEscaped )
+			{
+				// INIT
+				vector<string> chunks;
+				trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000);
+
+				// ACT
+				w.begin(2, 1, "c:\\lib \"x\".dll+0x1f");
+				w.close();
+
+				// ASSERT
+				assert_equal("{\"traceEvents\":["
+					"\n{\"ph\":\"B\",\"pid\":1,\"tid\":2,\"ts\":1000.000,\"name\":\"c:\\\\lib \\\"x\\\".dll+0x1f\"}"
+					"\n]}\n", join(chunks));
+			}
+
+
+			test( OutputIsDeliveredInChunksOfFixedSize )
+			{
+				// INIT
+				vector<string> chunks, reference_chunks;
+				trace_events_writer w(bind(&append_chunk, ref(chunks), _1, _2), 1000, 0, 1, 100);
+				trace_events_writer reference(bind(&append_chunk, ref(reference_chunks), _1, _2), 1000, 0, 1, 1000000);
+
+				// ACT
+				for (int i = 0; i != 1000; ++i)
+				{
+					w.begin(i % 3, i, 0x1000 + i), reference.begin(i % 3, i, 0x1000 + i);
+					w.end(i % 3, i + 1), reference.end(i % 3, i + 1);
+				}
+
+				// ASSERT
+				assert_is_true(chunks.size() > 100);
+				for (vector<string>::const_iterator i = chunks.begin(); i != chunks.end(); ++i)
+					assert_equal(100u, i->size());
+
+				// ACT
+				w.close();
+				reference.close();
+
+				// ASSERT
+				assert_is_true(chunks.back().size() <= 100u);
+				assert_equal(join(reference_chunks), join(chunks));
+			}
+		end_test_suite
+	}
+}
@@ -0,0 +1,74 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+#include <functional>
+#include <vector>
+
+namespace micro_profiler
+{
+	// Streams call events in Chrome trace-event JSON format (loadable by chrome://tracing and Perfetto). Output is
+	// accumulated in a fixed-size chunk, that is handed over to the sink each time it fills up, so the size of a
+	// trace written is not limited by memory.
+	class trace_events_writer
+	{
+	public:
+		typedef std::function<void (const void *buffer, size_t size)> sink_t;
+
+		enum {	default_chunk_size = 0x10000	};
+
+	public:
+		trace_events_writer(const sink_t &sink, timestamp_t ticks_per_second, timestamp_t origin = 0,
+			unsigned int pid = 1, size_t chunk_size = default_chunk_size);
+		~trace_events_writer();
+
+		void thread_name(unsigned int threadid, const char *name);
+		void begin(unsigned int threadid, timestamp_t timestamp, long_address_t function);
+		void begin(unsigned int threadid, timestamp_t timestamp, const char *name);
+		void end(unsigned int threadid, timestamp_t timestamp);
+		void write(unsigned int threadid, const call_record *calls, size_t count);
+		void close();
+
+	private:
+		trace_events_writer(const trace_events_writer &other);
+		void operator =(const trace_events_writer &rhs);
+
+		void event_prologue(char phase, unsigned int threadid);
+		void append(const char *text);
+		void append(char c);
+		void append_escaped(const char *text);
+		void append_decimal(unsigned long long value);
+		void append_hex(unsigned long long value);
+		void append_timestamp(timestamp_t timestamp);
+		void flush();
+
+	private:
+		const sink_t _sink;
+		const double _nanoseconds_per_tick;
+		const timestamp_t _origin;
+		const unsigned int _pid;
+		std::vector<char> _chunk;
+		size_t _chunk_size;
+		bool _first, _closed;
+	};
+}
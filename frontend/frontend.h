@@ -21,16 +21,17 @@
 #pragma once
 
 #include "frontend_manager.h"
+#include "message_processor.h"
 
 #include <resources/resource.h>
 
 #include <atlbase.h>
 #include <atlcom.h>
+#include <vector>
 
 namespace micro_profiler
 {
 	class frontend_manager_impl;
-	struct symbol_resolver;
 
 	class ATL_NO_VTABLE Frontend : public ISequentialStream, public CComObjectRootEx<CComSingleThreadModel>,
 		public CComCoClass<Frontend>, public frontend
@@ -54,7 +55,6 @@ namespace micro_profiler
 		STDMETHODIMP Write(const void *message, ULONG size, ULONG *written);
 
 	private:
-		const std::shared_ptr<symbol_resolver> _resolver;
-		std::shared_ptr<functions_list> _model;
+		message_processor _processor;
 	};
 }
@@ -23,28 +23,54 @@
 #include "statistics_model.h"
 
 #include "primitives.h"
+#include "statistics_epochs.h"
 
+#include <common/address_dictionary.h>
+#include <common/call_paths.h>
+#include <common/statistics_file.h>
 #include <wpl/ui/listview.h>
+#include <functional>
 #include <string>
 #include <memory>
 
 namespace micro_profiler
 {
+	struct columnar_update;
+
 	struct linked_statistics : wpl::ui::listview::model
 	{
+		virtual index_type get_index(address_t address) const = 0;
 		virtual address_t get_address(index_type item) const = 0;
 	};
 
 	class functions_list : public statistics_model_impl<wpl::ui::listview::model, statistics_map_detailed>
 	{
+	public:
+		// Returns monotonic time in seconds. Used to place incoming updates into epochs.
+		typedef std::function<double ()> time_source;
+
 	public:
 		void clear();
+		void merge(const columnar_update &update);
+
+		// Merges an update_format_indexed update, resolving its ids against addresses().
+		template <typename ArchiveT>
+		void merge_indexed(ArchiveT &archive);
+
 		void print(std::wstring &content) const;
+		void print_folded(std::wstring &content) const;
+		call_paths &paths() throw();
+		address_index<address_t> &addresses() throw();
 		std::shared_ptr<linked_statistics> watch_children(index_type item) const;
 		std::shared_ptr<linked_statistics> watch_parents(index_type item) const;
+		std::shared_ptr<linked_statistics> watch_window(double seconds) const;
+
+		// Moves the windows watched to the current time. Incoming updates move them too, so this is only needed to
+		// have them empty out while no updates come.
+		void advance_windows();
 
 		static std::shared_ptr<functions_list> create(timestamp_t ticks_per_second,
-			std::shared_ptr<symbol_resolver> resolver);
+			std::shared_ptr<symbol_resolver> resolver, const time_source &clock = time_source());
 
 		template <typename ArchiveT>
 		void save(ArchiveT &archive) const;
@@ -57,13 +83,18 @@ namespace micro_profiler
 
 	private:
 		functions_list(std::shared_ptr<statistics_map_detailed> statistics, double tick_interval,
-			std::shared_ptr<symbol_resolver> resolver);
+			std::shared_ptr<symbol_resolver> resolver, const time_source &clock);
 
 	private:
 		std::shared_ptr<statistics_map_detailed> _statistics;
 		double _tick_interval;
 		std::shared_ptr<symbol_resolver> _resolver;
+		call_paths _paths;
+		address_index<address_t> _addresses;
+		time_source _clock;
+		std::shared_ptr<statistics_epochs> _epochs;
 		mutable wpl::signal<void()> _cleared;
+		mutable wpl::signal<void()> _epochs_updated;
 
 	private:
 		template <typename ArchiveT>
@@ -80,28 +111,53 @@ namespace micro_profiler
 
 
 
+	template <typename ArchiveT>
+	inline void functions_list::merge_indexed(ArchiveT &archive)
+	{
+		statistics_map delta;
+		indexed_update_t<address_t> update = {	*_statistics, delta, _addresses	};
+
+		archive(update);
+		updated(delta);
+		_epochs->add(_clock(), delta);
+		_epochs_updated();
+	}
+
 	template <typename ArchiveT>
 	inline void functions_list::save(ArchiveT &archive) const
 	{
-		archive(static_cast<timestamp_t>(1 / _tick_interval));
-		archive(_statistics->size());
-		for (statistics_map_detailed::const_iterator i = _statistics->begin(); i != _statistics->end(); ++i)
-			archive(make_pair(i->first, _resolver->symbol_name_by_va(i->first)));
-		archive(*_statistics);
+		save_statistics_file(archive, static_cast<timestamp_t>(1 / _tick_interval), *_statistics, _paths,
+			std::bind(&symbol_resolver::symbol_name_by_va, _resolver, std::placeholders::_1));
 	}
 
 	template <typename ArchiveT>
 	inline std::shared_ptr<functions_list> functions_list::load(ArchiveT &archive)
 	{
+		unsigned int version = 0;
 		timestamp_t ticks_per_second;
 		std::shared_ptr<static_resolver> resolver(new static_resolver);
 
 		archive(ticks_per_second);
+		if (!ticks_per_second)
+		{
+			archive(version);
+			archive(ticks_per_second);
+		}
 		archive(resolver->symbols);
 
 		std::shared_ptr<functions_list> fl(create(ticks_per_second, resolver));
 
-		archive(*fl->_statistics);
+		if (version)
+		{
+			archive(*fl->_statistics);
+			archive(fl->_paths);
+		}
+		else
+		{
+			statistics_without_latencies_t<address_t> statistics = {	*fl->_statistics	};
+
+			archive(statistics);
+		}
 		fl->updated();
 		return fl;
 	}
@@ -110,7 +166,12 @@ namespace micro_profiler
 	template <typename ArchiveT>
 	void serialize(ArchiveT &archive, functions_list &data)
 	{
-		archive(*data._statistics);
-		data.updated();
+		statistics_map delta;
+		statistics_update_t<address_t> update = {	*data._statistics, delta	};
+
+		archive(update);
+		data.updated(delta);
+		data._epochs->add(data._clock(), delta);
+		data._epochs_updated();
 	}
 }
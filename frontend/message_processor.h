@@ -0,0 +1,63 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <common/protocol.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace micro_profiler
+{
+	class functions_list;
+	struct symbol_resolver;
+
+	// Applies the messages a collector sends (see common/protocol.h) to the statistics model they describe. The model
+	// is created on the init message and passed to the 'initialized' callback. Throws std::out_of_range for a message
+	// that is truncated or refers to unknown data.
+	class message_processor
+	{
+	public:
+		typedef std::function<void (const std::wstring &executable, const std::shared_ptr<functions_list> &model)>
+			initialized_t;
+
+	public:
+		message_processor(const std::shared_ptr<symbol_resolver> &resolver, const initialized_t &initialized);
+
+		void process(const void *message, size_t size);
+
+	private:
+		void process(const byte *message, size_t size, bool allow_compressed);
+
+	private:
+		const std::shared_ptr<symbol_resolver> _resolver;
+		const initialized_t _initialized;
+		std::shared_ptr<functions_list> _model;
+		update_formats _statistics_format;
+	};
+
+	// Loads a single segment of a recording made by the collector (see common/recording.h) into a new model. Loading
+	// stops at a message that cannot be processed or at a truncated frame, keeping what was loaded before it. Returns an
+	// empty pointer if the segment has no init message.
+	std::shared_ptr<functions_list> load_recording(const std::shared_ptr<symbol_resolver> &resolver,
+		const void *data, size_t size, std::wstring &executable);
+}
@@ -18,14 +18,32 @@
 //	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //	THE SOFTWARE.
 
+
 #pragma once
 
+#include <common/parallel_sort.h>
+
+#include <functional>
 #include <memory>
 #include <vector>
 #include <algorithm>
 
 namespace micro_profiler
 {
+	// Base for the key extractors accepted by ordered_view::set_order_by_key(). An extractor defines
+	// 'result_type operator ()(const key_type &key, const mapped_type &value) const' computing a cheaply comparable
+	// key of an entry. prepare() receives the entries of each sorting pass (iterators to the map's const_iterators)
+	// before their keys are extracted and may precompute what the keys are built from.
+	template <typename ResultT>
+	struct sort_key_extractor
+	{
+		typedef ResultT result_type;
+
+		template <typename IteratorT>
+		void prepare(IteratorT /*begin*/, IteratorT /*end*/) const
+		{	}
+	};
+
 	template <class Map>
 	class ordered_view
 	{
@@ -35,6 +53,9 @@ namespace micro_profiler
 
 		static const size_t npos = static_cast<size_t>(-1);
 
+		// Number of leading entries ordered eagerly. The rest are only known to follow them and are ordered on access.
+		static const size_t sorted_window = 256;
+
 	public:
 		ordered_view(const Map &map);
 
@@ -45,11 +66,25 @@ namespace micro_profiler
 		template <typename Predicate>
 		void set_order(Predicate predicate, bool ascending);
 
+		// Same as set_order(), but entries are compared by the keys the extractor computes once per sorting pass (see
+		// sort_key_extractor) rather than through the map nodes. Large views are sorted in parallel.
+		template <typename KeyExtractorT>
+		void set_order_by_key(KeyExtractorT extractor, bool ascending);
+
 		// Repopulate internal ordered storage from source map with respect to predicate set.
 		void resort();
 
+		// Restores the order after the entries keyed in 'changed' (any map keyed as the source one) were updated in
+		// place: only these are sorted and merged back. Falls back to the full resort if entries were added.
+		template <typename ChangedMapT>
+		void resort(const ChangedMapT &changed);
+
 		size_t size() const throw();
+
+		// Orders the entries through the one requested first, if it lies past the ordered part.
 		const value_type &at(size_t index) const;
+
+		// Takes constant time: positions are indexed on the first lookup after the order changes.
 		size_t find_by_key(const key_type &key) const;
 
 	private:
@@ -61,15 +96,31 @@ namespace micro_profiler
 		template <typename Predicate>
 		class sorter_impl;
 
+		template <typename KeyExtractorT>
+		class key_sorter;
+
 	private:
 		// Repopulate internal storage with data from source map, ignores any predicate set.
 		void fetch_data();
 
+		// Orders the storage anew, eagerly through the sorted window only.
+		void reorder();
+
+		// Extends the ordered part to at least 'count' entries (at least doubling it), selecting the entries that go
+		// there from the rest.
+		void order(size_t count) const;
+
+		void build_index() const;
+		size_t locate(const key_type &key) const;
+		static size_t hash(const stored_type &entry);
+
 		const ordered_view &operator =(const ordered_view &);
 
 	private:
 		const Map *_map;
-		ordered_storage _ordered_data;
+		mutable ordered_storage _ordered_data;
+		mutable size_t _sorted;	// Entries [0, _sorted) are in their final order and precede any other entry.
+		mutable std::vector<unsigned int> _index;	// Open-addressing table of positions plus one (zero marks a free slot).
 		std::auto_ptr<sorter> _sorter;
 	};
 
@@ -84,7 +135,11 @@ namespace micro_profiler
 
 		virtual ~sorter()	{	}
 
-		virtual void sort(target_iterator begin, target_iterator end) const = 0;
+		// Puts the least (middle - begin) entries of [begin, end) in order in front of the rest, which are left
+		// unordered.
+		virtual void sort(target_iterator begin, target_iterator middle, target_iterator end) const = 0;
+
+		virtual bool precedes(const typename Map::const_iterator &lhs, const typename Map::const_iterator &rhs) const = 0;
 	};
 
 
@@ -100,10 +155,28 @@ namespace micro_profiler
 			: _predicate(predicate), _ascending(ascending)
 		{	}
 
-		virtual void sort(typename sorter::target_iterator begin, typename sorter::target_iterator end) const
-		{	std::sort(begin, end, *this);	}
+		virtual void sort(typename sorter::target_iterator begin, typename sorter::target_iterator middle,
+			typename sorter::target_iterator end) const
+		{
+			if (middle != end)
+				std::nth_element(begin, middle, end, *this);
+			std::sort(begin, middle, *this);
+		}
 
+		virtual bool precedes(const typename Map::const_iterator &lhs, const typename Map::const_iterator &rhs) const
+		{	return (*this)(lhs, rhs);	}
+
+		// Entries equivalent by the predicate are ordered by key, so that the order is total and an incremental
+		// resort yields exactly the same sequence as the full one.
 		bool operator ()(const typename Map::const_iterator &lhs, const typename Map::const_iterator &rhs) const
+		{
+			if (less(lhs, rhs))
+				return true;
+			return !less(rhs, lhs) && std::less<typename Map::key_type>()(lhs->first, rhs->first);
+		}
+
+	private:
+		bool less(const typename Map::const_iterator &lhs, const typename Map::const_iterator &rhs) const
 		{	return _ascending ? _predicate(lhs->first, lhs->second, rhs->first, rhs->second) : _predicate(rhs->first, rhs->second, lhs->first, lhs->second);	}
 
 	private:
@@ -112,18 +185,113 @@ namespace micro_profiler
 	};
 
 
+	// Key sorter implementation.
+	// Keys are extracted into a contiguous array along with the map keys breaking the ties (as sorter_impl does), so
+	// the comparisons never leave it. Since the comparisons do not touch the map or the extractor, the array is sorted
+	// in parallel once it is large enough.
+	template <class Map>
+	template <typename KeyExtractorT>
+	class ordered_view<Map>::key_sorter : public ordered_view<Map>::sorter
+	{
+	public:
+		key_sorter(KeyExtractorT extractor, bool ascending)
+			: _extractor(extractor)
+		{	_less.ascending = ascending;	}
+
+		virtual void sort(typename sorter::target_iterator begin, typename sorter::target_iterator middle,
+			typename sorter::target_iterator end) const
+		{
+			extract(begin, end);
+
+			const typename std::vector<keyed_entry>::iterator keyed_middle = _keyed.begin() + (middle - begin);
+
+			if (middle != end)
+				std::nth_element(_keyed.begin(), keyed_middle, _keyed.end(), _less);
+			parallel_sort(_keyed.begin(), keyed_middle, _less, c_parallel_threshold, hardware_threads());
+			store(begin);
+		}
+
+		virtual bool precedes(const typename Map::const_iterator &lhs, const typename Map::const_iterator &rhs) const
+		{
+			keyed_entry l, r;
+
+			_extractor.prepare(&lhs, &lhs + 1);
+			_extractor.prepare(&rhs, &rhs + 1);
+			make_entry(l, lhs);
+			make_entry(r, rhs);
+			return _less(l, r);
+		}
+
+	private:
+		struct keyed_entry
+		{
+			typename KeyExtractorT::result_type key;
+			typename Map::key_type map_key;
+			typename Map::const_iterator entry;
+		};
+
+		struct less
+		{
+			bool operator ()(const keyed_entry &lhs, const keyed_entry &rhs) const
+			{
+				if (lhs.key < rhs.key)
+					return ascending;
+				else if (rhs.key < lhs.key)
+					return !ascending;
+				return std::less<typename Map::key_type>()(lhs.map_key, rhs.map_key);
+			}
+
+			bool ascending;
+		};
+
+		static const size_t c_parallel_threshold = 1 << 16;
+
+	private:
+		void extract(typename sorter::target_iterator begin, typename sorter::target_iterator end) const
+		{
+			_extractor.prepare(begin, end);
+			_keyed.resize(end - begin);
+			for (typename std::vector<keyed_entry>::iterator i = _keyed.begin(); begin != end; ++begin, ++i)
+				make_entry(*i, *begin);
+		}
+
+		void store(typename sorter::target_iterator begin) const
+		{
+			for (typename std::vector<keyed_entry>::const_iterator i = _keyed.begin(); i != _keyed.end(); ++i, ++begin)
+				*begin = i->entry;
+		}
+
+		void make_entry(keyed_entry &e, const typename Map::const_iterator &entry) const
+		{
+			e.key = _extractor(entry->first, entry->second);
+			e.map_key = entry->first;
+			e.entry = entry;
+		}
+
+	private:
+		KeyExtractorT _extractor;
+		less _less;
+		mutable std::vector<keyed_entry> _keyed;
+	};
+
+
 
 	/// ordered_view implementation
 	template <class Map>
 	inline ordered_view<Map>::ordered_view(const Map &map)
-		: _map(&map)
-	{	fetch_data();	}
+		: _map(&map), _sorted(0)
+	{
+		fetch_data();
+		reorder();
+	}
 
 	template <class Map>
 	inline void ordered_view<Map>::detach() throw()
 	{
 		_map = 0;
 		_ordered_data.clear();
+		_sorted = 0;
+		_index.clear();
 	}
 
 	template <class Map>
@@ -135,16 +303,97 @@ namespace micro_profiler
 	inline void ordered_view<Map>::set_order(Predicate predicate, bool ascending)
 	{
 		_sorter.reset(new sorter_impl<Predicate>(predicate, ascending));
-		_sorter->sort(_ordered_data.begin(), _ordered_data.end());
+		reorder();
+	}
+
+	template <class Map>
+	template <typename KeyExtractorT>
+	inline void ordered_view<Map>::set_order_by_key(KeyExtractorT extractor, bool ascending)
+	{
+		_sorter.reset(new key_sorter<KeyExtractorT>(extractor, ascending));
+		reorder();
 	}
 
 	template <class Map>
 	inline void ordered_view<Map>::resort()
 	{
 		fetch_data();
+		reorder();
+	}
 
-		if (_sorter.get())
-			_sorter->sort(_ordered_data.begin(), _ordered_data.end());
+	template <class Map>
+	template <typename ChangedMapT>
+	inline void ordered_view<Map>::resort(const ChangedMapT &changed)
+	{
+		const size_t n = _ordered_data.size();
+
+		// Insertions may have rehashed the map, so the stored iterators are only reused while the size holds.
+		if (!_map || _map->size() != n || 8 * changed.size() > n)
+			return resort();
+		else if (!_sorter.get())
+			return;
+
+		std::vector<size_t> positions;
+
+		positions.reserve(changed.size());
+		for (typename ChangedMapT::const_iterator i = changed.begin(); i != changed.end(); ++i)
+		{
+			const size_t position = locate(i->first);
+
+			if (position == npos)
+				return resort();
+			positions.push_back(position);
+		}
+		if (positions.empty())
+			return;
+		std::sort(positions.begin(), positions.end());
+
+		ordered_storage changed_entries;
+		std::vector<size_t>::const_iterator p = positions.begin();
+		size_t to = *p, sorted = _sorted;
+
+		changed_entries.reserve(positions.size());
+		for (size_t from = to; from != n; ++from)
+		{
+			if (p != positions.end() && *p == from)
+			{
+				changed_entries.push_back(_ordered_data[from]), ++p;
+				if (from < _sorted)
+					--sorted;
+			}
+			else
+			{
+				_ordered_data[to++] = _ordered_data[from];
+			}
+		}
+
+		// Now [0, sorted) is ordered and [sorted, to) is not. The changed entries preceding the last ordered one are
+		// inserted into the ordered part, the rest join the unordered one (or follow the ordered part, if there is no
+		// unordered part left).
+		const typename ordered_storage::iterator data = _ordered_data.begin();
+		const std::function<bool (stored_type, stored_type)> precedes = std::bind(&sorter::precedes, _sorter.get(),
+			std::placeholders::_1, std::placeholders::_2);
+		size_t lower = changed_entries.size();
+
+		_sorter->sort(changed_entries.begin(), changed_entries.end(), changed_entries.end());
+		if (sorted != to)
+		{
+			lower = sorted ? std::lower_bound(changed_entries.begin(), changed_entries.end(), data[sorted - 1], precedes)
+				- changed_entries.begin() : 0;
+		}
+		std::copy_backward(data + sorted, data + to, data + to + lower);
+		std::copy(changed_entries.begin() + lower, changed_entries.end(), data + to + lower);
+		for (size_t j = lower, r = sorted, w = sorted + lower; j--; )
+		{
+			const size_t position = std::lower_bound(data, data + r, changed_entries[j], precedes) - data;
+
+			while (r != position)
+				data[--w] = data[--r];
+			data[--w] = changed_entries[j];
+		}
+		_sorted = sorted + lower;
+		_index.clear();
+		order(sorted_window);
 	}
 
 	template <class Map>
@@ -158,18 +407,107 @@ namespace micro_profiler
 			_ordered_data.push_back(i);
 	}
 
+	template <class Map>
+	inline void ordered_view<Map>::reorder()
+	{
+		_index.clear();
+		if (_sorter.get())
+		{
+			_sorted = 0;
+			order(sorted_window);
+		}
+		else
+		{
+			_sorted = _ordered_data.size();
+		}
+	}
+
+	template <class Map>
+	inline void ordered_view<Map>::order(size_t count) const
+	{
+		const size_t n = _ordered_data.size();
+
+		count = count < n ? count : n;
+		if (count <= _sorted)
+			return;
+		count = count < 2 * _sorted ? 2 * _sorted : count;
+		count = count < n ? count : n;
+		_sorter->sort(_ordered_data.begin() + _sorted, _ordered_data.begin() + count, _ordered_data.end());
+		_sorted = count;
+		_index.clear();
+	}
+
+	template <class Map>
+	inline void ordered_view<Map>::build_index() const
+	{
+		const size_t n = _ordered_data.size();
+		size_t slots = 16;
+
+		while (slots < 2 * n)
+			slots <<= 1;
+		_index.assign(slots, 0);
+		for (size_t i = 0; i != n; ++i)
+		{
+			size_t slot = hash(_ordered_data[i]) & (slots - 1);
+
+			while (_index[slot])
+				slot = (slot + 1) & (slots - 1);
+			_index[slot] = static_cast<unsigned int>(i + 1);
+		}
+	}
+
+	template <class Map>
+	inline size_t ordered_view<Map>::locate(const key_type &key) const
+	{
+		if (!_map || _ordered_data.empty())
+			return npos;
+
+		const stored_type entry = _map->find(key);
+
+		if (entry == _map->end())
+			return npos;
+		if (_index.empty())
+			build_index();
+
+		const size_t mask = _index.size() - 1;
+
+		for (size_t slot = hash(entry) & mask; _index[slot]; slot = (slot + 1) & mask)
+		{
+			if (_ordered_data[_index[slot] - 1] == entry)
+				return _index[slot] - 1;
+		}
+		return npos;
+	}
+
+	template <class Map>
+	inline size_t ordered_view<Map>::hash(const stored_type &entry)
+	{
+		// Entries are hashed by their addresses in the map, so that indexing does not touch them. The addresses are
+		// aligned, so the bits are spread before masking the low ones.
+		const size_t h = reinterpret_cast<size_t>(&*entry) * static_cast<size_t>(2654435761u);
+
+		return h ^ (h >> 15);
+	}
+
 	template <class Map>
 	inline const typename ordered_view<Map>::value_type &ordered_view<Map>::at(size_t index) const
-	{	return *_ordered_data.at(index);	}
+	{
+		if (index < _ordered_data.size())
+			order(index + 1);
+		return *_ordered_data.at(index);
+	}
 
 	template <class Map>
 	inline size_t ordered_view<Map>::find_by_key(const key_type &key) const
 	{
-		for (size_t i = 0; i < _ordered_data.size(); ++i)
+		size_t position = locate(key);
+
+		// An entry in the unordered part is moved as the ordered part grows, so it is looked up anew each time.
+		while (position != npos && position >= _sorted)
 		{
-			if (_ordered_data[i]->first == key)
-				return i;
+			order(position + 1);
+			position = locate(key);
 		}
-		return npos;
+		return position;
 	}
 }
@@ -20,39 +20,16 @@
 
 #include <frontend/frontend.h>
 
-#include <frontend/function_list.h>
 #include <frontend/symbol_resolver.h>
 
-#include <common/serialization.h>
+#include <stdexcept>
 
 using namespace std;
 
 namespace micro_profiler
 {
-	namespace
-	{
-		class buffer_reader
-		{
-		public:
-			buffer_reader(const byte *data, size_t size)
-				: _ptr(data), _remaining(size)
-			{	}
-
-			void read(void *data, size_t size)
-			{
-				memcpy(data, _ptr, size);
-				_ptr += size;
-				_remaining -= size;
-			}
-
-		private:
-			const byte *_ptr;
-			size_t _remaining;
-		};
-	}
-
 	Frontend::Frontend()
-		: _resolver(symbol_resolver::create())
+		: _processor(symbol_resolver::create(), ref(initialized))
 	{	}
 
 	void Frontend::disconnect() throw()
@@ -65,32 +42,17 @@ namespace micro_profiler
 	{	return E_NOTIMPL;	}
 
 	STDMETHODIMP Frontend::Write(const void *message, ULONG size, ULONG * /*written*/)
+	try
 	{
-		buffer_reader reader(static_cast<const byte *>(message), size);
-		strmd::deserializer<buffer_reader, packer> archive(reader);
-		initialization_data idata;
-		loaded_modules lmodules;
-		commands c;
-
-		archive(c);
-		switch (c)
-		{
-		case init:
-			archive(idata);
-			_model = functions_list::create(idata.ticks_per_second, _resolver);
-			initialized(idata.executable, _model);
-			break;
-
-		case modules_loaded:
-			archive(lmodules);
-			for (loaded_modules::const_iterator i = lmodules.begin(); i != lmodules.end(); ++i)
-				_resolver->add_image(i->path.c_str(), i->load_address);
-			break;
-
-		case update_statistics:
-			archive(*_model);
-			break;
-		}
+		_processor.process(message, size);
 		return S_OK;
 	}
+	catch (const bad_alloc &)
+	{
+		return E_OUTOFMEMORY;
+	}
+	catch (const out_of_range &)
+	{
+		return E_INVALIDARG;
+	}
 }
@@ -20,11 +20,21 @@
 
 #include <frontend/function_list.h>
 
+#include <common/columnar.h>
 #include <common/formatting.h>
 
+#include <unordered_map>
 #include <utility>
 #include <cmath>
 #include <clocale>
+#include <vector>
+
+#ifdef _WIN32
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
 
 using namespace std;
 using namespace placeholders;
@@ -36,6 +46,33 @@ namespace micro_profiler
 	namespace
 	{
 		const address_t c_invalid_address = numeric_limits<address_t>::max();
+		const double c_latency_percentiles[] = {	0.5, 0.9, 0.99, 0.999,	};
+
+		const histogram *get_latencies(const function_statistics &/*s*/)
+		{	return 0;	}
+
+		const histogram *get_latencies(const function_statistics_detailed_t<address_t> &s)
+		{	return &s.latencies;	}
+
+		template <typename T>
+		timestamp_t latency_percentile(const T &s, double p)
+		{
+			const histogram *h = get_latencies(s);
+			const timestamp_t value = h ? h->percentile(p) : 0;
+
+			return value < s.max_call_time ? value : s.max_call_time;
+		}
+
+		template <typename T>
+		void format_latency_percentile(wstring &text, const T &s, double p, double tick_interval)
+		{
+			const histogram *h = get_latencies(s);
+
+			if (h && h->total())
+				format_interval(text, tick_interval * latency_percentile(s, p));
+			else
+				text.clear();
+		}
 
 		wstring to_string2(count_t value)
 		{
@@ -66,64 +103,124 @@ namespace micro_profiler
 
 		namespace functors
 		{
-			class by_name
+			// Symbol names are ranked once for all the addresses seen, so that sorting compares integers. Names never
+			// change for an address, so the ranks are only rebuilt when new addresses show up.
+			class by_name : public sort_key_extractor<unsigned int>
 			{
 			public:
 				by_name(shared_ptr<symbol_resolver> resolver)
 					: _resolver(resolver)
 				{	}
 
+				template <typename IteratorT>
+				void prepare(IteratorT begin, IteratorT end) const
+				{
+					bool complete = true;
+
+					for (; begin != end; ++begin)
+						complete = !_ranks.insert(make_pair((*begin)->first, 0u)).second && complete;
+					if (!complete)
+						rank();
+				}
+
 				template <typename AnyT>
-				bool operator ()(address_t lhs_addr, const AnyT &, address_t rhs_addr, const AnyT &) const
-				{	return _resolver->symbol_name_by_va(lhs_addr) < _resolver->symbol_name_by_va(rhs_addr);	}
+				unsigned int operator ()(address_t address, const AnyT &) const
+				{	return _ranks.find(address)->second;	}
+
+			private:
+				typedef unordered_map<address_t, unsigned int, address_compare> ranks_map;
+				typedef pair<const wstring *, address_t> named_address;
+
+			private:
+				void rank() const
+				{
+					vector<named_address> names;
+
+					names.reserve(_ranks.size());
+					for (ranks_map::const_iterator i = _ranks.begin(); i != _ranks.end(); ++i)
+						names.push_back(make_pair(&_resolver->symbol_name_by_va(i->first), i->first));
+					sort(names.begin(), names.end(), &name_less);
+					for (unsigned int i = 0, rank = 0; i != names.size(); ++i)
+					{
+						if (i && name_less(names[i - 1], names[i]))
+							++rank;
+						_ranks[names[i].second] = rank;
+					}
+				}
+
+				static bool name_less(const named_address &lhs, const named_address &rhs)
+				{	return *lhs.first < *rhs.first;	}
 
 			private:
 				shared_ptr<symbol_resolver> _resolver;
+				mutable ranks_map _ranks;
 			};
 
-			struct by_times_called
+			struct by_times_called : sort_key_extractor<count_t>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.times_called < rhs.times_called;	}
+				count_t operator ()(address_t, const function_statistics &s) const
+				{	return s.times_called;	}
+
+				count_t operator ()(address_t, count_t s) const
+				{	return s;	}
+			};
 
-				bool operator ()(address_t, count_t lhs, address_t, count_t rhs) const
-				{	return lhs < rhs;	}
+			struct by_exclusive_time : sort_key_extractor<timestamp_t>
+			{
+				timestamp_t operator ()(address_t, const function_statistics &s) const
+				{	return s.exclusive_time;	}
 			};
 
-			struct by_exclusive_time
+			struct by_inclusive_time : sort_key_extractor<timestamp_t>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.exclusive_time < rhs.exclusive_time;	}
+				timestamp_t operator ()(address_t, const function_statistics &s) const
+				{	return s.inclusive_time;	}
 			};
 
-			struct by_inclusive_time
+			// Functions never called precede all the others.
+			struct by_avg_exclusive_call_time : sort_key_extractor<double>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.inclusive_time < rhs.inclusive_time;	}
+				double operator ()(address_t, const function_statistics &s) const
+				{
+					return s.times_called ? static_cast<double>(s.exclusive_time) / s.times_called
+						: -numeric_limits<double>::max();
+				}
 			};
 
-			struct by_avg_exclusive_call_time
+			struct by_avg_inclusive_call_time : sort_key_extractor<double>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.times_called && rhs.times_called ? lhs.exclusive_time * rhs.times_called < rhs.exclusive_time * lhs.times_called : lhs.times_called < rhs.times_called;	}
+				double operator ()(address_t, const function_statistics &s) const
+				{
+					return s.times_called ? static_cast<double>(s.inclusive_time) / s.times_called
+						: -numeric_limits<double>::max();
+				}
 			};
 
-			struct by_avg_inclusive_call_time
+			struct by_max_reentrance : sort_key_extractor<unsigned int>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.times_called && rhs.times_called ? lhs.inclusive_time * rhs.times_called < rhs.inclusive_time * lhs.times_called : lhs.times_called < rhs.times_called;	}
+				unsigned int operator ()(address_t, const function_statistics &s) const
+				{	return s.max_reentrance;	}
 			};
 
-			struct by_max_reentrance
+			struct by_max_call_time : sort_key_extractor<timestamp_t>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.max_reentrance < rhs.max_reentrance;	}
+				timestamp_t operator ()(address_t, const function_statistics &s) const
+				{	return s.max_call_time;	}
 			};
 
-			struct by_max_call_time
+			class by_latency_percentile : public sort_key_extractor<timestamp_t>
 			{
-				bool operator ()(address_t, const function_statistics &lhs, address_t, const function_statistics &rhs) const
-				{	return lhs.max_call_time < rhs.max_call_time;	}
+			public:
+				by_latency_percentile(double p)
+					: _p(p)
+				{	}
+
+				template <typename T>
+				timestamp_t operator ()(address_t, const T &s) const
+				{	return latency_percentile(s, _p);	}
+
+			private:
+				double _p;
 			};
 		}
 
@@ -141,6 +238,23 @@ namespace micro_profiler
 
 		double inclusive_time_avg(const function_statistics &s, double tick_interval)
 		{	return s.times_called ? tick_interval * s.inclusive_time / s.times_called : 0;	}
+
+		// Epochs are placed on a monotonic clock, so that neither CPU time nor system time adjustments shift them.
+		double monotonic_time()
+		{
+#ifdef _WIN32
+			LARGE_INTEGER frequency, counter;
+
+			::QueryPerformanceFrequency(&frequency);
+			::QueryPerformanceCounter(&counter);
+			return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+#else
+			timespec t;
+
+			::clock_gettime(CLOCK_MONOTONIC, &t);
+			return t.tv_sec + 1e-9 * t.tv_nsec;
+#endif
+		}
 	}
 
 
@@ -174,7 +288,39 @@ namespace micro_profiler
 		address_t _controlled_address;
 	};
 
-	typedef linked_statistics_model_impl<statistics_map_callers> parents_statistics;
+	class parents_statistics : public linked_statistics_model_impl<statistics_map_callers>
+	{
+	public:
+		parents_statistics(address_t controlled_address, const statistics_map_detailed &statistics,
+			shared_ptr<statistics_map_callers> callers, signal<void (address_t)> &entry_updated,
+			signal<void ()> &master_cleared, double tick_interval, shared_ptr<symbol_resolver> resolver);
+
+	private:
+		virtual void on_updated(address_t address);
+		void on_cleared();
+
+	private:
+		address_t _controlled_address;
+		const statistics_map_detailed *_statistics;
+		shared_ptr<statistics_map_callers> _callers;
+		slot_connection _cleared_connection;
+	};
+
+
+	class window_statistics : public statistics_model_impl<linked_statistics, statistics_map>
+	{
+	public:
+		window_statistics(shared_ptr<statistics_epochs> epochs, shared_ptr<statistics_epochs::window> window_,
+			signal<void ()> &epochs_updated, double tick_interval, shared_ptr<symbol_resolver> resolver);
+
+	private:
+		void on_updated();
+
+	private:
+		shared_ptr<statistics_epochs> _epochs;
+		shared_ptr<statistics_epochs::window> _window;
+		slot_connection _updates_connection;
+	};
 
 
 
@@ -194,6 +340,9 @@ namespace micro_profiler
 		case 6:	format_interval(text, inclusive_time_avg(row.second, _tick_interval));	break;
 		case 7:	text = to_string2(row.second.max_reentrance);	break;
 		case 8:	format_interval(text, max_call_time(row.second, _tick_interval));	break;
+		case 9:	case 10:	case 11:	case 12:
+			format_latency_percentile(text, row.second, c_latency_percentiles[subitem - 9], _tick_interval);
+			break;
 		}
 	}
 
@@ -202,30 +351,48 @@ namespace micro_profiler
 	{
 		switch (column)
 		{
-		case 1:	_view->set_order(functors::by_name(_resolver), ascending);	break;
-		case 2:	_view->set_order(functors::by_times_called(), ascending);	break;
-		case 3:	_view->set_order(functors::by_exclusive_time(), ascending);	break;
-		case 4:	_view->set_order(functors::by_inclusive_time(), ascending);	break;
-		case 5:	_view->set_order(functors::by_avg_exclusive_call_time(), ascending);	break;
-		case 6:	_view->set_order(functors::by_avg_inclusive_call_time(), ascending);	break;
-		case 7:	_view->set_order(functors::by_max_reentrance(), ascending);	break;
-		case 8:	_view->set_order(functors::by_max_call_time(), ascending);	break;
+		case 1:	_view->set_order_by_key(functors::by_name(_resolver), ascending);	break;
+		case 2:	_view->set_order_by_key(functors::by_times_called(), ascending);	break;
+		case 3:	_view->set_order_by_key(functors::by_exclusive_time(), ascending);	break;
+		case 4:	_view->set_order_by_key(functors::by_inclusive_time(), ascending);	break;
+		case 5:	_view->set_order_by_key(functors::by_avg_exclusive_call_time(), ascending);	break;
+		case 6:	_view->set_order_by_key(functors::by_avg_inclusive_call_time(), ascending);	break;
+		case 7:	_view->set_order_by_key(functors::by_max_reentrance(), ascending);	break;
+		case 8:	_view->set_order_by_key(functors::by_max_call_time(), ascending);	break;
+		case 9:	case 10:	case 11:	case 12:
+			_view->set_order_by_key(functors::by_latency_percentile(c_latency_percentiles[column - 9]), ascending);
+			break;
 		}
 		invalidated(_view->size());
 	}
 
 
 	functions_list::functions_list(shared_ptr<statistics_map_detailed> statistics, double tick_interval,
-			shared_ptr<symbol_resolver> resolver)
+			shared_ptr<symbol_resolver> resolver, const time_source &clock)
 		: statistics_model_impl<listview::model, statistics_map_detailed>(*statistics, tick_interval, resolver),
-			_statistics(statistics), _tick_interval(tick_interval), _resolver(resolver)
+			_statistics(statistics), _tick_interval(tick_interval), _resolver(resolver),
+			_clock(clock ? clock : time_source(&monotonic_time)), _epochs(new statistics_epochs)
 	{	}
 
 	void functions_list::clear()
 	{
 		_cleared();
 		_statistics->clear();
+		_addresses.reset_entries();
+		_paths.reset_times();
+		_epochs->clear();
 		updated();
+		_epochs_updated();
+	}
+
+	void functions_list::merge(const columnar_update &update)
+	{
+		statistics_map delta;
+
+		merge_columnar(*_statistics, &delta, update);
+		updated(delta);
+		_epochs->add(_clock(), delta);
+		_epochs_updated();
 	}
 
 	void functions_list::print(wstring &content) const
@@ -255,6 +422,48 @@ namespace micro_profiler
 			::setlocale(LC_NUMERIC, old_locale);
 	}
 
+	void functions_list::print_folded(wstring &content) const
+	{
+		const size_t count = _paths.size();
+		vector<call_paths::path_id> first_child(count, call_paths::root), next_sibling(count, call_paths::root);
+		vector< pair<call_paths::path_id, size_t /*prefix length*/> > stack;
+		wstring path;
+
+		// The root is never a child, so it doubles as 'no node' in the links below.
+		for (call_paths::path_id i = static_cast<call_paths::path_id>(count); i-- > 1; )
+		{
+			next_sibling[i] = first_child[_paths[i].parent];
+			first_child[_paths[i].parent] = i;
+		}
+
+		content.clear();
+		if (first_child[call_paths::root])
+			stack.push_back(make_pair(first_child[call_paths::root], 0u));
+		while (!stack.empty())
+		{
+			const call_paths::path_id id = stack.back().first;
+			const call_paths::node &n = _paths[id];
+
+			path.resize(stack.back().second);
+			stack.pop_back();
+			if (next_sibling[id])
+				stack.push_back(make_pair(next_sibling[id], path.size()));
+			if (!path.empty())
+				path += L';';
+			path += _resolver->symbol_name_by_va(n.function);
+			if (n.exclusive_time > 0)
+				content += path + L" " + to_string2(static_cast<count_t>(n.exclusive_time)) + L"\n";
+			if (first_child[id])
+				stack.push_back(make_pair(first_child[id], path.size()));
+		}
+	}
+
+	call_paths &functions_list::paths() throw()
+	{	return _paths;	}
+
+	address_index<address_t> &functions_list::addresses() throw()
+	{	return _addresses;	}
+
 	shared_ptr<linked_statistics> functions_list::watch_children(index_type item) const
 	{
 		const statistics_map_detailed::value_type &s = get_entry(item);
@@ -265,10 +474,33 @@ namespace micro_profiler
 
 	shared_ptr<linked_statistics> functions_list::watch_parents(index_type item) const
 	{
-		const statistics_map_detailed::value_type &s = get_entry(item);
+		const address_t address = get_entry(item).first;
+		shared_ptr<statistics_map_callers> callers(new statistics_map_callers);
+
+		// Callers are not stored with the statistics: each view builds its own map from the edges received so far.
+		for (statistics_map_detailed::const_iterator i = _statistics->begin(); i != _statistics->end(); ++i)
+		{
+			const statistics_map::const_iterator edge = i->second.callees.find(address);
+
+			if (edge != i->second.callees.end())
+				(*callers)[i->first] = edge->second.times_called;
+		}
+		return shared_ptr<linked_statistics>(new parents_statistics(address, *_statistics, callers,
+			_statistics->entry_updated, _cleared, _tick_interval, _resolver));
+	}
+
+	shared_ptr<linked_statistics> functions_list::watch_window(double seconds) const
+	{
+		shared_ptr<statistics_epochs::window> w(new statistics_epochs::window(*_epochs, seconds, _clock()));
 
-		return shared_ptr<linked_statistics>(new parents_statistics(s.second.callers, _statistics->entry_updated,
-			_cleared, _tick_interval, _resolver));
+		return shared_ptr<linked_statistics>(new window_statistics(_epochs, w, _epochs_updated, _tick_interval,
+			_resolver));
+	}
+
+	void functions_list::advance_windows()
+	{
+		_epochs->advance(_clock());
+		_epochs_updated();
 	}
 	
 
@@ -301,6 +533,53 @@ namespace micro_profiler
 	}
 
 
+	parents_statistics::parents_statistics(address_t controlled_address, const statistics_map_detailed &statistics,
+			shared_ptr<statistics_map_callers> callers, signal<void (address_t)> &entry_updated,
+			signal<void ()> &master_cleared, double tick_interval, shared_ptr<symbol_resolver> resolver)
+		: linked_statistics_model_impl<statistics_map_callers>(*callers, entry_updated, master_cleared, tick_interval,
+			resolver), _controlled_address(controlled_address), _statistics(&statistics), _callers(callers)
+	{	_cleared_connection = master_cleared += bind(&parents_statistics::on_cleared, this);	}
+
+	void parents_statistics::on_updated(address_t address)
+	{
+		if (!_statistics)
+			return;
+
+		const statistics_map_detailed::const_iterator caller = _statistics->find(address);
+
+		if (caller != _statistics->end())
+		{
+			const statistics_map::const_iterator edge = caller->second.callees.find(_controlled_address);
+
+			if (edge != caller->second.callees.end())
+				(*_callers)[address] = edge->second.times_called;
+		}
+		updated();
+	}
+
+	void parents_statistics::on_cleared()
+	{	_statistics = 0;	}
+
+
+	window_statistics::window_statistics(shared_ptr<statistics_epochs> epochs,
+			shared_ptr<statistics_epochs::window> window_, signal<void ()> &epochs_updated, double tick_interval,
+			shared_ptr<symbol_resolver> resolver)
+		: statistics_model_impl<linked_statistics, statistics_map>(window_->aggregate(), tick_interval, resolver),
+			_epochs(epochs), _window(window_)
+	{
+		_updates_connection = epochs_updated += bind(&window_statistics::on_updated, this);
+		updated();
+	}
+
+	void window_statistics::on_updated()
+	{
+		if (_window->reshaped())
+			updated();
+		else
+			updated(_window->changed());
+	}
+
+
 	template <>
 	void statistics_model_impl<linked_statistics, statistics_map_callers>::get_text(index_type item, index_type subitem,
 		wstring &text) const
@@ -320,17 +599,18 @@ namespace micro_profiler
 	{
 		switch (column)
 		{
-		case 1:	_view->set_order(functors::by_name(_resolver), ascending);	break;
-		case 2:	_view->set_order(functors::by_times_called(), ascending);	break;
+		case 1:	_view->set_order_by_key(functors::by_name(_resolver), ascending);	break;
+		case 2:	_view->set_order_by_key(functors::by_times_called(), ascending);	break;
 		}
 		invalidated(_view->size());
 	}
 
 
-	shared_ptr<functions_list> functions_list::create(timestamp_t ticks_per_second, shared_ptr<symbol_resolver> resolver)
+	shared_ptr<functions_list> functions_list::create(timestamp_t ticks_per_second, shared_ptr<symbol_resolver> resolver,
+		const time_source &clock)
 	{
 		return shared_ptr<functions_list>(new functions_list(
-			shared_ptr<statistics_map_detailed>(new statistics_map_detailed), 1.0 / ticks_per_second, resolver));
+			shared_ptr<statistics_map_detailed>(new statistics_map_detailed), 1.0 / ticks_per_second, resolver, clock));
 	}
 
 
@@ -0,0 +1,165 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <frontend/message_processor.h>
+
+#include <frontend/function_list.h>
+#include <frontend/symbol_resolver.h>
+
+#include <common/columnar.h>
+#include <common/compression.h>
+#include <common/recording.h>
+#include <common/serialization.h>
+
+#include <stdexcept>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		class buffer_reader
+		{
+		public:
+			buffer_reader(const byte *data, size_t size)
+				: _ptr(data), _remaining(size)
+			{	}
+
+			void read(void *data, size_t size)
+			{
+				if (size > _remaining)
+					throw out_of_range("A message is truncated!");
+				memcpy(data, _ptr, size);
+				_ptr += size;
+				_remaining -= size;
+			}
+
+			const byte *ptr() const throw()
+			{	return _ptr;	}
+
+			size_t remaining() const throw()
+			{	return _remaining;	}
+
+		private:
+			const byte *_ptr;
+			size_t _remaining;
+		};
+
+		void keep_initialized(wstring &executable, shared_ptr<functions_list> &model, const wstring &executable_,
+			const shared_ptr<functions_list> &model_)
+		{
+			executable = executable_;
+			model = model_;
+		}
+
+		bool process_recorded(message_processor &processor, const void *message, size_t size)
+		try
+		{
+			processor.process(message, size);
+			return true;
+		}
+		catch (const out_of_range &)
+		{
+			return false;
+		}
+	}
+
+	message_processor::message_processor(const shared_ptr<symbol_resolver> &resolver, const initialized_t &initialized)
+		: _resolver(resolver), _initialized(initialized), _statistics_format(update_format_varint)
+	{	}
+
+	void message_processor::process(const void *message, size_t size)
+	{	process(static_cast<const byte *>(message), size, true);	}
+
+	void message_processor::process(const byte *message, size_t size, bool allow_compressed)
+	{
+		buffer_reader reader(message, size);
+		strmd::deserializer<buffer_reader, packer> archive(reader);
+		initialization_data idata;
+		loaded_modules lmodules;
+		unsigned int uncompressed_size;
+		commands c;
+
+		archive(c);
+		if (!_model && c != init && c != modules_loaded && c != compressed)
+			throw out_of_range("A message came before the init!");
+		switch (c)
+		{
+		case init:
+			archive(idata);
+			_model = functions_list::create(idata.ticks_per_second, _resolver);
+			_statistics_format = idata.statistics_format;
+			_initialized(idata.executable, _model);
+			break;
+
+		case modules_loaded:
+			archive(lmodules);
+			for (loaded_modules::const_iterator i = lmodules.begin(); i != lmodules.end(); ++i)
+				_resolver->add_image(i->path.c_str(), i->load_address);
+			break;
+
+		case update_statistics:
+			if (_statistics_format == update_format_columnar)
+			{
+				columnar_update update;
+
+				if (update.parse(reader.ptr(), reader.remaining()))
+					_model->merge(update);
+			}
+			else if (_statistics_format == update_format_indexed)
+				_model->merge_indexed(archive);
+			else
+				archive(*_model);
+			break;
+
+		case register_addresses:
+			archive(_model->addresses());
+			break;
+
+		case update_call_paths:
+			archive(_model->paths());
+			break;
+
+		case compressed:
+			archive(uncompressed_size);
+			if (allow_compressed && uncompressed_size && uncompressed_size <= c_max_uncompressed_size)
+			{
+				vector<byte> decompressed(uncompressed_size);
+
+				if (decompress(&decompressed[0], uncompressed_size, reader.ptr(), reader.remaining()))
+					process(&decompressed[0], uncompressed_size, false);
+			}
+			break;
+		}
+	}
+
+
+	shared_ptr<functions_list> load_recording(const shared_ptr<symbol_resolver> &resolver, const void *data,
+		size_t size, wstring &executable)
+	{
+		shared_ptr<functions_list> model;
+		message_processor processor(resolver, bind(&keep_initialized, ref(executable), ref(model), _1, _2));
+
+		read_recording(bind(&process_recorded, ref(processor), _1, _2), data, size);
+		return model;
+	}
+}
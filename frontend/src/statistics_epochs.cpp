@@ -0,0 +1,186 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <frontend/statistics_epochs.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace
+	{
+		// Maximums cannot be subtracted, they are recomputed by the caller.
+		void subtract(function_statistics &from, const function_statistics &value)
+		{
+			from.times_called -= value.times_called;
+			from.inclusive_time -= value.inclusive_time;
+			from.exclusive_time -= value.exclusive_time;
+		}
+	}
+
+	statistics_epochs::statistics_epochs(double epoch_duration)
+		: _epoch_duration(epoch_duration)
+	{	}
+
+	void statistics_epochs::add(double now, const statistics_map &delta)
+	{
+		const long long index = index_of(now);
+
+		if (_epochs.empty() || _epochs.back().index < index)
+		{
+			_epochs.push_back(epoch());
+			_epochs.back().index = index;
+		}
+
+		statistics_map &current = _epochs.back().delta;
+
+		for (statistics_map::const_iterator i = delta.begin(); i != delta.end(); ++i)
+			current[i->first] += i->second;
+		advance(_epochs.back().index, &delta);
+	}
+
+	void statistics_epochs::advance(double now)
+	{	advance(index_of(now), 0);	}
+
+	void statistics_epochs::clear()
+	{
+		_epochs.clear();
+		for (vector<window *>::const_iterator i = _windows.begin(); i != _windows.end(); ++i)
+			(*i)->reset();
+	}
+
+	size_t statistics_epochs::size() const throw()
+	{	return _epochs.size();	}
+
+	long long statistics_epochs::index_of(double time) const throw()
+	{	return static_cast<long long>(floor(time / _epoch_duration));	}
+
+	void statistics_epochs::advance(long long current, const statistics_map *delta)
+	{
+		long long retained = 0;
+
+		for (vector<window *>::const_iterator i = _windows.begin(); i != _windows.end(); ++i)
+		{
+			(*i)->advance(current, delta);
+			retained = max(retained, (*i)->_length);
+		}
+		while (!_epochs.empty() && _epochs.front().index <= current - retained)
+			_epochs.pop_front();
+	}
+
+
+	statistics_epochs::window::window(statistics_epochs &epochs, double duration, double now)
+		: _epochs(epochs), _length(max(1ll, static_cast<long long>(ceil(duration / epochs._epoch_duration)))),
+			_first(epochs.index_of(now) - _length + 1), _reshaped(false)
+	{
+		for (deque<epoch>::const_iterator e = _epochs._epochs.begin(); e != _epochs._epochs.end(); ++e)
+		{
+			if (e->index >= _first)
+			{
+				for (statistics_map::const_iterator i = e->delta.begin(); i != e->delta.end(); ++i)
+					_aggregate[i->first] += i->second;
+			}
+		}
+		_epochs._windows.push_back(this);
+	}
+
+	statistics_epochs::window::~window()
+	{	_epochs._windows.erase(find(_epochs._windows.begin(), _epochs._windows.end(), this));	}
+
+	const statistics_map &statistics_epochs::window::aggregate() const throw()
+	{	return _aggregate;	}
+
+	const statistics_map &statistics_epochs::window::changed() const throw()
+	{	return _changed;	}
+
+	bool statistics_epochs::window::reshaped() const throw()
+	{	return _reshaped;	}
+
+	void statistics_epochs::window::advance(long long current, const statistics_map *delta)
+	{
+		const long long first = current - _length + 1;
+		const size_t size = _aggregate.size();
+
+		_changed.clear();
+		_reshaped = false;
+		if (first > _first)
+		{
+			for (deque<epoch>::const_iterator e = _epochs._epochs.begin();
+				e != _epochs._epochs.end() && e->index < first; ++e)
+			{
+				if (e->index < _first)
+					continue;
+				for (statistics_map::const_iterator i = e->delta.begin(); i != e->delta.end(); ++i)
+				{
+					subtract(_aggregate[i->first], i->second);
+					_changed[i->first];
+				}
+			}
+			_first = first;
+			for (statistics_map::const_iterator i = _changed.begin(); i != _changed.end(); ++i)
+			{
+				if (!recompute_maximums(i->first, _aggregate[i->first]))
+				{
+					_aggregate.erase(i->first);
+					_reshaped = true;
+				}
+			}
+		}
+		if (delta)
+		{
+			for (statistics_map::const_iterator i = delta->begin(); i != delta->end(); ++i)
+			{
+				_aggregate[i->first] += i->second;
+				_changed[i->first];
+			}
+		}
+		_reshaped = _reshaped || _aggregate.size() != size;
+	}
+
+	bool statistics_epochs::window::recompute_maximums(address_t address, function_statistics &value) const
+	{
+		bool found = false;
+
+		value.max_reentrance = 0;
+		value.max_call_time = 0;
+		for (deque<epoch>::const_iterator e = _epochs._epochs.begin(); e != _epochs._epochs.end(); ++e)
+		{
+			const statistics_map::const_iterator i = e->index >= _first ? e->delta.find(address) : e->delta.end();
+
+			if (i != e->delta.end())
+			{
+				found = true;
+				value.max_reentrance = max(value.max_reentrance, i->second.max_reentrance);
+				value.max_call_time = max(value.max_call_time, i->second.max_call_time);
+			}
+		}
+		return found;
+	}
+
+	void statistics_epochs::window::reset()
+	{
+		_aggregate.clear();
+		_changed.clear();
+		_reshaped = true;
+	}
+}
@@ -0,0 +1,102 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "primitives.h"
+
+#include <deque>
+#include <vector>
+
+namespace micro_profiler
+{
+	// Keeps per-update statistics deltas bucketed into epochs of a fixed duration. Only the epochs that fall into the
+	// longest open window are retained, so the memory used is bounded by the window length times the number of
+	// functions active within it.
+	class statistics_epochs
+	{
+	public:
+		class window;
+
+	public:
+		explicit statistics_epochs(double epoch_duration = 1.0);
+
+		// Files the delta into the epoch of 'now' and moves the open windows to 'now'.
+		void add(double now, const statistics_map &delta);
+
+		// Moves the open windows to 'now' without new data, so that they empty out once updates stop coming.
+		void advance(double now);
+
+		void clear();
+		size_t size() const throw();
+
+	private:
+		struct epoch
+		{
+			long long index;
+			statistics_map delta;
+		};
+
+	private:
+		long long index_of(double time) const throw();
+		void advance(long long current, const statistics_map *delta);
+
+	private:
+		const double _epoch_duration;
+		std::deque<epoch> _epochs;
+		std::vector<window *> _windows;
+	};
+
+	// Aggregate of the epochs falling into the last 'duration' seconds. It is maintained incrementally: the deltas
+	// added are merged in, while the epochs leaving the window are subtracted (maximums are recomputed for the entries
+	// they touched only). Must not outlive the epochs it was opened on.
+	class statistics_epochs::window
+	{
+	public:
+		window(statistics_epochs &epochs, double duration, double now);
+		~window();
+
+		const statistics_map &aggregate() const throw();
+
+		// Keys of the entries affected by the last move.
+		const statistics_map &changed() const throw();
+
+		// Whether the last move added entries to the aggregate or removed the ones that have left the window.
+		bool reshaped() const throw();
+
+	private:
+		window(const window &other);
+		void operator =(const window &rhs);
+
+		void advance(long long current, const statistics_map *delta);
+		bool recompute_maximums(address_t address, function_statistics &value) const;
+		void reset();
+
+	private:
+		statistics_epochs &_epochs;
+		const long long _length;
+		long long _first;
+		statistics_map _aggregate, _changed;
+		bool _reshaped;
+
+	private:
+		friend class statistics_epochs;
+	};
+}
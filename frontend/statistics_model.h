@@ -55,6 +55,7 @@ namespace micro_profiler
 	protected:
 		typename const MapT::value_type &get_entry(index_type row) const;
 		void updated();
+		void updated(const statistics_map &changed);
 
 	private:
 		double _tick_interval;
@@ -126,4 +127,11 @@ namespace micro_profiler
 		_view->resort();
 		invalidated(_view->size());
 	}
+
+	template <typename BaseT, typename MapT>
+	inline void statistics_model_impl<BaseT, MapT>::updated(const statistics_map &changed)
+	{
+		_view->resort(changed);
+		invalidated(_view->size());
+	}
 }
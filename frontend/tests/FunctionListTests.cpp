@@ -6,6 +6,7 @@
 #include <frontend/symbol_resolver.h>
 
 #include <iomanip>
+#include <map>
 #include <strmd/serializer.h>
 #include <strmd/deserializer.h>
 #include <sstream>
@@ -172,6 +173,20 @@ namespace micro_profiler
 						return i;
 				return (size_t)-1;
 			}
+
+			class fake_clock
+			{
+			public:
+				fake_clock(const double &now)
+					: _now(&now)
+				{	}
+
+				double operator ()() const
+				{	return *_now;	}
+
+			private:
+				const double *_now;
+			};
 		}
 
 
@@ -269,6 +284,48 @@ namespace micro_profiler
 			}
 
 
+			test( IndexedUpdatesAreMergedBeforeAndAfterClearing )
+			{
+				// INIT
+				typedef map<const void *, function_statistics_detailed_t<const void *> > source_map;
+
+				shared_ptr<functions_list> fl(functions_list::create(test_ticks_per_second, resolver));
+				address_dictionary d;
+				registered_addresses registered;
+				source_map s;
+
+				static_cast<function_statistics &>(s[(void *)1123]) = function_statistics(19, 0, 31, 29);
+				s[(void *)1123].callees[(void *)2234] = function_statistics(10, 3, 7, 5);
+				static_cast<function_statistics &>(s[(void *)2234]) = function_statistics(10, 3, 7, 5);
+				d.register_addresses(s, registered);
+				ser(registered);
+
+				indexed_statistics_t<source_map> update = {	s, d	};
+
+				ser(update);
+				ser(update);
+
+				// ACT
+				dser(fl->addresses());
+				fl->merge_indexed(dser);
+
+				// ASSERT
+				assert_equal(2u, fl->addresses().size());
+				assert_equal(2u, fl->get_count());
+				assert_equal(L"19", get_text(*fl, fl->get_index(1123), 2));
+				assert_equal(L"10", get_text(*fl, fl->get_index(2234), 2));
+
+				// ACT
+				fl->clear();
+				fl->merge_indexed(dser);
+
+				// ASSERT
+				assert_equal(2u, fl->get_count());
+				assert_equal(L"19", get_text(*fl, fl->get_index(1123), 2));
+				assert_equal(L"10", get_text(*fl, fl->get_index(2234), 2));
+			}
+
+
 			test( ClearingTheListResetsWatchedChildren )
 			{
 				// INIT
@@ -312,6 +369,7 @@ namespace micro_profiler
 				s[1123].callees[11000];
 				s[1123].callees[11001];
 				s[1124].callees[11000];
+				s[11000], s[11001];
 				ser(s);
 				dser(*fl);
 
@@ -1493,6 +1551,74 @@ namespace micro_profiler
 			}
 
 
+			test( ParentStatisticsAreRebuiltWhenWatchedAgainAfterUnwatchedUpdates )
+			{
+				// INIT
+				shared_ptr<functions_list> fl(functions_list::create(test_ticks_per_second, resolver));
+				statistics_map_detailed s;
+
+				s[0x2978].callees[0x3001] = function_statistics(3);
+				s[0x2995].callees[0x3001] = function_statistics(30);
+				s[0x3001];
+				ser(s);
+				ser(s);
+
+				fl->set_order(1, true);
+				dser(*fl);
+				fl->watch_parents(2);
+				dser(*fl);
+
+				// ACT
+				shared_ptr<linked_statistics> p = fl->watch_parents(2);
+
+				// ASSERT
+				p->set_order(2, true);
+
+				assert_equal(2u, p->get_count());
+				assert_row(*p, 0, L"00002978", L"6");
+				assert_row(*p, 1, L"00002995", L"60");
+			}
+
+
+			test( WatchingParentsAgainLeavesExistingParentsViewsIntact )
+			{
+				// INIT
+				shared_ptr<functions_list> fl(functions_list::create(test_ticks_per_second, resolver));
+				statistics_map_detailed s1, s2;
+
+				s1[0x2978].callees[0x3001] = function_statistics(3);
+				s1[0x2995].callees[0x3001] = function_statistics(30);
+				s1[0x3001];
+				s2[0x2995].callees[0x3001] = function_statistics(5);
+				ser(s1);
+				ser(s2);
+
+				fl->set_order(1, true);
+				dser(*fl);
+
+				shared_ptr<linked_statistics> p1 = fl->watch_parents(2);
+
+				p1->set_order(2, true);
+
+				// ACT
+				shared_ptr<linked_statistics> p2 = fl->watch_parents(2);
+
+				// ASSERT
+				assert_equal(2u, p1->get_count());
+				assert_row(*p1, 0, L"00002978", L"3");
+				assert_row(*p1, 1, L"00002995", L"30");
+
+				// ACT
+				dser(*fl);
+				p2.reset();
+
+				// ASSERT
+				assert_equal(2u, p1->get_count());
+				assert_row(*p1, 0, L"00002978", L"3");
+				assert_row(*p1, 1, L"00002995", L"35");
+			}
+
+
 			test( ParentStatisticsInvalidationOnGlobalUpdates )
 			{
 				// INIT
@@ -1583,6 +1709,7 @@ namespace micro_profiler
 				shared_ptr<functions_list> fl2(functions_list::create(25000000000, shared_ptr<sri>(new sri(symbols2))));
 				statistics_map_detailed s;
 				timestamp_t ticks_per_second;
+				unsigned int version;
 
 				s[1], s[17];
 				ser(s);
@@ -1599,10 +1726,17 @@ namespace micro_profiler
 				// ASSERT
 				vector< pair<address_t, wstring> > data;
 				pair<address_t, wstring> reference1[] = { make_pair(1, L"Lorem"), make_pair(17, L"Amet"), };
+				call_paths paths;
+
+				dser(ticks_per_second);
+				dser(version);
+				assert_equal(0, ticks_per_second);
+				assert_equal(c_statistics_file_version, version);
 
 				dser(ticks_per_second);
 				dser(data);
 				dser(s);
+				dser(paths);
 
 				assert_equal(16, ticks_per_second);
 				assert_equivalent(reference1, data);
@@ -1617,6 +1751,8 @@ namespace micro_profiler
 
 				data.clear();
 				dser(ticks_per_second);
+				dser(version);
+				dser(ticks_per_second);
 				dser(data);
 				dser(s);
 
@@ -1645,7 +1781,10 @@ namespace micro_profiler
 				// ASSERT
 				vector< pair<address_t, wstring> > symbols_read;
 				statistics_map_detailed stats_read;
+				unsigned int version;
 
+				dser(ticks_per_second);
+				dser(version);
 				dser(ticks_per_second);
 				dser(symbols_read);
 				dser(stats_read);
@@ -1665,9 +1804,12 @@ namespace micro_profiler
 				s[5].times_called = 123, s[17].times_called = 127, s[13].times_called = 12, s[123].times_called = 12000;
 				s[5].inclusive_time = 1000, s[123].inclusive_time = 250;
 
+				ser(timestamp_t());
+				ser(c_statistics_file_version);
 				ser(500);
 				ser(mkvector(symbols));
 				ser(s);
+				ser(call_paths());
 
 				// ACT
 				shared_ptr<functions_list> fl = functions_list::load(dser);
@@ -1685,6 +1827,182 @@ namespace micro_profiler
 				assert_equal(L"12000", get_text(*fl, 3, 2));
 				assert_equal(L"500ms", get_text(*fl, 3, 4));
 			}
+
+
+			test( FilesSavedBeforeVersioningAreLoadedWithoutLatencies )
+			{
+				// INIT
+				pair<address_t, wstring> symbols[] = {
+					make_pair(5, L"Lorem"), make_pair(13, L"Ipsum"),
+				};
+				vector< pair<address_t, function_statistics> > no_callees;
+
+				ser(500);
+				ser(mkvector(symbols));
+				ser(2u);
+				ser(make_pair(address_t(5), function_statistics(123, 0, 1000, 0, 0)));
+				ser(no_callees);
+				ser(make_pair(address_t(13), function_statistics(12, 0, 250, 0, 0)));
+				ser(no_callees);
+
+				// ACT
+				shared_ptr<functions_list> fl = functions_list::load(dser);
+				fl->set_order(1, true);
+
+				// ASSERT
+				assert_equal(2u, fl->get_count());
+				assert_equal(L"Ipsum", get_text(*fl, 0, 1));
+				assert_equal(L"12", get_text(*fl, 0, 2));
+				assert_equal(L"Lorem", get_text(*fl, 1, 1));
+				assert_equal(L"123", get_text(*fl, 1, 2));
+			}
+
+
+			test( FoldedStacksArePrintedForReceivedCallPaths )
+			{
+				// INIT
+				pair<address_t, wstring> symbols[] = {
+					make_pair(1, L"main"), make_pair(2, L"parse"), make_pair(3, L"lex"), make_pair(4, L"emit"),
+				};
+				shared_ptr<functions_list> fl(functions_list::create(1, shared_ptr<sri>(new sri(symbols))));
+				call_paths paths;
+				wstring result;
+
+				paths.add_time(paths.intern(call_paths::root, 1), 10);
+				paths.add_time(paths.intern(paths.intern(call_paths::root, 1), 2), 20);
+				paths.add_time(paths.intern(paths.intern(paths.intern(call_paths::root, 1), 2), 3), 35);
+				paths.add_time(paths.intern(paths.intern(call_paths::root, 1), 4), 7);
+				paths.intern(paths.intern(call_paths::root, 4), 3);
+				ser(paths);
+				paths.commit();
+
+				// ACT
+				dser(fl->paths());
+				fl->print_folded(result);
+
+				// ASSERT
+				assert_equal(L"main 10\n"
+					L"main;parse 20\n"
+					L"main;parse;lex 35\n"
+					L"main;emit 7\n", result);
+
+				// INIT
+				paths.add_time(paths.intern(call_paths::root, 4), 3);
+				paths.add_time(paths.intern(paths.intern(call_paths::root, 4), 3), 1);
+				paths.add_time(paths.intern(paths.intern(call_paths::root, 1), 4), 1);
+				ser(paths);
+
+				// ACT
+				dser(fl->paths());
+				fl->print_folded(result);
+
+				// ASSERT
+				assert_equal(L"main 10\n"
+					L"main;parse 20\n"
+					L"main;parse;lex 35\n"
+					L"main;emit 8\n"
+					L"emit 3\n"
+					L"emit;lex 1\n", result);
+
+				// ACT
+				fl->clear();
+				fl->print_folded(result);
+
+				// ASSERT
+				assert_equal(L"", result);
+			}
+
+
+			test( CallPathsAreRestoredFromFile )
+			{
+				// INIT
+				pair<address_t, wstring> symbols[] = {
+					make_pair(1, L"main"), make_pair(2, L"parse"),
+				};
+				shared_ptr<functions_list> fl(functions_list::create(1, shared_ptr<sri>(new sri(symbols))));
+				call_paths paths;
+				statistics_map_detailed s;
+				wstring result;
+
+				s[1].times_called = 1, s[2].times_called = 1;
+				ser(s);
+				dser(*fl);
+				paths.add_time(paths.intern(call_paths::root, 1), 3);
+				paths.add_time(paths.intern(paths.intern(call_paths::root, 1), 2), 5);
+				ser(paths);
+				dser(fl->paths());
+
+				// ACT
+				fl->save(ser);
+				shared_ptr<functions_list> loaded = functions_list::load(dser);
+
+				// ASSERT
+				loaded->print_folded(result);
+				assert_equal(L"main 3\n"
+					L"main;parse 5\n", result);
+			}
+
+
+			test( WindowStatisticsIncludeOnlyUpdatesReceivedWithinTheWindow )
+			{
+				// INIT
+				double now = 10.0;
+				shared_ptr<functions_list> fl(functions_list::create(test_ticks_per_second, resolver, fake_clock(now)));
+				shared_ptr<linked_statistics> w(fl->watch_window(2));
+				statistics_map_detailed s1, s2, s3;
+				wstring result;
+
+				static_cast<function_statistics &>(s1[1123]) = function_statistics(19, 0, 31, 29);
+				static_cast<function_statistics &>(s2[2234]) = function_statistics(10, 3, 7, 5);
+				static_cast<function_statistics &>(s2[1123]) = function_statistics(1, 0, 3, 3);
+				w->set_order(2, false);
+
+				// ACT
+				ser(s1);
+				dser(*fl);
+
+				// ASSERT
+				assert_equal(1u, w->get_count());
+				assert_row(*w, 0, L"00000463", L"19");
+
+				// ACT
+				now = 11.5;
+				ser(s2);
+				dser(*fl);
+
+				// ASSERT
+				assert_equal(2u, w->get_count());
+				assert_row(*w, 0, L"00000463", L"20");
+				assert_row(*w, 1, L"000008BA", L"10");
+
+				// ACT
+				now = 12.1;
+				ser(s3);
+				dser(*fl);
+
+				// ASSERT
+				assert_equal(2u, w->get_count());
+				assert_row(*w, 0, L"000008BA", L"10");
+				assert_row(*w, 1, L"00000463", L"1");
+				assert_equal(L"20", (fl->get_text(fl->get_index(1123), 2, result), result));
+
+				// ACT
+				now = 13.0;
+				fl->advance_windows();
+
+				// ASSERT
+				assert_equal(0u, w->get_count());
+
+				// INIT
+				ser(s2);
+				dser(*fl);
+
+				// ACT
+				fl->clear();
+
+				// ASSERT
+				assert_equal(0u, w->get_count());
+			}
 		end_test_suite
 	}
 }
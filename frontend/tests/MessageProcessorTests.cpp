@@ -0,0 +1,244 @@
+#include <frontend/message_processor.h>
+
+#include <test-helpers/helpers.h>
+
+#include <common/compression.h>
+#include <common/recording.h>
+#include <common/serialization.h>
+#include <frontend/function_list.h>
+#include <frontend/symbol_resolver.h>
+
+#include <strmd/serializer.h>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+using namespace placeholders;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			class sri : public symbol_resolver
+			{
+			public:
+				virtual const wstring &symbol_name_by_va(address_t /*address*/) const
+				{	return name;	}
+
+				virtual void add_image(const wchar_t *image, address_t /*base*/)
+				{	images.push_back(image);	}
+
+			public:
+				wstring name;
+				vector<wstring> images;
+			};
+
+			template <typename PayloadT>
+			vector<byte> message(commands command, const PayloadT &payload)
+			{
+				vector_adapter buffer;
+				strmd::serializer<vector_adapter, packer> archive(buffer);
+
+				archive(command);
+				archive(payload);
+				return buffer.buffer;
+			}
+
+			vector<byte> compressed_message(const vector<byte> &inner, unsigned int claimed_size)
+			{
+				vector<byte> m = message(compressed, claimed_size);
+				const size_t header_size = m.size();
+
+				m.resize(header_size + compress_bound(inner.size()));
+				m.resize(header_size + compress(&m[header_size], &inner[0], inner.size()));
+				return m;
+			}
+
+			void append(vector<byte> &recording, unsigned int /*segment*/, const void *buffer, size_t size)
+			{
+				const byte *buffer_ = static_cast<const byte *>(buffer);
+
+				recording.insert(recording.end(), buffer_, buffer_ + size);
+			}
+
+			void log_initialized(vector<wstring> &log, const wstring &executable, const shared_ptr<functions_list> &)
+			{	log.push_back(executable);	}
+
+			initialization_data make_init(const wstring &executable)
+			{
+				initialization_data idata = {	executable, 1000, update_format_varint	};
+				return idata;
+			}
+		}
+
+		begin_test_suite( MessageProcessorTests )
+			shared_ptr<sri> resolver;
+			vector<wstring> initialized;
+
+			init( CreateResolver )
+			{
+				resolver.reset(new sri);
+			}
+
+
+			test( ModelIsCreatedAndReportedOnInit )
+			{
+				// INIT
+				message_processor p(resolver, bind(&log_initialized, ref(initialized), _1, _2));
+				vector<byte> m = message(init, make_init(L"lorem.exe"));
+
+				// ACT
+				p.process(&m[0], m.size());
+
+				// ASSERT
+				assert_equal(1u, initialized.size());
+				assert_equal(L"lorem.exe", initialized[0]);
+			}
+
+
+			test( MessagesBeforeInitAreRejected )
+			{
+				// INIT
+				message_processor p(resolver, bind(&log_initialized, ref(initialized), _1, _2));
+				vector<byte> m = message(update_statistics, statistics_map_detailed());
+
+				// ACT / ASSERT
+				assert_throws(p.process(&m[0], m.size()), out_of_range);
+			}
+
+
+			test( TruncatedMessagesAreRejected )
+			{
+				// INIT
+				message_processor p(resolver, bind(&log_initialized, ref(initialized), _1, _2));
+				vector<byte> m = message(init, make_init(L"lorem.exe"));
+
+				// ACT / ASSERT
+				assert_throws(p.process(&m[0], m.size() - 1), out_of_range);
+				assert_is_empty(initialized);
+			}
+
+
+			test( CompressedMessagesAreUnpackedAndProcessed )
+			{
+				// INIT
+				message_processor p(resolver, bind(&log_initialized, ref(initialized), _1, _2));
+				vector<byte> inner = message(init, make_init(L"lorem.exe"));
+				vector<byte> m = compressed_message(inner, static_cast<unsigned int>(inner.size()));
+
+				// ACT
+				p.process(&m[0], m.size());
+
+				// ASSERT
+				assert_equal(1u, initialized.size());
+				assert_equal(L"lorem.exe", initialized[0]);
+			}
+
+
+			test( DamagedCompressedPayloadsAreIgnored )
+			{
+				// INIT
+				message_processor p(resolver, bind(&log_initialized, ref(initialized), _1, _2));
+				vector<byte> inner = message(init, make_init(L"lorem.exe"));
+				const unsigned int size = static_cast<unsigned int>(inner.size());
+				vector<byte> intact = compressed_message(inner, size);
+				vector<byte> undersized = compressed_message(inner, size - 1);
+				vector<byte> oversized = compressed_message(inner, size + 1);
+				vector<byte> too_large = compressed_message(inner, c_max_uncompressed_size + 1);
+				vector<byte> nested = compressed_message(intact, static_cast<unsigned int>(intact.size()));
+
+				// ACT
+				p.process(&intact[0], intact.size() - 2);
+				p.process(&undersized[0], undersized.size());
+				p.process(&oversized[0], oversized.size());
+				p.process(&too_large[0], too_large.size());
+				p.process(&nested[0], nested.size());
+
+				// ASSERT
+				assert_is_empty(initialized);
+
+				// ACT / ASSERT
+				assert_throws(p.process(&intact[0], 1), out_of_range);
+				assert_is_empty(initialized);
+			}
+
+
+			test( RecordedSegmentIsLoadedIntoANewModel )
+			{
+				// INIT
+				vector<byte> recording;
+				recording_writer w(bind(&append, ref(recording), _1, _2, _3), 0);
+				statistics_map_detailed s;
+				loaded_modules modules(1);
+				wstring executable;
+
+				modules[0].load_address = 0x10000;
+				modules[0].path = L"ipsum.dll";
+				static_cast<function_statistics &>(s[0x10010]) = function_statistics(19, 0, 31, 29);
+				static_cast<function_statistics &>(s[0x10020]) = function_statistics(10, 3, 7, 5);
+
+				vector<byte> m1 = message(init, make_init(L"lorem.exe"));
+				vector<byte> m2 = message(modules_loaded, modules);
+				vector<byte> m3 = message(update_statistics, s);
+
+				w.write(&m1[0], m1.size());
+				w.write(&m2[0], m2.size());
+				w.write(&m3[0], m3.size());
+
+				// ACT
+				shared_ptr<functions_list> model = load_recording(resolver, &recording[0], recording.size(), executable);
+
+				// ASSERT
+				assert_not_null(model);
+				assert_equal(L"lorem.exe", executable);
+				assert_equal(2u, model->get_count());
+				assert_equal(1u, resolver->images.size());
+				assert_equal(L"ipsum.dll", resolver->images[0]);
+			}
+
+
+			test( LoadingARecordingStopsAtATruncatedFrameKeepingTheModel )
+			{
+				// INIT
+				vector<byte> recording;
+				recording_writer w(bind(&append, ref(recording), _1, _2, _3), 0);
+				statistics_map_detailed s;
+				wstring executable;
+
+				static_cast<function_statistics &>(s[0x10010]) = function_statistics(19, 0, 31, 29);
+
+				vector<byte> m1 = message(init, make_init(L"lorem.exe"));
+				vector<byte> m2 = message(update_statistics, s);
+
+				w.write(&m1[0], m1.size());
+				w.write(&m2[0], m2.size());
+				w.write(&m2[0], m2.size());
+
+				// ACT
+				shared_ptr<functions_list> model = load_recording(resolver, &recording[0], recording.size() - 3,
+					executable);
+
+				// ASSERT
+				assert_not_null(model);
+				assert_equal(1u, model->get_count());
+			}
+
+
+			test( RecordingWithoutInitLoadsNoModel )
+			{
+				// INIT
+				vector<byte> recording;
+				recording_writer w(bind(&append, ref(recording), _1, _2, _3), 0);
+				vector<byte> m = message(update_statistics, statistics_map_detailed());
+				wstring executable;
+
+				w.write(&m[0], m.size());
+
+				// ACT / ASSERT
+				assert_null(load_recording(resolver, &recording[0], recording.size(), executable));
+			}
+		end_test_suite
+	}
+}
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include <ut/assert.h>
 #include <ut/test.h>
 
@@ -51,6 +52,34 @@ namespace micro_profiler
 			{
 				return left.c > right.c;
 			}
+
+			struct key_a : sort_key_extractor<int>
+			{
+				int operator ()(const void *, const POD &value) const
+				{	return value.a;	}
+			};
+
+			struct counting_key_b : sort_key_extractor<int>
+			{
+				counting_key_b(size_t &extracted_)
+					: extracted(&extracted_)
+				{	}
+
+				int operator ()(const void *, const POD &value) const
+				{	return ++*extracted, value.b;	}
+
+				size_t *extracted;
+			};
+
+			void fill_with_ties(pod_map &source, vector<POD> &pods)
+			{
+				for (int i = 0; i != static_cast<int>(pods.size()); ++i)
+				{
+					POD pod = {	i % 97, (i * 7919) % 10000, 0.0	};
+
+					source[&pods[i]] = pods[i] = pod;
+				}
+			}
 		}
 
 
@@ -536,6 +565,268 @@ namespace micro_profiler
 				// ASSERT
 				assert_equal(0u, s.size());
 			}
+
+
+			test( EveryKeyIsFoundAtItsPositionInALargeView )
+			{
+				// INIT
+				pod_map source;
+				vector<POD> pods(10000);
+
+				for (int i = 0; i != 10000; ++i)
+				{
+					POD pod = {	(i * 7919) % 10000, i, 0.0	};
+
+					source[&pods[i]] = pods[i] = pod;
+				}
+
+				sorted_pods s(source);
+
+				// ACT
+				s.set_order(&sort_by_a, true);
+
+				// ASSERT
+				for (size_t i = 0; i != 10000; ++i)
+					assert_equal(i, s.find_by_key(s.at(i).first));
+				assert_equal(9999, s.at(0).second.a);
+
+				// ACT
+				s.set_order(sort_by_b(), false);
+
+				// ASSERT
+				for (size_t i = 0; i != 10000; ++i)
+					assert_equal(i, s.find_by_key(s.at(i).first));
+				assert_equal(0, s.at(0).second.b);
+			}
+
+
+			test( KeysAddedToTheMapAreFoundAfterResort )
+			{
+				// INIT
+				pod_map source;
+				POD pods[] = {	{114, 21, 99.6}, {1, 0, 11.0}, {10, 3, 1.0},	};
+
+				source[pods + 0] = pods[0];
+				source[pods + 1] = pods[1];
+
+				sorted_pods s(source);
+
+				s.set_order(&sort_by_a, true);
+				source[pods + 2] = pods[2];
+
+				// ACT
+				s.resort();
+
+				// ASSERT
+				assert_equal(0u, s.find_by_key(pods + 0));
+				assert_equal(1u, s.find_by_key(pods + 2));
+				assert_equal(2u, s.find_by_key(pods + 1));
+
+				// ACT
+				s.detach();
+
+				// ASSERT
+				assert_equal(sorted_pods::npos, s.find_by_key(pods + 0));
+			}
+
+
+			test( IncrementalResortYieldsTheSameOrderAsTheFullOne )
+			{
+				// INIT
+				pod_map source;
+				vector<POD> pods(10000);
+
+				for (int i = 0; i != 10000; ++i)
+				{
+					POD pod = {	i % 97, (i * 7919) % 10000, 0.0	};
+
+					source[&pods[i]] = pods[i] = pod;
+				}
+
+				sorted_pods incremental(source), full(source);
+
+				incremental.set_order(&sort_by_a, true);
+				full.set_order(&sort_by_a, true);
+
+				for (int n = 0; n != 3; ++n)
+				{
+					pod_map changed;
+
+					for (int i = n; i < 10000; i += 29)
+					{
+						POD &pod = source[&pods[i]];
+
+						pod.a = (pod.a * 31 + n) % 97, pod.b += 5000;
+						changed[&pods[i]] = pod;
+					}
+
+					// ACT
+					incremental.resort(changed);
+					full.resort();
+
+					// ASSERT
+					for (size_t i = 0; i != 10000; ++i)
+					{
+						assert_equal(full.at(i).first, incremental.at(i).first);
+						assert_equal(i, incremental.find_by_key(incremental.at(i).first));
+					}
+
+					// INIT
+					incremental.set_order(sort_by_b(), n % 2 == 0);
+					full.set_order(sort_by_b(), n % 2 == 0);
+				}
+			}
+
+
+			test( IncrementalResortFallsBackToTheFullOneWhenEntriesAreAdded )
+			{
+				// INIT
+				pod_map source, changed;
+				POD pods[] = {	{114, 21, 99.6}, {1, 0, 11.0}, {10, 3, 1.0},	};
+
+				source[pods + 0] = pods[0];
+				source[pods + 1] = pods[1];
+
+				sorted_pods s(source);
+
+				s.set_order(&sort_by_a, true);
+				source[pods + 1].a = 200;
+				source[pods + 2] = pods[2];
+				changed[pods + 1] = source[pods + 1];
+				changed[pods + 2] = source[pods + 2];
+
+				// ACT
+				s.resort(changed);
+
+				// ASSERT
+				assert_equal(3u, s.size());
+				assert_equal(0u, s.find_by_key(pods + 1));
+				assert_equal(1u, s.find_by_key(pods + 0));
+				assert_equal(2u, s.find_by_key(pods + 2));
+			}
+
+
+			test( KeyOrderBreaksTiesByMapKeyInBothDirections )
+			{
+				// INIT
+				pod_map source;
+				vector<POD> pods(1000);
+
+				fill_with_ties(source, pods);
+
+				sorted_pods s(source);
+
+				// ACT
+				s.set_order_by_key(key_a(), true);
+
+				// ASSERT
+				for (size_t i = 1; i != 1000; ++i)
+				{
+					assert_is_true(s.at(i - 1).second.a < s.at(i).second.a
+						|| (s.at(i - 1).second.a == s.at(i).second.a && s.at(i - 1).first < s.at(i).first));
+				}
+
+				// ACT
+				s.set_order_by_key(key_a(), false);
+
+				// ASSERT
+				for (size_t i = 1; i != 1000; ++i)
+				{
+					assert_is_true(s.at(i - 1).second.a > s.at(i).second.a
+						|| (s.at(i - 1).second.a == s.at(i).second.a && s.at(i - 1).first < s.at(i).first));
+				}
+			}
+
+
+			test( KeyOrderMatchesTheEquivalentPredicateOrder )
+			{
+				// INIT
+				pod_map source;
+				vector<POD> pods(10000);
+
+				fill_with_ties(source, pods);
+
+				sorted_pods by_key(source), by_predicate(source);
+
+				// ACT
+				by_key.set_order_by_key(key_a(), false);
+				by_predicate.set_order(&sort_by_a, true);
+
+				// ASSERT
+				for (size_t i = 0; i != 10000; ++i)
+					assert_equal(by_predicate.at(i).first, by_key.at(i).first);
+			}
+
+
+			test( EntriesPastTheSortedWindowAreOrderedOnAccess )
+			{
+				// INIT
+				pod_map source;
+				vector<POD> pods(10000);
+				size_t extracted = 0;
+
+				fill_with_ties(source, pods);
+
+				sorted_pods s(source);
+
+				// ACT
+				s.set_order_by_key(counting_key_b(extracted), true);
+
+				// ASSERT (a selection pass over all entries and a sort of the window only)
+				assert_is_true(extracted < 3 * 10000);
+
+				// ACT / ASSERT
+				assert_equal(9999, s.at(9999).second.b);
+				assert_equal(5000, s.at(5000).second.b);
+				assert_equal(0, s.at(0).second.b);
+				assert_equal(7777u, s.find_by_key(&pods[9583]));	// 9583 * 7919 % 10000 == 7777
+
+				for (size_t i = 0; i != 10000; ++i)
+				{
+					assert_equal(static_cast<int>(i), s.at(i).second.b);
+					assert_equal(i, s.find_by_key(s.at(i).first));
+				}
+			}
+
+
+			test( IncrementalResortOfAPartiallyOrderedViewMatchesTheFullOne )
+			{
+				// INIT
+				pod_map source;
+				vector<POD> pods(10000);
+
+				fill_with_ties(source, pods);
+
+				sorted_pods incremental(source), full(source);
+
+				incremental.set_order_by_key(key_a(), true);
+				full.set_order_by_key(key_a(), true);
+
+				for (int n = 0; n != 5; ++n)
+				{
+					pod_map changed;
+
+					for (int i = n; i < 10000; i += 37)
+					{
+						POD &pod = source[&pods[i]];
+
+						pod.a = n % 2 ? pod.a / 2 : pod.a + 50;
+						changed[&pods[i]] = pod;
+					}
+
+					// ACT
+					incremental.resort(changed);
+					full.resort();
+
+					// ASSERT
+					for (size_t i = 0; i != 300; ++i)
+						assert_equal(full.at(i).first, incremental.at(i).first);
+				}
+
+				// ASSERT
+				for (size_t i = 0; i != 10000; ++i)
+					assert_equal(full.at(i).first, incremental.at(i).first);
+			}
 		end_test_suite
 	}
 }
@@ -0,0 +1,244 @@
+#include <frontend/statistics_epochs.h>
+
+#include <memory>
+#include <ut/assert.h>
+#include <ut/test.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace tests
+	{
+		namespace
+		{
+			void add(statistics_epochs &e, double now, address_t address, count_t times_called, timestamp_t time)
+			{
+				statistics_map delta;
+
+				delta[address] = function_statistics(times_called, 0, time, time, time);
+				e.add(now, delta);
+			}
+		}
+
+		begin_test_suite( StatisticsEpochsTests )
+			test( NothingIsKeptIfNoWindowIsOpen )
+			{
+				// INIT
+				statistics_epochs e;
+
+				// ACT
+				add(e, 1.3, 1, 3, 10);
+
+				// ASSERT
+				assert_equal(0u, e.size());
+			}
+
+
+			test( UpdatesWithinAnEpochAreMerged )
+			{
+				// INIT
+				statistics_epochs e(0.5);
+				statistics_epochs::window w(e, 0.5, 10.0);
+
+				// ACT
+				add(e, 10.0, 1, 3, 10);
+				add(e, 10.2, 1, 2, 15);
+				add(e, 10.4, 2, 1, 3);
+
+				// ASSERT
+				statistics_map aggregate = w.aggregate();
+
+				assert_equal(1u, e.size());
+				assert_equal(2u, aggregate.size());
+				assert_equal(5u, aggregate[1].times_called);
+				assert_equal(25, aggregate[1].exclusive_time);
+				assert_equal(15, aggregate[1].max_call_time);
+				assert_equal(1u, aggregate[2].times_called);
+			}
+
+
+			test( WindowsCoverOnlyEpochsWithinThem )
+			{
+				// INIT
+				statistics_epochs e;
+				statistics_epochs::window w1(e, 1, 0.0), w2(e, 2, 0.0), w3(e, 2.5, 0.0);
+
+				// ACT
+				add(e, 1.5, 1, 1, 100);
+				add(e, 2.5, 2, 2, 10);
+				add(e, 3.1, 1, 3, 7);
+				add(e, 3.9, 3, 1, 1);
+
+				// ASSERT
+				statistics_map aggregate = w1.aggregate();
+
+				assert_equal(2u, aggregate.size());
+				assert_equal(3u, aggregate[1].times_called);
+				assert_equal(7, aggregate[1].max_call_time);
+				assert_equal(1u, aggregate[3].times_called);
+
+				aggregate = w2.aggregate();
+
+				assert_equal(3u, aggregate.size());
+				assert_equal(3u, aggregate[1].times_called);
+				assert_equal(2u, aggregate[2].times_called);
+
+				aggregate = w3.aggregate();
+
+				assert_equal(3u, aggregate.size());
+				assert_equal(4u, aggregate[1].times_called);
+				assert_equal(107, aggregate[1].exclusive_time);
+				assert_equal(100, aggregate[1].max_call_time);
+			}
+
+
+			test( WindowIsOpenedOverTheEpochsRetained )
+			{
+				// INIT
+				statistics_epochs e;
+				statistics_epochs::window w1(e, 3, 0.0);
+
+				add(e, 1.5, 1, 1, 100);
+				add(e, 2.5, 2, 2, 10);
+				add(e, 3.1, 1, 3, 7);
+
+				// ACT
+				statistics_epochs::window w2(e, 2, 3.5);
+
+				// ASSERT
+				statistics_map aggregate = w2.aggregate();
+
+				assert_equal(2u, aggregate.size());
+				assert_equal(3u, aggregate[1].times_called);
+				assert_equal(7, aggregate[1].max_call_time);
+				assert_equal(2u, aggregate[2].times_called);
+			}
+
+
+			test( EpochsLeavingTheWindowAreSubtractedFromIt )
+			{
+				// INIT
+				statistics_epochs e;
+				statistics_epochs::window w(e, 2, 0.0);
+
+				add(e, 1.0, 1, 1, 100);
+				add(e, 2.0, 1, 2, 10);
+				add(e, 2.5, 2, 1, 5);
+
+				// ASSERT
+				statistics_map aggregate = w.aggregate();
+
+				assert_equal(3u, aggregate[1].times_called);
+				assert_equal(110, aggregate[1].exclusive_time);
+				assert_equal(100, aggregate[1].max_call_time);
+				assert_equal(1u, w.changed().size());
+				assert_is_true(w.reshaped());
+
+				// ACT
+				add(e, 3.2, 2, 1, 1);
+
+				// ASSERT
+				aggregate = w.aggregate();
+
+				assert_equal(2u, aggregate.size());
+				assert_equal(2u, aggregate[1].times_called);
+				assert_equal(10, aggregate[1].exclusive_time);
+				assert_equal(10, aggregate[1].max_call_time);
+				assert_equal(2u, aggregate[2].times_called);
+				assert_equal(6, aggregate[2].exclusive_time);
+				assert_equal(2u, w.changed().size());
+				assert_is_false(w.reshaped());
+			}
+
+
+			test( WindowsEmptyOutWhenAdvancedWithoutUpdates )
+			{
+				// INIT
+				statistics_epochs e;
+				statistics_epochs::window w(e, 2, 0.0);
+
+				add(e, 1.0, 1, 1, 100);
+				add(e, 2.0, 2, 2, 10);
+
+				// ACT
+				e.advance(3.5);
+
+				// ASSERT
+				statistics_map aggregate = w.aggregate();
+
+				assert_equal(1u, aggregate.size());
+				assert_equal(2u, aggregate[2].times_called);
+				assert_is_true(w.reshaped());
+
+				// ACT
+				e.advance(3.9);
+
+				// ASSERT
+				assert_equal(1u, w.aggregate().size());
+				assert_is_false(w.reshaped());
+
+				// ACT
+				e.advance(4.0);
+
+				// ASSERT
+				assert_is_empty(w.aggregate());
+				assert_is_true(w.reshaped());
+				assert_equal(0u, e.size());
+			}
+
+
+			test( EpochsOlderThanTheLongestOpenWindowAreDropped )
+			{
+				// INIT
+				statistics_epochs e;
+				auto_ptr<statistics_epochs::window> w2(new statistics_epochs::window(e, 2, 0.0));
+				statistics_epochs::window w1(e, 1, 0.0);
+
+				// ACT
+				add(e, 1.0, 1, 1, 1);
+				add(e, 2.0, 1, 1, 1);
+				add(e, 3.0, 2, 1, 1);
+
+				// ASSERT
+				assert_equal(2u, e.size());
+
+				// ACT
+				add(e, 7.0, 3, 1, 1);
+
+				// ASSERT
+				assert_equal(1u, e.size());
+
+				// INIT
+				add(e, 8.0, 3, 1, 1);
+
+				// ACT
+				w2.reset();
+				add(e, 9.0, 3, 1, 1);
+
+				// ASSERT
+				assert_equal(1u, e.size());
+				assert_equal(1u, w1.aggregate().size());
+			}
+
+
+			test( ClearingRemovesAllEpochs )
+			{
+				// INIT
+				statistics_epochs e;
+				statistics_epochs::window w(e, 5, 0.0);
+
+				add(e, 1.0, 1, 1, 1);
+				add(e, 2.0, 1, 1, 1);
+
+				// ACT
+				e.clear();
+
+				// ASSERT
+				assert_equal(0u, e.size());
+				assert_is_empty(w.aggregate());
+				assert_is_true(w.reshaped());
+			}
+		end_test_suite
+	}
+}
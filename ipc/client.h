@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,6 +35,7 @@ namespace micro_profiler
 		{
 		public:
 			class impl;
+			typedef std::function<void (const std::vector<byte> &output)> completion_t;
 
 		public:
 			client(const char *server_name);
@@ -41,6 +43,14 @@ namespace micro_profiler
 
 			void call(const std::vector<byte> &input, std::vector<byte> &output);
 
+			// Sends a request without waiting for the reply, so that many requests can be outstanding on the connection
+			// at once. Replies come in the order of the requests; each is passed to its completion in a buffer reused
+			// for the next reply - on the client's receiving thread (the named pipe client completes the call before
+			// returning). A broken connection completes the outstanding requests with empty replies, while destroying
+			// the client drops them. Returns the request's id - its sequence number on the connection. A completion must
+			// not call call(): it would wait for a reply that only the receiving thread it blocks can read (a deadlock).
+			unsigned long long call_async(const std::vector<byte> &input, const completion_t &on_reply);
+
 			static void enumerate_servers(std::vector<std::string> &servers);
 
 		private:
@@ -53,6 +53,8 @@ namespace micro_profiler
 			friend impl;
 		};
 
+		// Messages of one session are passed to it in order and never concurrently. Different sessions may be called
+		// on different threads at the same time (the Unix server dispatches them to a pool of workers).
 		struct server::session
 		{
 			virtual ~session() { }
@@ -0,0 +1,84 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <wpl/base/concepts.h>
+
+namespace micro_profiler
+{
+	namespace ipc
+	{
+		typedef unsigned char byte;
+
+		// A message ring in memory shared by two processes, with a single producer and a single consumer. Every message
+		// is stored contiguously (the one not fitting before the end of the ring starts over at its beginning), so the
+		// consumer reads it in place - e.g. deserializes right from the ring memory - and releases it afterwards. A side
+		// waiting for data or room sleeps on the ring position it waits to change: on a futex on Linux, on a named
+		// event on Windows. Messages larger than the capacity cannot be sent - they are to go through a socket/pipe.
+		class shared_ring : wpl::noncopyable
+		{
+		public:
+			enum {	infinite = 0xFFFFFFFF	};
+
+		public:
+			// Creates the shared memory under the name given (the capacity is rounded up to a power of two). Fails if a
+			// ring of that name exists, unless its creator is gone without removing it (POSIX shared memory outlives
+			// processes) - such a ring is replaced.
+			static std::auto_ptr<shared_ring> create(const std::string &name, size_t capacity);
+
+			// Opens a ring created by another process. Returns an empty pointer if there is no such ring.
+			static std::auto_ptr<shared_ring> open(const std::string &name);
+
+			~shared_ring();
+
+			size_t capacity() const;
+
+			// Producer side. Returns false if the message is too large, or the consumer did not release anything for
+			// 'timeout' milliseconds while the producer was waiting for room.
+			bool write(const void *data, size_t size, unsigned int timeout = infinite);
+
+			// Consumer side. The message returned stays valid and in place until release() is called. Returns false if
+			// nothing was written for 'timeout' milliseconds, or the next record claims a size running past the end of
+			// the ring (the shared memory is corrupt).
+			bool read(const byte *&data, size_t &size, unsigned int timeout = infinite);
+			void release();
+
+		private:
+			class shared_memory;
+			struct header;
+
+		private:
+			shared_ring(std::auto_ptr<shared_memory> memory);
+
+			bool wait(volatile unsigned int &position, unsigned int observed, volatile unsigned int &waiting,
+				unsigned int timeout);
+			void publish(volatile unsigned int &position, unsigned int value, volatile unsigned int &waiting);
+
+		private:
+			std::auto_ptr<shared_memory> _memory;
+			header *_header;
+			byte *_data;
+			unsigned int _mask, _read_size;
+		};
+	}
+}
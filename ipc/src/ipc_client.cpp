@@ -34,7 +34,7 @@ namespace micro_profiler
 		{
 		public:
 			impl(const char *server_name)
-				: _server_name(c_pipe_ns + c_prefix + server_name)
+				: _server_name(c_pipe_ns + c_prefix + server_name), _next_id(0)
 			{
 				HANDLE pipe = INVALID_HANDLE_VALUE;
 
@@ -49,6 +49,7 @@ namespace micro_profiler
 			{
 				DWORD dummy, message_length;
 
+				++_next_id;
 				::WriteFile(_pipe.get(), input.empty() ? NULL : &input[0], static_cast<DWORD>(input.size()), &dummy, NULL);
 				::ReadFile(_pipe.get(), NULL, 0, &dummy, NULL);
 				::PeekNamedPipe(_pipe.get(), NULL, 0, &dummy, &dummy, &message_length);
@@ -58,11 +59,21 @@ namespace micro_profiler
 					::ReadFile(_pipe.get(), &output[0], message_length, &dummy, NULL);
 			}
 
+			// No receiving thread here - the reply is waited for and passed to the completion right away.
+			unsigned long long call_async(const vector<byte> &input, const completion_t &on_reply)
+			{
+				call(input, _reply);
+				on_reply(_reply);
+				return _next_id - 1;
+			}
+
 		private:
 
 		private:
 			string _server_name;
 			shared_ptr<void> _pipe;
+			vector<byte> _reply;
+			unsigned long long _next_id;
 		};
 
 		client::client(const char *server_name)
@@ -75,6 +86,9 @@ namespace micro_profiler
 		void client::call(const vector<byte> &input, vector<byte> &output)
 		{	_impl->call(input, output);	}
 
+		unsigned long long client::call_async(const vector<byte> &input, const completion_t &on_reply)
+		{	return _impl->call_async(input, on_reply);	}
+
 		void client::enumerate_servers(vector<string> &servers)
 		{
 			BOOL more = TRUE;
@@ -0,0 +1,276 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <ipc/client.h>
+
+#include "socket.h"
+
+#include <deque>
+#include <dirent.h>
+#include <memory>
+#include <sys/stat.h>
+#include <time.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+namespace micro_profiler
+{
+	namespace ipc
+	{
+		// Calls are made directly on the caller's thread until the first asynchronous one. From then on requests are
+		// framed into an outbound buffer: the first caller finding nobody sending becomes the sender and keeps writing
+		// what the others accumulate meanwhile, while the replies are read by the receiving thread and matched to the
+		// outstanding requests in order. A direct call owns the socket until its reply is read: other calls (either
+		// kind) wait for it, so that the receiving thread never starts while a reply is being read outside of it.
+		class client::impl
+		{
+		public:
+			impl(const char *server_name);
+			~impl();
+
+			void call(const vector<byte> &input, vector<byte> &output);
+			unsigned long long call_async(const vector<byte> &input, const completion_t &on_reply);
+
+		private:
+			struct sync_call
+			{
+				vector<byte> *output;
+				bool done;
+			};
+
+		private:
+			void complete(sync_call *call, const vector<byte> &reply);
+			void receive();
+			static void *receive_proc(void *self);
+
+		private:
+			socket_handle _socket;
+			mutex _mutex;
+			condition _completed;
+			deque<completion_t> _pending;
+			vector<byte> _outbound, _sending, _reply;
+			unsigned long long _next_id;
+			bool _writing, _receiving, _closing, _broken, _direct_call;
+			pthread_t _receiver;
+		};
+
+
+
+		client::impl::impl(const char *server_name)
+			: _next_id(0), _writing(false), _receiving(false), _closing(false), _broken(false), _direct_call(false)
+		{
+			sockaddr_un address;
+
+			if (!make_socket_address(address, server_name))
+				return;
+
+			// Just like the named pipe client, waits for the server to appear.
+			for (;;)
+			{
+				_socket.reset(socket(AF_UNIX, SOCK_STREAM, 0));
+				if (!connect(_socket.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)))
+					break;
+
+				const timespec delay = {	0, 10000000	};
+
+				nanosleep(&delay, NULL);
+			}
+		}
+
+		client::impl::~impl()
+		{
+			if (_receiving)
+			{
+				{
+					scoped_lock l(_mutex);
+
+					_closing = true;
+				}
+				shutdown(_socket.get(), SHUT_RDWR);
+				pthread_join(_receiver, NULL);
+			}
+		}
+
+		void client::impl::call(const vector<byte> &input, vector<byte> &output)
+		{
+			{
+				scoped_lock l(_mutex);
+
+				while (_direct_call)
+					_completed.wait(_mutex);
+				if (_receiving)
+				{
+					sync_call c = {	&output, false	};
+
+					_mutex.leave();
+					call_async(input, bind(&impl::complete, this, &c, _1));
+					_mutex.enter();
+					while (!c.done)
+						_completed.wait(_mutex);
+					return;
+				}
+				_direct_call = true;
+				++_next_id;
+			}
+
+			frame_header header = static_cast<frame_header>(input.size());
+
+			output.clear();
+			if (send_frame(_socket.get(), header, input.empty() ? NULL : &input[0], 0) >= 0
+				&& receive_all(_socket.get(), &header, sizeof(header)))
+			{
+				output.resize(header);
+				if (header && !receive_all(_socket.get(), &output[0], header))
+					output.clear();
+			}
+
+			scoped_lock l(_mutex);
+
+			_direct_call = false;
+			_completed.notify_all();
+		}
+
+		unsigned long long client::impl::call_async(const vector<byte> &input, const completion_t &on_reply)
+		{
+			const frame_header header = static_cast<frame_header>(input.size());
+			const byte *header_bytes = reinterpret_cast<const byte *>(&header);
+			scoped_lock l(_mutex);
+
+			while (_direct_call)
+				_completed.wait(_mutex);
+
+			const unsigned long long id = _next_id++;
+
+			if (_broken)
+			{
+				_mutex.leave();
+				on_reply(vector<byte>());
+				_mutex.enter();
+				return id;
+			}
+			_pending.push_back(on_reply);
+			_outbound.insert(_outbound.end(), header_bytes, header_bytes + sizeof(header));
+			_outbound.insert(_outbound.end(), input.begin(), input.end());
+			if (!_receiving)
+				_receiving = !pthread_create(&_receiver, NULL, &receive_proc, this);
+			if (_writing)
+				return id;	// The current sender will write this request too.
+			for (_writing = true; !_outbound.empty(); _sending.clear())
+			{
+				_sending.swap(_outbound);
+				_mutex.leave();
+				send_all(_socket.get(), &_sending[0], _sending.size());	// A failure is seen by the receiver.
+				_mutex.enter();
+			}
+			_writing = false;
+			return id;
+		}
+
+		void client::impl::complete(sync_call *call, const vector<byte> &reply)
+		{
+			scoped_lock l(_mutex);
+
+			call->output->assign(reply.begin(), reply.end());
+			call->done = true;
+			_completed.notify_all();
+		}
+
+		void client::impl::receive()
+		{
+			for (frame_header header; ; )
+			{
+				completion_t on_reply;
+				const bool received = receive_all(_socket.get(), &header, sizeof(header))
+					&& (_reply.resize(header), !header || receive_all(_socket.get(), &_reply[0], header));
+				scoped_lock l(_mutex);
+
+				if (_closing)
+					return;
+				if (!received)
+					break;
+				if (_pending.empty())
+					continue;
+				on_reply.swap(_pending.front());
+				_pending.pop_front();
+				_mutex.leave();
+				on_reply(_reply);
+				_mutex.enter();
+			}
+
+			deque<completion_t> pending;
+
+			{
+				scoped_lock l(_mutex);
+
+				_broken = true;
+				pending.swap(_pending);
+			}
+			_reply.clear();
+			for (deque<completion_t>::const_iterator i = pending.begin(); i != pending.end(); ++i)
+				(*i)(_reply);
+		}
+
+		void *client::impl::receive_proc(void *self)
+		{
+			static_cast<impl *>(self)->receive();
+			return NULL;
+		}
+
+
+		client::client(const char *server_name)
+			: _impl(new impl(server_name))
+		{	}
+
+		client::~client()
+		{	}
+
+		void client::call(const vector<byte> &input, vector<byte> &output)
+		{	_impl->call(input, output);	}
+
+		unsigned long long client::call_async(const vector<byte> &input, const completion_t &on_reply)
+		{	return _impl->call_async(input, on_reply);	}
+
+		void client::enumerate_servers(vector<string> &servers)
+		{
+			const string directory = socket_directory();
+
+			servers.clear();
+			if (DIR *opened = opendir(directory.c_str()))
+			{
+				const shared_ptr<DIR> d(opened, &closedir);
+
+				while (const dirent *entry = readdir(d.get()))
+				{
+					const string name(entry->d_name);
+					struct stat s;
+
+					sockaddr_un address;
+
+					if (0 == name.find(c_prefix) && !lstat((directory + "/" + name).c_str(), &s) && S_ISSOCK(s.st_mode)
+						&& make_socket_address(address, name.substr(c_prefix.size())) && !is_stale_socket(address))
+					{
+						servers.push_back(name.substr(c_prefix.size()));
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,477 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <ipc/server.h>
+
+#include "socket.h"
+
+#include <algorithm>
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace ipc
+	{
+		namespace
+		{
+			const int c_min_workers = 4;
+			const int c_max_workers = 16;
+			const int c_events_per_wait = 64;
+			const size_t c_max_queued_requests = 64;
+			const unsigned int c_session_events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+
+			void set_nonblocking(int fd)
+			{	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);	}
+		}
+
+		// The server thread waits on an edge-triggered epoll set and does all the reading: complete requests are queued
+		// to their sessions, and the sessions having requests are queued to a pool of workers. A session is processed
+		// by one worker at a time, so its requests are handled (and replied to) in order, while a slow session only
+		// holds its own worker. A session having c_max_queued_requests requests pending is not read from (its EPOLLIN
+		// is dropped) until the worker takes half of them, so that a client outpacing the server is held back by the
+		// socket buffers instead of the server's memory. A spare descriptor is held in reserve: when the process runs out
+		// of them, it is released to accept the pending connections and turn them down, so that the edge-triggered
+		// listener is drained and keeps reporting new ones. Should even that fail, the listener is re-armed once a
+		// session closes.
+		class server::impl
+		{
+		public:
+			impl(const char *server_name, server *server_);
+			~impl();
+
+			void run();
+			void stop();
+
+			server::session *create_session();
+			void schedule(const shared_ptr<server::outer_session> &session);
+			void watch_input(int fd, bool enable);
+
+		private:
+			typedef map< int, shared_ptr<server::outer_session> > sessions_t;
+
+		private:
+			void accept_sessions();
+			void close_session(sessions_t::iterator i);
+			void add(int fd, unsigned int events);
+			void modify(int fd, unsigned int events);
+			void worker();
+			static void *worker_proc(void *self);
+
+		private:
+			server *_server;
+			sockaddr_un _address;
+			socket_handle _listener, _stop_read, _stop_write, _epoll, _reserve;
+			sessions_t _sessions;
+			bool _accept_stalled;
+			mutex _mutex;
+			condition _ready_cv;
+			deque< shared_ptr<server::outer_session> > _ready;
+			bool _stopping;
+			vector<pthread_t> _workers;
+		};
+
+		// A session reads requests (on the server thread) into buffers of the exact size taken from their headers, and
+		// hands them over to a worker. Replies are sent by the worker, if the socket can take them, or by the server
+		// thread once the socket becomes writable again.
+		class server::outer_session : wpl::noncopyable, public enable_shared_from_this<server::outer_session>
+		{
+		public:
+			outer_session(server::impl &server, int fd);
+
+			bool read();
+			void write();
+			void process();
+
+		private:
+			void flush();
+			void throttle(bool enable);
+
+		private:
+			server::impl &_server;
+			socket_handle _socket;
+			auto_ptr<server::session> _inner;
+			frame_header _header;
+			size_t _received;
+			vector<byte> _input;
+
+			mutex _mutex;
+			deque< vector<byte> > _requests, _replies;
+			size_t _sent;
+			bool _scheduled, _throttled;
+		};
+
+
+
+		server::impl::impl(const char *server_name, server *server_)
+			: _server(server_), _epoll(epoll_create1(0)), _reserve(open("/dev/null", O_RDONLY)), _accept_stalled(false),
+				_stopping(false)
+		{
+			int stop_pipe[2];
+			const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+			const int workers = min(c_max_workers, max(c_min_workers, static_cast<int>(processors)));
+
+			for (int i = 0; i != workers; ++i)
+			{
+				pthread_t worker;
+
+				if (!pthread_create(&worker, NULL, &worker_proc, this))
+					_workers.push_back(worker);
+			}
+			if (!pipe(stop_pipe))
+			{
+				_stop_read.reset(stop_pipe[0]);
+				_stop_write.reset(stop_pipe[1]);
+				add(_stop_read.get(), EPOLLIN);
+			}
+			if (!make_socket_address(_address, server_name))
+				return;
+			if (is_stale_socket(_address))
+				unlink(_address.sun_path);	// A socket left behind by a process that did not exit gracefully.
+			_listener.reset(socket(AF_UNIX, SOCK_STREAM, 0));
+			if (bind(_listener.get(), reinterpret_cast<const sockaddr *>(&_address), sizeof(_address))
+				|| listen(_listener.get(), SOMAXCONN))
+			{
+				_listener.reset();
+				return;
+			}
+			set_nonblocking(_listener.get());
+			add(_listener.get(), EPOLLIN | EPOLLET);
+		}
+
+		server::impl::~impl()
+		{
+			{
+				scoped_lock l(_mutex);
+
+				_stopping = true;
+				_ready_cv.notify_all();
+			}
+			for (vector<pthread_t>::const_iterator i = _workers.begin(); i != _workers.end(); ++i)
+				pthread_join(*i, NULL);
+			_ready.clear();
+			_sessions.clear();
+			if (_listener.get() >= 0)
+				unlink(_address.sun_path);
+		}
+
+		void server::impl::run()
+		{
+			epoll_event events[c_events_per_wait];
+
+			for (;;)
+			{
+				const int n = epoll_wait(_epoll.get(), events, c_events_per_wait, -1);
+
+				if (n < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					return;
+				}
+				for (int i = 0; i != n; ++i)
+				{
+					const int fd = events[i].data.fd;
+					const unsigned int e = events[i].events;
+					sessions_t::iterator s;
+
+					if (fd == _stop_read.get())
+						return;
+					else if (fd == _listener.get())
+						accept_sessions();
+					else if (s = _sessions.find(fd), s == _sessions.end())
+						continue;
+					else if (e & EPOLLERR)
+						close_session(s);
+					else
+					{
+						if (e & EPOLLOUT)
+							s->second->write();
+						if ((e & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) && !s->second->read())
+							close_session(s);	// A hang-up is detected by reading the end of the stream.
+					}
+				}
+			}
+		}
+
+		void server::impl::stop()
+		{
+			const byte stop = 0;
+
+			// The pipe is never read, so the server stays stopped, like with the manual-reset event on Windows.
+			if (write(_stop_write.get(), &stop, sizeof(stop)) < 0)
+			{	}
+		}
+
+		server::session *server::impl::create_session()
+		{	return _server->create_session();	}
+
+		void server::impl::schedule(const shared_ptr<server::outer_session> &session)
+		{
+			scoped_lock l(_mutex);
+
+			_ready.push_back(session);
+			_ready_cv.notify_one();
+		}
+
+		void server::impl::accept_sessions()
+		{
+			for (;;)
+			{
+				int fd = accept(_listener.get(), NULL, NULL);
+
+				if (fd < 0 && (errno == EMFILE || errno == ENFILE) && _reserve.get() >= 0)
+				{
+					_reserve.reset();
+					fd = accept(_listener.get(), NULL, NULL);
+					if (fd >= 0)
+						close(fd);
+					_reserve.reset(open("/dev/null", O_RDONLY));
+					if (fd >= 0)
+						continue;
+				}
+				if (fd < 0)
+				{
+					if (errno == EINTR || errno == ECONNABORTED)
+						continue;
+					_accept_stalled = errno != EAGAIN && errno != EWOULDBLOCK;
+					return;
+				}
+				_sessions[fd].reset(new outer_session(*this, fd));
+				add(fd, c_session_events);
+			}
+		}
+
+		void server::impl::close_session(sessions_t::iterator i)
+		{
+			// The socket is closed once the session is released by the workers too.
+			epoll_ctl(_epoll.get(), EPOLL_CTL_DEL, i->first, NULL);
+			_sessions.erase(i);
+			if (_accept_stalled)
+			{
+				_accept_stalled = false;
+				modify(_listener.get(), EPOLLIN | EPOLLET);
+			}
+		}
+
+		void server::impl::watch_input(int fd, bool enable)
+		{	modify(fd, enable ? c_session_events : c_session_events & ~EPOLLIN);	}
+
+		void server::impl::add(int fd, unsigned int events)
+		{
+			epoll_event e = zero_init();
+
+			e.events = events;
+			e.data.fd = fd;
+			epoll_ctl(_epoll.get(), EPOLL_CTL_ADD, fd, &e);
+		}
+
+		void server::impl::modify(int fd, unsigned int events)
+		{
+			epoll_event e = zero_init();
+
+			// Modifying the set re-arms the edge-triggered notification, so the input pending is reported again.
+			e.events = events;
+			e.data.fd = fd;
+			epoll_ctl(_epoll.get(), EPOLL_CTL_MOD, fd, &e);
+		}
+
+		void server::impl::worker()
+		{
+			for (;;)
+			{
+				shared_ptr<server::outer_session> session;
+
+				{
+					scoped_lock l(_mutex);
+
+					while (!_stopping && _ready.empty())
+						_ready_cv.wait(_mutex);
+					if (_stopping)
+						return;
+					session = _ready.front();
+					_ready.pop_front();
+				}
+				session->process();
+			}
+		}
+
+		void *server::impl::worker_proc(void *self)
+		{
+			static_cast<impl *>(self)->worker();
+			return NULL;
+		}
+
+
+		server::outer_session::outer_session(server::impl &server, int fd)
+			: _server(server), _socket(fd), _inner(server.create_session()), _header(0), _received(0), _sent(0),
+				_scheduled(false), _throttled(false)
+		{	set_nonblocking(fd);	}
+
+		bool server::outer_session::read()
+		{
+			bool schedule = false, alive = true;
+
+			{
+				scoped_lock l(_mutex);
+
+				if (_throttled)
+					return true;	// Reported before the input was dropped - the worker re-arms it.
+			}
+			for (;;)
+			{
+				const size_t body_offset = _received - sizeof(_header);
+				byte *buffer;
+				size_t remaining;
+
+				if (_received < sizeof(_header))
+				{
+					buffer = reinterpret_cast<byte *>(&_header) + _received, remaining = sizeof(_header) - _received;
+				}
+				else if (body_offset < _input.size())
+				{
+					buffer = &_input[body_offset], remaining = _input.size() - body_offset;
+				}
+				else
+				{
+					scoped_lock l(_mutex);
+
+					_requests.push_back(vector<byte>());
+					_requests.back().swap(_input);
+					schedule = schedule || !_scheduled;
+					_scheduled = true;
+					_received = 0;
+					if (_requests.size() < c_max_queued_requests)
+						continue;
+					throttle(true);
+					break;
+				}
+
+				const ssize_t received = recv(_socket.get(), buffer, remaining, 0);
+
+				if (received < 0 && errno == EINTR)
+					continue;
+				if (received <= 0)
+				{
+					alive = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+					break;
+				}
+				if ((_received += received) == sizeof(_header))
+				{
+					if (_header > c_max_frame_size)
+					{
+						alive = false;
+						break;
+					}
+					_input.resize(_header);
+				}
+			}
+			if (schedule)
+				_server.schedule(shared_from_this());
+			return alive;
+		}
+
+		void server::outer_session::write()
+		{
+			scoped_lock l(_mutex);
+
+			flush();
+		}
+
+		void server::outer_session::process()
+		{
+			for (vector<byte> input, output; ; output.clear())
+			{
+				{
+					scoped_lock l(_mutex);
+
+					if (_requests.empty())
+					{
+						_scheduled = false;
+						return;
+					}
+					input.swap(_requests.front());
+					_requests.pop_front();
+					if (_throttled && _requests.size() <= c_max_queued_requests / 2)
+						throttle(false);
+				}
+				_inner->on_message(input, output);
+				{
+					scoped_lock l(_mutex);
+
+					_replies.push_back(vector<byte>());
+					_replies.back().swap(output);
+					flush();
+				}
+			}
+		}
+
+		void server::outer_session::flush()
+		{
+			while (!_replies.empty())
+			{
+				const vector<byte> &reply = _replies.front();
+				const frame_header header = static_cast<frame_header>(reply.size());
+				const long long sent = send_frame(_socket.get(), header, reply.empty() ? 0 : &reply[0], _sent);
+
+				if (sent < 0)
+				{
+					_replies.clear();	// The peer is gone - the server thread will see the end of the stream.
+					_sent = 0;
+				}
+				else if (static_cast<size_t>(sent) == sizeof(header) + header)
+				{
+					_replies.pop_front();
+					_sent = 0;
+				}
+				else
+				{
+					_sent = static_cast<size_t>(sent);	// Resumed on EPOLLOUT.
+					break;
+				}
+			}
+		}
+
+		void server::outer_session::throttle(bool enable)
+		{
+			_throttled = enable;
+			_server.watch_input(_socket.get(), !enable);
+		}
+
+
+		server::server(const char *server_name)
+		{	_impl = new impl(server_name, this);	}
+
+		server::~server()
+		{	delete _impl;	}
+
+		void server::run()
+		{	_impl->run();	}
+
+		void server::stop()
+		{	_impl->stop();	}
+	}
+}
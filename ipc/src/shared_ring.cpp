@@ -0,0 +1,439 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <ipc/shared_ring.h>
+
+#include "common.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+	#include <intrin.h>
+	#include <windows.h>
+#else
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <time.h>
+	#include <unistd.h>
+
+	#if defined(__linux__)
+		#include <linux/futex.h>
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+using namespace std;
+
+namespace micro_profiler
+{
+	namespace ipc
+	{
+		namespace
+		{
+			const unsigned int c_signature = 0x474E4952u; // 'RING'
+			const unsigned int c_wrap = 0xFFFFFFFFu;
+			const unsigned int c_alignment = 8;
+			const unsigned int c_spin_count = 256;
+
+			unsigned int load(const volatile unsigned int &value)
+			{
+#if defined(_MSC_VER)
+				return value;
+#else
+				return __atomic_load_n(&value, __ATOMIC_SEQ_CST);
+#endif
+			}
+
+			void store(volatile unsigned int &value, unsigned int new_value)
+			{
+#if defined(_MSC_VER)
+				_InterlockedExchange(reinterpret_cast<volatile long *>(&value), static_cast<long>(new_value));
+#else
+				__atomic_store_n(&value, new_value, __ATOMIC_SEQ_CST);
+#endif
+			}
+
+			unsigned int record_size(size_t size)
+			{	return static_cast<unsigned int>((sizeof(unsigned int) + size + c_alignment - 1) & ~(c_alignment - 1));	}
+
+			unsigned int current_process_id()
+			{
+#if defined(_WIN32)
+				return ::GetCurrentProcessId();
+#else
+				return static_cast<unsigned int>(::getpid());
+#endif
+			}
+		}
+
+		// The header occupies its own cache lines, the producer-owned and the consumer-owned parts apart. The creator
+		// records its process id, so that a ring it left behind (POSIX shared memory outlives processes) is recognized.
+		struct shared_ring::header
+		{
+			unsigned int signature, capacity, creator;
+			char padding1[52];
+			volatile unsigned int head, consumer_waiting;
+			char padding2[56];
+			volatile unsigned int tail, producer_waiting;
+			char padding3[56];
+		};
+
+#if defined(_WIN32)
+		class shared_ring::shared_memory
+		{
+		public:
+			shared_memory(HANDLE mapping, const string &name)
+				: _mapping(mapping), _view(::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0))
+			{
+				_events[0] = ::CreateEventA(NULL, FALSE, FALSE, (name + ".head").c_str());
+				_events[1] = ::CreateEventA(NULL, FALSE, FALSE, (name + ".tail").c_str());
+			}
+
+			~shared_memory()
+			{
+				::CloseHandle(_events[1]);
+				::CloseHandle(_events[0]);
+				if (_view)
+					::UnmapViewOfFile(_view);
+				::CloseHandle(_mapping);
+			}
+
+			static auto_ptr<shared_memory> create(const string &name, size_t size)
+			{
+				const string mapping_name = "Local\\" + c_prefix + name;
+				HANDLE mapping = ::CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+					static_cast<DWORD>(size), mapping_name.c_str());
+
+				if (mapping && ::GetLastError() == ERROR_ALREADY_EXISTS)
+					::CloseHandle(mapping), mapping = NULL;
+				return auto_ptr<shared_memory>(mapping ? new shared_memory(mapping, mapping_name) : 0);
+			}
+
+			static auto_ptr<shared_memory> open(const string &name)
+			{
+				const string mapping_name = "Local\\" + c_prefix + name;
+				HANDLE mapping = ::OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mapping_name.c_str());
+
+				return auto_ptr<shared_memory>(mapping ? new shared_memory(mapping, mapping_name) : 0);
+			}
+
+			void *get() const
+			{	return _view;	}
+
+			size_t size() const
+			{
+				MEMORY_BASIC_INFORMATION mbi = {	};
+
+				return _view && ::VirtualQuery(_view, &mbi, sizeof(mbi)) ? mbi.RegionSize : 0;
+			}
+
+			bool wait(volatile unsigned int &position, unsigned int observed, unsigned int timeout)
+			{
+				return load(position) != observed
+					|| ::WaitForSingleObject(_events[event_index(position)], timeout) == WAIT_OBJECT_0;
+			}
+
+			void wake(volatile unsigned int &position)
+			{	::SetEvent(_events[event_index(position)]);	}
+
+		private:
+			unsigned int event_index(volatile unsigned int &position) const
+			{	return &position == &static_cast<header *>(_view)->head ? 0 : 1;	}
+
+		private:
+			HANDLE _mapping, _events[2];
+			void *_view;
+		};
+#else
+		class shared_ring::shared_memory
+		{
+		public:
+			shared_memory(int fd, const string &name, bool owner)
+				: _name(name), _owner(owner), _view(MAP_FAILED), _size(0)
+			{
+				struct stat s;
+
+				if (!::fstat(fd, &s) && s.st_size)
+				{
+					_size = static_cast<size_t>(s.st_size);
+					_view = ::mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				}
+				::close(fd);
+			}
+
+			~shared_memory()
+			{
+				if (_view != MAP_FAILED)
+					::munmap(_view, _size);
+				if (_owner)
+					::shm_unlink(_name.c_str());
+			}
+
+			static auto_ptr<shared_memory> create(const string &name, size_t size)
+			{
+				const string object_name = "/" + c_prefix + name;
+				int fd = ::shm_open(object_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+				if (fd < 0 && errno == EEXIST && is_abandoned(object_name))
+				{
+					::shm_unlink(object_name.c_str());
+					fd = ::shm_open(object_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+				}
+				if (fd < 0)
+					return auto_ptr<shared_memory>();
+				if (::ftruncate(fd, static_cast<off_t>(size)))
+				{
+					::close(fd);
+					::shm_unlink(object_name.c_str());
+					return auto_ptr<shared_memory>();
+				}
+				return auto_ptr<shared_memory>(new shared_memory(fd, object_name, true));
+			}
+
+			static auto_ptr<shared_memory> open(const string &name)
+			{
+				const string object_name = "/" + c_prefix + name;
+				int fd = ::shm_open(object_name.c_str(), O_RDWR, 0);
+
+				return auto_ptr<shared_memory>(fd >= 0 ? new shared_memory(fd, object_name, false) : 0);
+			}
+
+			void *get() const
+			{	return _view != MAP_FAILED ? _view : 0;	}
+
+			size_t size() const
+			{	return _size;	}
+
+			bool wait(volatile unsigned int &position, unsigned int observed, unsigned int timeout)
+			{
+	#if defined(__linux__)
+				const timespec t = {	timeout / 1000, (timeout % 1000) * 1000000	};
+
+				return !::syscall(SYS_futex, &position, FUTEX_WAIT, observed,
+					timeout != shared_ring::infinite ? &t : NULL, NULL, 0) || errno != ETIMEDOUT;
+	#else
+				// No address-based waits available - polling.
+				for (unsigned int waited = 0; load(position) == observed; ++waited)
+				{
+					const timespec delay = {	0, 1000000	};
+
+					if (waited == timeout)
+						return false;
+					::nanosleep(&delay, NULL);
+				}
+				return true;
+	#endif
+			}
+
+	#if defined(__linux__)
+			void wake(volatile unsigned int &position)
+			{	::syscall(SYS_futex, &position, FUTEX_WAKE, 1, NULL, NULL, 0);	}
+	#else
+			void wake(volatile unsigned int &/*position*/)
+			{	}
+	#endif
+
+		private:
+			// A ring is abandoned if its creator is gone without unlinking it (e.g. crashed). A ring still being
+			// initialized (no signature yet) is not.
+			static bool is_abandoned(const string &object_name)
+			{
+				const int fd = ::shm_open(object_name.c_str(), O_RDONLY, 0);
+				struct stat s;
+				bool abandoned = false;
+
+				if (fd < 0)
+					return false;
+				if (!::fstat(fd, &s) && static_cast<size_t>(s.st_size) >= sizeof(header))
+				{
+					void *view = ::mmap(NULL, sizeof(header), PROT_READ, MAP_SHARED, fd, 0);
+
+					if (view != MAP_FAILED)
+					{
+						const header &h = *static_cast<const header *>(view);
+
+						abandoned = h.signature == c_signature && h.creator
+							&& ::kill(static_cast<pid_t>(h.creator), 0) && errno == ESRCH;
+						::munmap(view, sizeof(header));
+					}
+				}
+				::close(fd);
+				return abandoned;
+			}
+
+		private:
+			const string _name;
+			const bool _owner;
+			void *_view;
+			size_t _size;
+		};
+#endif
+
+		shared_ring::shared_ring(auto_ptr<shared_memory> memory)
+			: _memory(memory), _header(static_cast<header *>(_memory->get())),
+				_data(reinterpret_cast<byte *>(_header + 1)), _mask(_header->capacity - 1), _read_size(0)
+		{	}
+
+		shared_ring::~shared_ring()
+		{	}
+
+		auto_ptr<shared_ring> shared_ring::create(const string &name, size_t capacity)
+		{
+			unsigned int capacity_ = 4 * c_alignment;
+
+			while (capacity_ < capacity && capacity_ < 0x80000000u)
+				capacity_ <<= 1;
+
+			auto_ptr<shared_memory> memory = shared_memory::create(name, sizeof(header) + capacity_);
+
+			if (!memory.get() || !memory->get())
+				return auto_ptr<shared_ring>();
+
+			header *h = static_cast<header *>(memory->get());
+
+			memset(h, 0, sizeof(header));
+			h->capacity = capacity_;
+			h->creator = current_process_id();
+			store(h->signature, c_signature);
+			return auto_ptr<shared_ring>(new shared_ring(memory));
+		}
+
+		auto_ptr<shared_ring> shared_ring::open(const string &name)
+		{
+			auto_ptr<shared_memory> memory = shared_memory::open(name);
+
+			if (!memory.get() || !memory->get() || memory->size() < sizeof(header))
+				return auto_ptr<shared_ring>();
+
+			const header &h = *static_cast<const header *>(memory->get());
+			const unsigned int capacity_ = h.capacity;
+
+			// The capacity is validated once here - the ring uses the mask computed from it from then on.
+			if (h.signature != c_signature || capacity_ < 4 * c_alignment || (capacity_ & (capacity_ - 1))
+				|| memory->size() - sizeof(header) < capacity_)
+			{
+				return auto_ptr<shared_ring>();
+			}
+			return auto_ptr<shared_ring>(new shared_ring(memory));
+		}
+
+		size_t shared_ring::capacity() const
+		{	return _mask + 1;	}
+
+		bool shared_ring::write(const void *data, size_t size, unsigned int timeout)
+		{
+			const unsigned int capacity_ = _mask + 1;
+			const unsigned int required = record_size(size);
+			unsigned int head = _header->head;
+			const unsigned int to_end = capacity_ - (head & _mask);
+
+			if (size > capacity_ - sizeof(unsigned int))
+				return false;
+
+			if (to_end < required)
+			{
+				// The message would not be contiguous - skipping the rest of the ring.
+				for (unsigned int tail; tail = load(_header->tail), capacity_ - (head - tail) < to_end; )
+				{
+					if (!wait(_header->tail, tail, _header->producer_waiting, timeout))
+						return false;
+				}
+				*reinterpret_cast<unsigned int *>(_data + (head & _mask)) = c_wrap;
+				publish(_header->head, head += to_end, _header->consumer_waiting);
+			}
+			for (unsigned int tail; tail = load(_header->tail), capacity_ - (head - tail) < required; )
+			{
+				if (!wait(_header->tail, tail, _header->producer_waiting, timeout))
+					return false;
+			}
+
+			byte *record = _data + (head & _mask);
+
+			*reinterpret_cast<unsigned int *>(record) = static_cast<unsigned int>(size);
+			memcpy(record + sizeof(unsigned int), data, size);
+			publish(_header->head, head + required, _header->consumer_waiting);
+			return true;
+		}
+
+		bool shared_ring::read(const byte *&data, size_t &size, unsigned int timeout)
+		{
+			unsigned int tail = _header->tail;
+
+			for (;;)
+			{
+				for (unsigned int head; head = load(_header->head), head == tail; )
+				{
+					if (!wait(_header->head, head, _header->consumer_waiting, timeout))
+						return false;
+				}
+
+				const unsigned int to_end = _mask + 1 - (tail & _mask);
+				const byte *record = _data + (tail & _mask);
+				const unsigned int size_ = *reinterpret_cast<const unsigned int *>(record);
+
+				if (size_ == c_wrap)
+				{
+					publish(_header->tail, tail += to_end, _header->producer_waiting);
+					continue;
+				}
+				if (size_ > to_end - sizeof(unsigned int))
+					return false;	// The other side wrote a record running past the end of the ring.
+				data = record + sizeof(unsigned int);
+				size = size_;
+				_read_size = record_size(size_);
+				return true;
+			}
+		}
+
+		void shared_ring::release()
+		{
+			publish(_header->tail, _header->tail + _read_size, _header->producer_waiting);
+			_read_size = 0;
+		}
+
+		bool shared_ring::wait(volatile unsigned int &position, unsigned int observed, volatile unsigned int &waiting,
+			unsigned int timeout)
+		{
+			// The other side is often about to move the position - it is cheaper to spin briefly than to sleep.
+			for (unsigned int i = 0; i != c_spin_count; ++i)
+			{
+				if (load(position) != observed)
+					return true;
+			}
+			store(waiting, 1);
+
+			// The other side might have moved the position before seeing the flag raised.
+			const bool changed = load(position) != observed || _memory->wait(position, observed, timeout);
+
+			store(waiting, 0);
+			return changed;
+		}
+
+		void shared_ring::publish(volatile unsigned int &position, unsigned int value, volatile unsigned int &waiting)
+		{
+			store(position, value);
+			if (load(waiting))
+				_memory->wake(position);
+		}
+	}
+}
@@ -0,0 +1,175 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#pragma once
+
+#include "common.h"
+
+#include <collector/system.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <wpl/base/concepts.h>
+
+#ifndef MSG_NOSIGNAL
+	#define MSG_NOSIGNAL 0
+#endif
+
+namespace micro_profiler
+{
+	namespace ipc
+	{
+		// Unix domain socket transport. Servers listen on stream sockets created in the runtime directory, each named
+		// by the common prefix followed by the server name. Every message (both ways) is preceded by its length as a
+		// 32-bit unsigned integer in the host byte order. A peer sending a longer message than c_max_frame_size is
+		// disconnected.
+		typedef unsigned int frame_header;
+
+		const frame_header c_max_frame_size = 256 * 1024 * 1024;
+
+		class socket_handle : wpl::noncopyable
+		{
+		public:
+			explicit socket_handle(int fd = -1);
+			~socket_handle();
+
+			int get() const;
+			void reset(int fd = -1);
+
+		private:
+			int _fd;
+		};
+
+
+
+		inline std::string socket_directory()
+		{
+			const char *runtime = getenv("XDG_RUNTIME_DIR");
+
+			return runtime && *runtime ? runtime : "/tmp";
+		}
+
+		inline bool make_socket_address(sockaddr_un &address, const std::string &server_name)
+		{
+			const std::string path = socket_directory() + "/" + c_prefix + server_name;
+
+			address = zero_init();
+			address.sun_family = AF_UNIX;
+			if (path.size() >= sizeof(address.sun_path))
+				return false;
+			strcpy(address.sun_path, path.c_str());
+			return true;
+		}
+
+		// Tells whether the socket file at the address was left behind by a server that is gone: nothing listens on it,
+		// so connecting is refused. A missing file or a live server is not stale.
+		inline bool is_stale_socket(const sockaddr_un &address)
+		{
+			socket_handle probe(socket(AF_UNIX, SOCK_STREAM, 0));
+
+			return probe.get() >= 0 && connect(probe.get(), reinterpret_cast<const sockaddr *>(&address),
+				sizeof(address)) && errno == ECONNREFUSED;
+		}
+
+		// Sends the header followed by the payload, starting at 'offset' into the frame. Returns the new offset (less
+		// than the frame size, if a non-blocking socket cannot take more data at the moment) or -1 on error.
+		inline long long send_frame(int fd, const frame_header &header, const void *payload, size_t offset)
+		{
+			const size_t total = sizeof(header) + header;
+
+			while (offset < total)
+			{
+				iovec chunks[2];
+				msghdr message = zero_init();
+
+				message.msg_iov = chunks;
+				if (offset < sizeof(header))
+				{
+					chunks[message.msg_iovlen].iov_base = (char *)&header + offset;
+					chunks[message.msg_iovlen++].iov_len = sizeof(header) - offset;
+				}
+				chunks[message.msg_iovlen].iov_base = (char *)payload + (offset > sizeof(header)
+					? offset - sizeof(header) : 0);
+				chunks[message.msg_iovlen++].iov_len = total - (offset > sizeof(header) ? offset : sizeof(header));
+
+				const ssize_t sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+
+				if (sent >= 0)
+					offset += sent;
+				else if (errno == EAGAIN || errno == EWOULDBLOCK)
+					break;
+				else if (errno != EINTR)
+					return -1;
+			}
+			return static_cast<long long>(offset);
+		}
+
+		inline bool send_all(int fd, const void *buffer, size_t size)
+		{
+			for (const char *b = static_cast<const char *>(buffer); size; )
+			{
+				const ssize_t sent = send(fd, b, size, MSG_NOSIGNAL);
+
+				if (sent >= 0)
+					b += sent, size -= sent;
+				else if (errno != EINTR)
+					return false;
+			}
+			return true;
+		}
+
+		inline bool receive_all(int fd, void *buffer, size_t size)
+		{
+			for (char *b = static_cast<char *>(buffer); size; )
+			{
+				const ssize_t received = recv(fd, b, size, 0);
+
+				if (received > 0)
+					b += received, size -= received;
+				else if (received == 0 || errno != EINTR)
+					return false;
+			}
+			return true;
+		}
+
+
+		inline socket_handle::socket_handle(int fd)
+			: _fd(fd)
+		{	}
+
+		inline socket_handle::~socket_handle()
+		{	reset();	}
+
+		inline int socket_handle::get() const
+		{	return _fd;	}
+
+		inline void socket_handle::reset(int fd)
+		{
+			if (_fd >= 0)
+				close(_fd);
+			_fd = fd;
+		}
+	}
+}
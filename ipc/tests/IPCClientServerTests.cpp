@@ -3,8 +3,13 @@
 
 #include <test-helpers/helpers.h>
 
+#include <algorithm>
 #include <collector/system.h>
 #include <deque>
+#ifndef _WIN32
+	#include <ipc/src/socket.h>
+	#include <sys/resource.h>
+#endif
 #include <wpl/base/concepts.h>
 #include <wpl/mt/synchronization.h>
 #include <wpl/mt/thread.h>
@@ -29,13 +34,14 @@ namespace micro_profiler
 				struct server_data
 				{
 					server_data()
-						: session_count(0), changed_event(false, true)
+						: session_count(0), changed_event(false, true), unblock_event(false, false)
 					{	}
 
 					int session_count;
 					deque< vector<byte> > inputs;
 					deque< vector<byte> > outputs;
-					event_flag changed_event;
+					vector<byte> blocking_input;
+					event_flag changed_event, unblock_event;
 					mutex server_mutex;
 				};
 
@@ -122,12 +128,40 @@ namespace micro_profiler
 
 				void mock_session::on_message(const vector<byte> &input, vector<byte> &output)
 				{
+					if (!input.empty() && input == _data->blocking_input)
+						_data->unblock_event.wait();
+
 					scoped_lock l(_data->server_mutex);
 
 					_data->inputs.push_back(input);
 					output = _data->outputs.front();
 					_data->outputs.pop_front();
 				}
+
+
+				struct reply_log
+				{
+					reply_log(size_t expected_)
+						: expected(expected_), done(false, false)
+					{	}
+
+					const size_t expected;
+					vector< vector<byte> > replies;
+					event_flag done;
+					mutex log_mutex;
+				};
+
+				void log_reply(reply_log *log, const vector<byte> &reply)
+				{
+					scoped_lock l(log->log_mutex);
+
+					log->replies.push_back(reply);
+					if (log->replies.size() == log->expected)
+						log->done.raise();
+				}
+
+				client::completion_t make_completion(reply_log &log)
+				{	return bind(&log_reply, &log, placeholders::_1);	}
 			}
 
 			begin_test_suite( IPCClientServerTests )
@@ -391,6 +425,330 @@ namespace micro_profiler
 					// ASSERT
 					assert_equivalent(tmp, o);
 				}
+
+
+				test( HundredsOfClientsAreServed )
+				{
+					// INIT
+					server s("test-5");
+					vector< shared_ptr<client> > clients;
+					vector<byte> i(1), o;
+
+					s.data->outputs.resize(300);
+
+					// ACT
+					for (int n = 0; n != 300; ++n)
+						clients.push_back(shared_ptr<client>(new client("test-5")));
+
+					// ACT / ASSERT (must not hang)
+					s.wait_for_session(300);
+
+					// ACT
+					for (int n = 0; n != 300; ++n)
+					{
+						i[0] = static_cast<byte>(n);
+						clients[n]->call(i, o);
+					}
+
+					// ASSERT
+					deque< vector<byte> > inputs = s.get_inputs();
+
+					assert_equal(300u, inputs.size());
+					assert_equal(0u, inputs[0][0]);
+					assert_equal(255u, inputs[255][0]);
+					assert_equal(43u, inputs[299][0]);
+				}
+
+				test( AsynchronousCallsAreRepliedInOrder )
+				{
+					// INIT
+					server s("test-7");
+					client c("test-7");
+					reply_log log(3);
+					byte m1[] = "lorem";
+					byte m2[] = "ipsum";
+					byte m3[] = "amet";
+
+					s.add_output(micro_profiler::tests::mkvector(m1));
+					s.add_output(micro_profiler::tests::mkvector(m2));
+					s.add_output(micro_profiler::tests::mkvector(m3));
+
+					// ACT
+					unsigned long long id1 = c.call_async(micro_profiler::tests::mkvector(m3), make_completion(log));
+					unsigned long long id2 = c.call_async(micro_profiler::tests::mkvector(m2), make_completion(log));
+					unsigned long long id3 = c.call_async(micro_profiler::tests::mkvector(m1), make_completion(log));
+
+					// ASSERT (must not hang)
+					log.done.wait();
+
+					assert_equal(0u, id1);
+					assert_equal(1u, id2);
+					assert_equal(2u, id3);
+					assert_equivalent(m1, log.replies[0]);
+					assert_equivalent(m2, log.replies[1]);
+					assert_equivalent(m3, log.replies[2]);
+
+					deque< vector<byte> > inputs = s.get_inputs();
+
+					assert_equivalent(m3, inputs[0]);
+					assert_equivalent(m2, inputs[1]);
+					assert_equivalent(m1, inputs[2]);
+				}
+
+
+				test( ManyOutstandingCallsAreCompleted )
+				{
+					// INIT
+					server s("test-8");
+					client c("test-8");
+					reply_log log(1000);
+					vector<byte> i(2);
+
+					for (int n = 0; n != 1000; ++n)
+					{
+						i[0] = static_cast<byte>(n), i[1] = static_cast<byte>(n >> 8);
+						s.add_output(i);
+					}
+
+					// ACT
+					for (int n = 0; n != 1000; ++n)
+						c.call_async(vector<byte>(n % 50), make_completion(log));
+
+					// ASSERT (must not hang)
+					log.done.wait();
+
+					for (int n = 0; n != 1000; ++n)
+					{
+						assert_equal(static_cast<byte>(n), log.replies[n][0]);
+						assert_equal(static_cast<byte>(n >> 8), log.replies[n][1]);
+					}
+				}
+
+
+				test( SynchronousCallsCanFollowAsynchronousOnes )
+				{
+					// INIT
+					server s("test-9");
+					client c("test-9");
+					reply_log log(2);
+					byte m1[] = "lorem";
+					byte m2[] = "ipsum";
+					byte m3[] = "dolor";
+					vector<byte> o;
+
+					s.add_output(micro_profiler::tests::mkvector(m1));
+					s.add_output(micro_profiler::tests::mkvector(m2));
+					s.add_output(micro_profiler::tests::mkvector(m3));
+					c.call_async(vector<byte>(), make_completion(log));
+					c.call_async(vector<byte>(), make_completion(log));
+
+					// ACT
+					c.call(vector<byte>(), o);
+
+					// ASSERT
+					assert_equivalent(m3, o);
+
+					log.done.wait();
+					assert_equivalent(m1, log.replies[0]);
+					assert_equivalent(m2, log.replies[1]);
+				}
+
+				test( AsynchronousCallsMadeDuringASynchronousOneGetTheirOwnReplies )
+				{
+					// INIT
+					byte m1[] = "lorem";
+					byte m2[] = "ipsum";
+					byte slow[] = "slow";
+					server s("test-12");
+					client c("test-12");
+					reply_log log(1);
+					vector<byte> o, o1 = micro_profiler::tests::mkvector(m1), o2 = micro_profiler::tests::mkvector(m2);
+
+					s.add_output(o1);
+					s.add_output(o2);
+					s.data->blocking_input = micro_profiler::tests::mkvector(slow);
+
+					thread t(bind(&client::call, &c, s.data->blocking_input, ref(o)));
+
+					// ACT
+					c.call_async(vector<byte>(), make_completion(log));
+					s.data->unblock_event.raise();
+					t.join();
+					log.done.wait();
+
+					// ASSERT
+					deque< vector<byte> > inputs = s.get_inputs();
+
+					// The calls may reach the server in either order, but each gets the reply to its own request.
+					assert_equal(2u, inputs.size());
+					assert_equal(inputs[0].empty() ? o2 : o1, o);
+					assert_equal(inputs[0].empty() ? o1 : o2, log.replies[0]);
+				}
+
+#ifndef _WIN32
+				// The named pipe server handles all of its sessions on a single thread.
+				test( SlowSessionDoesNotDelayOtherSessions )
+				{
+					// INIT
+					byte m1[] = "slow";
+					byte m2[] = "fast";
+					server s("test-6");
+					client c1("test-6"), c2("test-6");
+					vector<byte> o1, o2;
+
+					s.data->outputs.resize(2);
+					s.data->blocking_input = micro_profiler::tests::mkvector(m1);
+
+					thread t(bind(&client::call, &c1, s.data->blocking_input, ref(o1)));
+
+					// ACT / ASSERT (must not hang)
+					c2.call(micro_profiler::tests::mkvector(m2), o2);
+
+					// ASSERT
+					deque< vector<byte> > inputs = s.get_inputs();
+
+					assert_equal(1u, inputs.size());
+					assert_equivalent(m2, inputs[0]);
+
+					// ACT
+					s.data->unblock_event.raise();
+					t.join();
+
+					// ASSERT
+					inputs = s.get_inputs();
+
+					assert_equal(2u, inputs.size());
+					assert_equivalent(m1, inputs[1]);
+				}
+
+
+				test( SessionIsResumedAfterTooManyRequestsWereQueued )
+				{
+					// INIT
+					byte m1[] = "slow";
+					server s("test-10");
+					client c("test-10");
+					reply_log log(201);
+
+					s.data->outputs.resize(201);
+					s.data->blocking_input = micro_profiler::tests::mkvector(m1);
+					c.call_async(s.data->blocking_input, make_completion(log));
+					for (int n = 0; n != 200; ++n)
+						c.call_async(vector<byte>(1, static_cast<byte>(n)), make_completion(log));
+
+					// ACT
+					s.data->unblock_event.raise();
+
+					// ASSERT (must not hang)
+					log.done.wait();
+
+					deque< vector<byte> > inputs = s.get_inputs();
+
+					assert_equal(201u, inputs.size());
+					for (int n = 0; n != 200; ++n)
+						assert_equal(static_cast<byte>(n), inputs[n + 1][0]);
+				}
+
+
+				test( SessionSendingAnOversizedFrameIsClosed )
+				{
+					// INIT
+					server s("test-11");
+					sockaddr_un address;
+					socket_handle h(socket(AF_UNIX, SOCK_STREAM, 0));
+					const frame_header header = c_max_frame_size + 1;
+
+					make_socket_address(address, "test-11");
+					assert_equal(0, connect(h.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)));
+					s.wait_for_session(1);
+
+					// ACT
+					send_all(h.get(), &header, sizeof(header));
+
+					// ASSERT (must not hang)
+					s.wait_for_session(0);
+				}
+
+
+				test( SocketsLeftByGoneServersAreNotListedAndAreTakenOver )
+				{
+					// INIT
+					vector<string> servers;
+					sockaddr_un address;
+					socket_handle h(socket(AF_UNIX, SOCK_STREAM, 0));
+
+					make_socket_address(address, "test-12");
+					assert_equal(0, bind(h.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)));
+					h.reset();
+
+					// ACT
+					client::enumerate_servers(servers);
+
+					// ASSERT
+					assert_equal(servers.end(), find(servers.begin(), servers.end(), "test-12"));
+
+					// ACT
+					server s("test-12");
+					client::enumerate_servers(servers);
+
+					// ASSERT
+					assert_not_equal(servers.end(), find(servers.begin(), servers.end(), "test-12"));
+
+					// ACT / ASSERT (must not hang)
+					client c("test-12");
+					s.wait_for_session(1);
+				}
+
+
+				test( ServerDoesNotTakeTheNameOfALiveServer )
+				{
+					// INIT
+					server s("test-13");
+
+					// ACT
+					auto_ptr<server> s2(new server("test-13"));
+					s2.reset();
+
+					// ASSERT (must not hang)
+					client c("test-13");
+					s.wait_for_session(1);
+				}
+
+
+				test( ServerKeepsAcceptingAfterRunningOutOfDescriptors )
+				{
+					// INIT
+					server s("test-14");
+					sockaddr_un address;
+					rlimit original, limited;
+					byte b;
+
+					make_socket_address(address, "test-14");
+					getrlimit(RLIMIT_NOFILE, &original);
+
+					socket_handle h(socket(AF_UNIX, SOCK_STREAM, 0));
+
+					// The socket took the lowest descriptor free, so the server has none left to accept with.
+					limited = original;
+					limited.rlim_cur = h.get() + 1;
+					setrlimit(RLIMIT_NOFILE, &limited);
+
+					// ACT
+					const int connected = connect(h.get(), reinterpret_cast<const sockaddr *>(&address),
+						sizeof(address));
+					const ssize_t received = recv(h.get(), &b, sizeof(b), 0);
+
+					setrlimit(RLIMIT_NOFILE, &original);
+
+					// ASSERT (must not hang)
+					assert_equal(0, connected);
+					assert_equal(0, received);
+
+					// ACT / ASSERT (must not hang)
+					client c("test-14");
+					s.wait_for_session(1);
+				}
+#endif
 			end_test_suite
 		}
 	}
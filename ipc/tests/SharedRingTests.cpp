@@ -0,0 +1,288 @@
+#include <ipc/shared_ring.h>
+
+#include <string>
+#ifndef _WIN32
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+#include <ut/assert.h>
+#include <ut/test.h>
+#include <wpl/mt/thread.h>
+
+using namespace std;
+using namespace wpl::mt;
+
+namespace micro_profiler
+{
+	namespace ipc
+	{
+		namespace tests
+		{
+			namespace
+			{
+				bool write(shared_ring &ring, const string &message, unsigned int timeout = shared_ring::infinite)
+				{	return ring.write(message.data(), message.size(), timeout);	}
+
+				string read(shared_ring &ring, unsigned int timeout = shared_ring::infinite)
+				{
+					const byte *data = 0;
+					size_t size = 0;
+
+					ring.read(data, size, timeout);
+					return string(reinterpret_cast<const char *>(data), size);
+				}
+
+				string read_and_release(shared_ring &ring)
+				{
+					const string message = read(ring);
+
+					ring.release();
+					return message;
+				}
+
+				string make_message(unsigned int n)
+				{
+					string message(n % 37, char('a' + n % 26));
+
+					return message.append(reinterpret_cast<const char *>(&n), sizeof(n));
+				}
+
+				void produce(shared_ring *ring, unsigned int count)
+				{
+					for (unsigned int i = 0; i != count; ++i)
+						write(*ring, make_message(i));
+				}
+			}
+
+			begin_test_suite( SharedRingTests )
+				test( CreatedRingCanBeOpenedByName )
+				{
+					// INIT
+					auto_ptr<shared_ring> r1 = shared_ring::create("test-ring-a", 1000);
+					auto_ptr<shared_ring> r2 = shared_ring::create("test-ring-b", 4096);
+
+					// ACT
+					auto_ptr<shared_ring> o1 = shared_ring::open("test-ring-a");
+					auto_ptr<shared_ring> o2 = shared_ring::open("test-ring-b");
+					auto_ptr<shared_ring> o3 = shared_ring::open("test-ring-c");
+
+					// ASSERT
+					assert_not_null(r1.get());
+					assert_not_null(o1.get());
+					assert_equal(1024u, r1->capacity());
+					assert_equal(1024u, o1->capacity());
+					assert_not_null(o2.get());
+					assert_equal(4096u, o2->capacity());
+					assert_null(o3.get());
+				}
+
+
+				test( RingIsNotCreatedTwice )
+				{
+					// INIT
+					auto_ptr<shared_ring> r = shared_ring::create("test-ring-a", 1000);
+
+					// ACT / ASSERT
+					assert_null(shared_ring::create("test-ring-a", 1000).get());
+				}
+
+
+				test( RingIsGoneOnceTheCreatorIsDestroyed )
+				{
+					// INIT
+					shared_ring::create("test-ring-a", 1000);
+
+					// ACT / ASSERT
+					assert_null(shared_ring::open("test-ring-a").get());
+				}
+
+
+				test( MessagesWrittenAreReadFromTheOtherSideInOrder )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 1000);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+
+					// ACT
+					assert_is_true(write(*producer, "lorem"));
+					assert_is_true(write(*producer, ""));
+					assert_is_true(write(*producer, "ipsum dolor"));
+
+					// ACT / ASSERT
+					assert_equal("lorem", read_and_release(*consumer));
+					assert_equal("", read_and_release(*consumer));
+					assert_equal("ipsum dolor", read_and_release(*consumer));
+				}
+
+
+				test( MessageIsReadAgainUntilReleased )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 1000);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+
+					write(*producer, "lorem");
+					write(*producer, "ipsum");
+
+					// ACT / ASSERT
+					assert_equal("lorem", read(*consumer));
+					assert_equal("lorem", read(*consumer));
+					consumer->release();
+					assert_equal("ipsum", read(*consumer));
+				}
+
+
+				test( ReadingFromAnEmptyRingTimesOut )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 1000);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+					const byte *data;
+					size_t size;
+
+					// ACT / ASSERT
+					assert_is_false(consumer->read(data, size, 10));
+
+					// INIT
+					write(*producer, "lorem");
+					read_and_release(*consumer);
+
+					// ACT / ASSERT
+					assert_is_false(consumer->read(data, size, 10));
+				}
+
+
+				test( MessagesLargerThanTheRingAreRejected )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 64);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+
+					// ACT / ASSERT
+					assert_is_false(write(*producer, string(61, 'x'), 0));
+					assert_is_true(write(*producer, string(60, 'x'), 0));
+					assert_equal(string(60, 'x'), read_and_release(*consumer));
+				}
+
+
+				test( WritingToAFullRingTimesOutAndSucceedsAfterRelease )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 64);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+
+					write(*producer, string(30, 'a'));
+
+					// ACT / ASSERT
+					assert_equal(string(30, 'a'), read(*consumer));
+					assert_is_true(write(*producer, string(20, 'b'), 0));
+					assert_is_false(write(*producer, string(8, 'c'), 10));
+
+					// ACT
+					consumer->release();
+
+					// ACT / ASSERT
+					assert_is_true(write(*producer, string(8, 'c'), 0));
+					assert_equal(string(20, 'b'), read_and_release(*consumer));
+					assert_equal(string(8, 'c'), read_and_release(*consumer));
+				}
+
+
+				test( MessageNotFittingBeforeTheEndIsWrittenFromTheBeginning )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 64);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+					const byte *data1, *data2;
+					size_t size;
+
+					write(*producer, string(36, 'a'));
+					consumer->read(data1, size, 0);
+					consumer->release();
+
+					// ACT
+					assert_is_true(write(*producer, string(36, 'b'), 0));
+
+					// ASSERT
+					assert_is_true(consumer->read(data2, size, 0));
+					assert_equal(36u, size);
+					assert_equal(data1, data2);
+					assert_equal(string(36, 'b'), string(reinterpret_cast<const char *>(data2), size));
+				}
+
+
+				test( AllMessagesArePassedBetweenThreadsThroughASmallRing )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 256);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+					vector<string> reference, messages;
+
+					for (unsigned int i = 0; i != 20000; ++i)
+						reference.push_back(make_message(i));
+
+					// ACT
+					thread t(bind(&produce, producer.get(), 20000u));
+
+					while (messages.size() != 20000u)
+						messages.push_back(read_and_release(*consumer));
+					t.join();
+
+					// ASSERT
+					assert_equal(reference, messages);
+				}
+
+
+				test( RecordRunningPastTheEndOfTheRingIsNotRead )
+				{
+					// INIT
+					auto_ptr<shared_ring> producer = shared_ring::create("test-ring-a", 64);
+					auto_ptr<shared_ring> consumer = shared_ring::open("test-ring-a");
+					const byte *data;
+					size_t size;
+
+					write(*producer, "lorem");
+					consumer->read(data, size);
+
+					unsigned int &stored_size = *reinterpret_cast<unsigned int *>(const_cast<byte *>(data)
+						- sizeof(unsigned int));
+
+					// ACT
+					stored_size = 61;
+
+					// ASSERT
+					assert_is_false(consumer->read(data, size, 0));
+
+					// ACT
+					stored_size = 60;
+
+					// ASSERT
+					assert_is_true(consumer->read(data, size, 0));
+					assert_equal(60u, size);
+				}
+
+#ifndef _WIN32
+				test( RingAbandonedByItsCreatorIsReplaced )
+				{
+					// INIT
+					const pid_t creator = fork();
+
+					if (!creator)
+					{
+						shared_ring::create("test-ring-d", 1000).release();	// Leave the ring behind.
+						_exit(0);
+					}
+					waitpid(creator, NULL, 0);
+
+					// ACT
+					auto_ptr<shared_ring> r = shared_ring::create("test-ring-d", 4096);
+
+					// ASSERT
+					assert_not_null(r.get());
+					assert_equal(4096u, r->capacity());
+				}
+#endif
+			end_test_suite
+		}
+	}
+}
@@ -38,6 +38,8 @@ namespace micro_profiler
 
 	namespace
 	{
+		enum {	c_windows_timer = 1, c_windows_advance_period = 1000 /*ms*/	};
+
 		shared_ptr<hive> open_configuration()
 		{	return hive::user_settings("Software")->create("gevorkyan.org")->create("MicroProfiler");	}
 
@@ -85,6 +87,7 @@ namespace micro_profiler
 	LRESULT ProfilerMainDialog::OnInitDialog(UINT /*message*/, WPARAM /*wparam*/, LPARAM /*lparam*/, BOOL& handled)
 	{
 		_statistics_display->create(*this);
+		SetTimer(c_windows_timer, c_windows_advance_period);
 
 		SetIcon(::LoadIcon(g_instance, MAKEINTRESOURCE(IDI_APPMAIN)), TRUE);
 
@@ -123,6 +126,14 @@ namespace micro_profiler
 		return handled = TRUE, 0;
 	}
 
+	LRESULT ProfilerMainDialog::OnTimer(UINT /*message*/, WPARAM wparam, LPARAM /*lparam*/, BOOL &handled)
+	{
+		// Recent statistics must empty out even when no updates come.
+		if (c_windows_timer == wparam)
+			_statistics->advance_windows();
+		return handled = TRUE, 0;
+	}
+
 	LRESULT ProfilerMainDialog::OnClearStatistics(WORD /*code*/, WORD /*control_id*/, HWND /*control*/, BOOL &handled)
 	{
 		_statistics->clear();
@@ -150,6 +161,12 @@ namespace micro_profiler
 		return handled = TRUE, 0;
 	}
 
+	LRESULT ProfilerMainDialog::OnRecentToggled(WORD /*code*/, WORD /*control_id*/, HWND /*control*/, BOOL &handled)
+	{
+		_statistics_display->show_recent(BST_CHECKED == IsDlgButtonChecked(IDC_CHK_RECENT));
+		return handled = TRUE, 0;
+	}
+
 	LRESULT ProfilerMainDialog::OnClose(UINT /*message*/, WPARAM /*wparam*/, LPARAM /*lparam*/, BOOL &handled)
 	{
 		DestroyWindow();
@@ -169,7 +186,7 @@ namespace micro_profiler
 	void ProfilerMainDialog::RelocateControls(const CSize &size)
 	{
 		enum { spacing = 7 };
-		CRect rcButton, rc(CPoint(0, 0), size), rcLink;
+		CRect rcButton, rcCheck, rc(CPoint(0, 0), size), rcLink;
 
 		rc.DeflateRect(spacing, spacing, spacing, spacing);
 		GetDlgItem(IDC_SUPPORT_DEV).GetWindowRect(&rcLink);
@@ -182,6 +199,9 @@ namespace micro_profiler
 		GetDlgItem(IDC_BTN_CLEAR).MoveWindow(rcButton);
 		rcButton.MoveToX(rcButton.right + spacing);
 		GetDlgItem(IDC_BTN_COPY_ALL).MoveWindow(rcButton);
+		GetDlgItem(IDC_CHK_RECENT).GetWindowRect(&rcCheck);
+		rcCheck.MoveToXY(rcButton.right + spacing, rcButton.top + (rcButton.Height() - rcCheck.Height()) / 2);
+		GetDlgItem(IDC_CHK_RECENT).MoveWindow(rcCheck);
 		rc.DeflateRect(0, 0, 0, spacing);
 		_statistics_display->resize(rc.left, rc.top, rc.Width(), rc.Height());
 	}
@@ -49,8 +49,10 @@ namespace micro_profiler
 			MESSAGE_HANDLER(WM_INITDIALOG, OnInitDialog)
 			MESSAGE_HANDLER(WM_ACTIVATE, OnActivated)
 			MESSAGE_HANDLER(WM_WINDOWPOSCHANGED, OnWindowPosChanged)
+			MESSAGE_HANDLER(WM_TIMER, OnTimer)
 			COMMAND_HANDLER(IDC_BTN_CLEAR, BN_CLICKED, OnClearStatistics)
 			COMMAND_HANDLER(IDC_BTN_COPY_ALL, BN_CLICKED, OnCopyAll)
+			COMMAND_HANDLER(IDC_CHK_RECENT, BN_CLICKED, OnRecentToggled)
 			MESSAGE_HANDLER(WM_CLOSE, OnClose)
 			NOTIFY_HANDLER(IDC_SUPPORT_DEV, NM_CLICK, OnSupportLinkClicked)
 			REFLECT_NOTIFICATIONS()
@@ -59,8 +61,10 @@ namespace micro_profiler
 		LRESULT OnInitDialog(UINT message, WPARAM wparam, LPARAM lparam, BOOL &handled);
 		LRESULT OnActivated(UINT message, WPARAM wparam, LPARAM lparam, BOOL &handled);
 		LRESULT OnWindowPosChanged(UINT message, WPARAM wparam, LPARAM lparam, BOOL &handled);
+		LRESULT OnTimer(UINT message, WPARAM wparam, LPARAM lparam, BOOL &handled);
 		LRESULT OnClearStatistics(WORD code, WORD control_id, HWND control, BOOL &handled);
 		LRESULT OnCopyAll(WORD code, WORD control_id, HWND control, BOOL &handled);
+		LRESULT OnRecentToggled(WORD code, WORD control_id, HWND control, BOOL &handled);
 		LRESULT OnClose(UINT message, WPARAM wparam, LPARAM lparam, BOOL &handled);
 		LRESULT OnSupportLinkClicked(int id, NMHDR *nmhdr, BOOL &handled);
 
@@ -8,6 +8,9 @@ namespace micro_profiler
 {
 	const wchar_t c_microProfilerFileExtension[] = L"mpstats";
 	const wchar_t c_microProfilerFiles[] = L"MicroProfiler Statistics\0*.mpstats\0\0";
+	const wchar_t c_microProfilerOpenFiles[] = L"MicroProfiler Statistics\0*.mpstats\0"
+		L"MicroProfiler Recordings\0*.*\0\0";
+	const DWORD c_recordingsFilterIndex = 2;
 
 	auto_ptr<write_stream> create_file(HWND hparent, const wstring &default_name)
 	{
@@ -30,7 +33,7 @@ namespace micro_profiler
 		return r;
 	}
 
-	auto_ptr<read_stream> open_file(HWND hparent, wstring& path)
+	auto_ptr<read_stream> open_file(HWND hparent, wstring& path, bool &recording)
 	{
 		auto_ptr<read_stream> r;
 		OPENFILENAMEW ofn = {};
@@ -38,12 +41,15 @@ namespace micro_profiler
 
 		ofn.lStructSize = sizeof(ofn);
 		ofn.hwndOwner = hparent;
-		ofn.lpstrFilter = c_microProfilerFiles;
+		ofn.lpstrFilter = c_microProfilerOpenFiles;
 		ofn.lpstrFile = buffer;
 		ofn.nMaxFile = _countof(buffer);
 		ofn.lpstrDefExt = c_microProfilerFileExtension;
 		if (::GetOpenFileNameW(&ofn))
+		{
 			r.reset(new read_stream(ofn.lpstrFile)), path = ofn.lpstrFile;
+			recording = ofn.nFilterIndex == c_recordingsFilterIndex;
+		}
 		return r;
 	}
 }
@@ -9,5 +9,6 @@ typedef struct HWND__ *HWND;
 namespace micro_profiler
 {
 	std::auto_ptr<write_stream> create_file(HWND hparent, const std::wstring &default_name);
-	std::auto_ptr<read_stream> open_file(HWND hparent, std::wstring& path);
+	// Sets 'recording' if the user picked a recording segment made by the collector instead of a statistics file.
+	std::auto_ptr<read_stream> open_file(HWND hparent, std::wstring& path, bool &recording);
 }
@@ -20,4 +20,7 @@ namespace micro_profiler
 		if (size != fread(buffer, 1, size, static_cast<FILE *>(_file.get())))
 			throw runtime_error("Reading past end the file!");
 	}
+
+	size_t read_stream::read_some(byte *buffer, size_t size)
+	{	return fread(buffer, 1, size, static_cast<FILE *>(_file.get()));	}
 }
@@ -24,6 +24,7 @@ namespace micro_profiler
 		read_stream(const std::wstring &path);
 
 		void read(byte *buffer, size_t size);
+		size_t read_some(byte *buffer, size_t size);
 
 	private:
 		std::shared_ptr<void> _file;
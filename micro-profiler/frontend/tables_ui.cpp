@@ -15,6 +15,8 @@ namespace micro_profiler
 {
 	namespace
 	{
+		const double c_recent_duration = 10.0;	// In seconds.
+
 		const columns_model::column c_columns_statistics[] = {
 			columns_model::column("Index", L"#", 28, columns_model::dir_none),
 			columns_model::column("Function", L"Function", 384, columns_model::dir_ascending),
@@ -27,6 +29,22 @@ namespace micro_profiler
 			columns_model::column("MaxCallTime", L"Max Call Time", 121, columns_model::dir_descending),
 		};
 
+		const columns_model::column c_columns_statistics_main[] = {
+			columns_model::column("Index", L"#", 28, columns_model::dir_none),
+			columns_model::column("Function", L"Function", 384, columns_model::dir_ascending),
+			columns_model::column("TimesCalled", L"Times Called", 64, columns_model::dir_descending),
+			columns_model::column("ExclusiveTime", L"Exclusive Time", 48, columns_model::dir_descending),
+			columns_model::column("InclusiveTime", L"Inclusive Time", 48, columns_model::dir_descending),
+			columns_model::column("AvgExclusiveTime", L"Average Exclusive Call Time", 48, columns_model::dir_descending),
+			columns_model::column("AvgInclusiveTime", L"Average Inclusive Call Time", 48, columns_model::dir_descending),
+			columns_model::column("MaxRecursion", L"Max Recursion", 25, columns_model::dir_descending),
+			columns_model::column("MaxCallTime", L"Max Call Time", 121, columns_model::dir_descending),
+			columns_model::column("LatencyP50", L"Latency P50", 48, columns_model::dir_descending),
+			columns_model::column("LatencyP90", L"Latency P90", 48, columns_model::dir_descending),
+			columns_model::column("LatencyP99", L"Latency P99", 48, columns_model::dir_descending),
+			columns_model::column("LatencyP999", L"Latency P99.9", 48, columns_model::dir_descending),
+		};
+
 		const columns_model::column c_columns_statistics_parents[] = {
 			columns_model::column("Index", L"#", 28, columns_model::dir_none),
 			columns_model::column("Function", L"Function", 384, columns_model::dir_ascending),
@@ -36,7 +54,7 @@ namespace micro_profiler
 
 	tables_ui::tables_ui(const shared_ptr<functions_list> &model, hive &configuration)
 		: _statistics(model), _columns_parents(new columns_model(c_columns_statistics_parents, 2, false)),
-			_columns_main(new columns_model(c_columns_statistics, 3, false)),
+			_columns_main(new columns_model(c_columns_statistics_main, 3, false)),
 			_columns_children(new columns_model(c_columns_statistics, 4, false))
 	{
 		_columns_parents->update(*configuration.create("ParentsColumns"));
@@ -87,19 +105,35 @@ namespace micro_profiler
 		_columns_children->store(*configuration.create("ChildrenColumns"));
 	}
 
+	void tables_ui::show_recent(bool recent)
+	{
+		if (recent)
+			_statistics_lv->set_model(_recent_statistics = _statistics->watch_window(c_recent_duration));
+		else
+		{
+			_statistics_lv->set_model(_statistics);
+			_recent_statistics.reset();
+		}
+	}
+
 	void tables_ui::on_focus_change(listview::index_type index, bool selected)
 	{
 		if (selected)
 		{
-			_children_statistics_lv->set_model(_children_statistics = _statistics->watch_children(index));
-			_parents_statistics_lv->set_model(_parents_statistics = _statistics->watch_parents(index));
+			const listview::index_type total_index = _recent_statistics
+				? _statistics->get_index(_recent_statistics->get_address(index)) : index;
+
+			_children_statistics_lv->set_model(_children_statistics = _statistics->watch_children(total_index));
+			_parents_statistics_lv->set_model(_parents_statistics = _statistics->watch_parents(total_index));
 			_statistics_lv->ensure_visible(index);
 		}
 	}
 
 	void tables_ui::on_drilldown(const shared_ptr<linked_statistics> &view, listview::index_type index)
 	{
-		index = _statistics->get_index(view->get_address(index));
+		const address_t address = view->get_address(index);
+
+		index = _recent_statistics ? _recent_statistics->get_index(address) : _statistics->get_index(address);
 		_statistics_lv->select(index, true);
 	}
 }
@@ -22,13 +22,16 @@ namespace micro_profiler
 		void resize(unsigned x, unsigned y, unsigned cx, unsigned cy);
 		void save(hive &configuration);
 
+		// Switches the main view between the totals and the statistics collected over the last few seconds.
+		void show_recent(bool recent);
+
 	private:
 		void on_focus_change(wpl::ui::listview::index_type index, bool selected);
 		void on_drilldown(const std::shared_ptr<linked_statistics> &view, wpl::ui::listview::index_type index);
 
 	private:
 		const std::shared_ptr<functions_list> _statistics;
-		std::shared_ptr<linked_statistics> _parents_statistics, _children_statistics;
+		std::shared_ptr<linked_statistics> _parents_statistics, _children_statistics, _recent_statistics;
 		const std::shared_ptr<columns_model> _columns_parents, _columns_main, _columns_children;
 		HWND _statistics_view, _children_statistics_view, _parents_statistics_view;
 		std::shared_ptr<wpl::ui::listview> _statistics_lv, _parents_statistics_lv, _children_statistics_lv;
@@ -14,6 +14,7 @@
 #define IDC_BTN_COPY_ALL                207
 #define IDC_SUPPORT_DEV                 208
 #define IDC_WAYS_TO_SUPPORT             209
+#define IDC_CHK_RECENT                  210
 
 // Next default values for new objects
 // 
@@ -61,6 +61,7 @@
 #define cmdidCloseAll 0x300
 #define cmdidClearStatistics 0x400
 #define cmdidCopyStatistics 0x401
+#define cmdidCopyFoldedStacks 0x402
 
 #define cmdidSupportDeveloper 0x1000
 
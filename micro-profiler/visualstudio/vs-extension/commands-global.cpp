@@ -29,13 +29,16 @@
 #include <frontend/file.h>
 #include <frontend/frontend_manager.h>
 #include <frontend/function_list.h>
+#include <frontend/message_processor.h>
 #include <frontend/SupportDevDialog.h>
+#include <frontend/symbol_resolver.h>
 #include <strmd/deserializer.h>
 #include <strmd/serializer.h>
 #include <visualstudio/dispatch.h>
 
 #include <io.h>
 #include <memory>
+#include <vector>
 
 #pragma warning(disable:4996)
 
@@ -245,9 +248,24 @@ namespace micro_profiler
 		void open_statistics::exec(context_type &ctx, unsigned /*item*/)
 		{
 			wstring path;
-			auto_ptr<read_stream> s = open_file(get_frame_hwnd(ctx.shell), path);
+			bool recording = false;
+			auto_ptr<read_stream> s = open_file(get_frame_hwnd(ctx.shell), path, recording);
 
-			if (s.get())
+			if (s.get() && recording)
+			{
+				vector<byte> data;
+				byte chunk[0x10000];
+				wstring executable;
+
+				for (size_t read; read = s->read_some(chunk, sizeof(chunk)), read; )
+					data.insert(data.end(), chunk, chunk + read);
+				if (shared_ptr<functions_list> model = load_recording(symbol_resolver::create(),
+					data.empty() ? 0 : &data[0], data.size(), executable))
+				{
+					ctx.frontend->create_instance(*path, model);
+				}
+			}
+			else if (s.get())
 			{
 				strmd::deserializer<read_stream, packer> dser(*s);
 				shared_ptr<functions_list> model = functions_list::load(dser);
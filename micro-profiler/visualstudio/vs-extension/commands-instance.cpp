@@ -16,6 +16,26 @@ namespace micro_profiler
 {
 	namespace integration
 	{
+		namespace
+		{
+			void copy_to_clipboard(const wstring &text)
+			{
+				if (::OpenClipboard(NULL))
+				{
+					if (HGLOBAL gtext = ::GlobalAlloc(GMEM_MOVEABLE, (text.size() + 1) * sizeof(wchar_t)))
+					{
+						wchar_t *gtext_memory = static_cast<wchar_t *>(::GlobalLock(gtext));
+
+						std::copy(text.c_str(), text.c_str() + text.size() + 1, gtext_memory);
+						::GlobalUnlock(gtext_memory);
+						::EmptyClipboard();
+						::SetClipboardData(CF_UNICODETEXT, gtext);
+					}
+					::CloseClipboard();
+				}
+			}
+		}
+
 		save::save()
 			: instance_command(cmdidSaveStatistics)
 		{	}
@@ -59,19 +79,23 @@ namespace micro_profiler
 			wstring result;
 
 			ctx.model->print(result);
-			if (::OpenClipboard(NULL))
-			{
-				if (HGLOBAL gtext = ::GlobalAlloc(GMEM_MOVEABLE, (result.size() + 1) * sizeof(wchar_t)))
-				{
-					wchar_t *gtext_memory = static_cast<wchar_t *>(::GlobalLock(gtext));
+			copy_to_clipboard(result);
+		}
 
-					std::copy(result.c_str(), result.c_str() + result.size() + 1, gtext_memory);
-					::GlobalUnlock(gtext_memory);
-					::EmptyClipboard();
-					::SetClipboardData(CF_UNICODETEXT, gtext);
-				}
-				::CloseClipboard();
-			}
+
+		copy_folded::copy_folded()
+			: instance_command(cmdidCopyFoldedStacks)
+		{	}
+
+		bool copy_folded::query_state(const context_type &/*ctx*/, unsigned /*item*/, unsigned &state) const
+		{	return state = enabled | visible | supported, true;	}
+
+		void copy_folded::exec(context_type &ctx, unsigned /*item*/)
+		{
+			wstring result;
+
+			ctx.model->print_folded(result);
+			copy_to_clipboard(result);
 		}
 	}
 }
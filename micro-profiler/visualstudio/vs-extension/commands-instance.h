@@ -43,5 +43,13 @@ namespace micro_profiler
 			virtual bool query_state(const context_type &ctx, unsigned item, unsigned &state) const;
 			virtual void exec(context_type &ctx, unsigned item);
 		};
+
+		struct copy_folded : instance_command
+		{
+			copy_folded();
+
+			virtual bool query_state(const context_type &ctx, unsigned item, unsigned &state) const;
+			virtual void exec(context_type &ctx, unsigned item);
+		};
 	}
 }
@@ -34,6 +34,7 @@ namespace micro_profiler
 				instance_command::ptr(new save),
 				instance_command::ptr(new clear),
 				instance_command::ptr(new copy),
+				instance_command::ptr(new copy_folded),
 			};
 		}
 
@@ -151,4 +151,7 @@ namespace micro_profiler
 
 	bool operator ==(const function_statistics &lhs, const function_statistics &rhs)
 	{	return !(lhs < rhs) && !(rhs < lhs);	}
+
+	bool operator ==(const call_record &lhs, const call_record &rhs)
+	{	return lhs.timestamp == rhs.timestamp && lhs.callee == rhs.callee && stack_pointer(lhs) == stack_pointer(rhs);	}
 }
@@ -85,6 +85,10 @@ namespace micro_profiler
 		inline std::vector< std::pair<KeyT, ValueT> > mkvector(const std::unordered_map<KeyT, ValueT, CompT> &from)
 		{	return std::vector< std::pair<KeyT, ValueT> >(from.begin(), from.end());	}
 
+		template <typename KeyT, typename ValueT, typename HashT, size_t inline_capacity>
+		inline std::vector< std::pair<KeyT, ValueT> > mkvector(const small_map<KeyT, ValueT, HashT, inline_capacity> &from)
+		{	return std::vector< std::pair<KeyT, ValueT> >(from.begin(), from.end());	}
+
 		template <typename T, size_t size>
 		inline std::vector<T> mkvector(T (&array_ptr)[size])
 		{	return std::vector<T>(array_ptr, array_ptr + size);	}
@@ -92,4 +96,5 @@ namespace micro_profiler
 
 	bool operator <(const function_statistics &lhs, const function_statistics &rhs);
 	bool operator ==(const function_statistics &lhs, const function_statistics &rhs);
+	bool operator ==(const call_record &lhs, const call_record &rhs);
 }
@@ -0,0 +1,191 @@
+//	Copyright (c) 2011-2018 by Artem A. Gevorkyan (gevorkyan.org)
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in
+//	all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//	THE SOFTWARE.
+
+#include <collector/trace_replay.h>
+
+#include <common/path.h>
+#include <common/raw_trace.h>
+#include <common/serialization.h>
+#include <common/string.h>
+
+#include <limits>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strmd/serializer.h>
+
+using namespace micro_profiler;
+using namespace std;
+using namespace std::placeholders;
+
+namespace
+{
+	class file_writer
+	{
+	public:
+		file_writer(FILE *file)
+			: _file(file)
+		{	}
+
+		void write(const void *data, size_t size)
+		{	fwrite(data, 1, size, _file);	}
+
+	private:
+		FILE *_file;
+	};
+
+	struct options
+	{
+		options()
+			: workers(4), begin(0), end(numeric_limits<double>::max())
+		{	}
+
+		string directory, output;
+		unsigned int workers;
+		double begin, end;
+	};
+
+	shared_ptr<FILE> open_file(const wstring &path, const char *mode)
+	{
+		FILE *file = fopen(unicode(path).c_str(), mode);
+
+		return file ? shared_ptr<FILE>(file, &fclose) : shared_ptr<FILE>();
+	}
+
+	shared_ptr<FILE> open_segment(const wstring &directory, const raw_trace_index_entry &segment)
+	{
+		char name[64];
+
+		sprintf(name, "%u-%u.trace", segment.threadid, segment.segment);
+		return open_file(directory & unicode(name), "rb");
+	}
+
+	bool read_segment(const wstring &directory, const raw_trace_index_entry &segment, vector<byte> &buffer)
+	{
+		if (shared_ptr<FILE> file = open_segment(directory, segment))
+		{
+			byte chunk[0x10000];
+
+			for (size_t read; read = fread(chunk, 1, sizeof(chunk), file.get()), read; )
+				buffer.insert(buffer.end(), chunk, chunk + read);
+			return true;
+		}
+		return false;
+	}
+
+	// A segment the recording process did not close is listed with no records - its header has the actual numbers.
+	void complete_entry(const wstring &directory, raw_trace_index_entry &entry)
+	{
+		raw_trace_header header;
+
+		if (shared_ptr<FILE> file = open_segment(directory, entry))
+		{
+			if (1 == fread(&header, sizeof(header), 1, file.get()) && header.signature == raw_trace_signature)
+			{
+				entry.records = header.records;
+				entry.first_timestamp = header.first_timestamp;
+				entry.last_timestamp = header.last_timestamp;
+			}
+		}
+	}
+
+	bool parse_options(options &o, int argc, const char *argv[])
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (!strcmp(argv[i], "-j") && i + 1 < argc)
+				o.workers = static_cast<unsigned int>(strtoul(argv[++i], NULL, 10));
+			else if (!strcmp(argv[i], "--from") && i + 1 < argc)
+				o.begin = strtod(argv[++i], NULL);
+			else if (!strcmp(argv[i], "--to") && i + 1 < argc)
+				o.end = strtod(argv[++i], NULL);
+			else if (o.directory.empty())
+				o.directory = argv[i];
+			else if (o.output.empty())
+				o.output = argv[i];
+			else
+				return false;
+		}
+		return !o.directory.empty() && !o.output.empty();
+	}
+}
+
+int main(int argc, const char *argv[])
+{
+	options o;
+
+	if (!parse_options(o, argc, argv))
+	{
+		printf("Usage: trace-replay <recording directory> <statistics file> [-j <workers>] [--from <seconds>] "
+			"[--to <seconds>]\n"
+			"Replays the raw trace recorded with MICROPROFILER_TRACE_RECORDING into a statistics file, which can be "
+			"opened in the profiler. Each profiled process records into its own numbered subdirectory of that "
+			"directory - pass the subdirectory. The time range is relative to the start of the recording. The raw trace "
+			"has no module information, so the functions are named by their addresses.\n");
+		return 1;
+	}
+
+	const wstring directory = unicode(o.directory);
+	shared_ptr<FILE> index = open_file(directory & L"index", "rb");
+	raw_trace_index_header header;
+
+	if (!index || 1 != fread(&header, sizeof(header), 1, index.get()) || header.signature != raw_trace_signature)
+	{
+		printf("'%s' does not contain a raw trace recording index!\n", o.directory.c_str());
+		return 2;
+	}
+
+	trace_replay replay(bind(&read_segment, directory, _1, _2), header.profiler_latency);
+	timestamp_t origin = numeric_limits<timestamp_t>::max();
+
+	for (raw_trace_index_entry entry; 1 == fread(&entry, sizeof(entry), 1, index.get()); )
+	{
+		if (!entry.records)
+			complete_entry(directory, entry);
+		if (entry.records && entry.first_timestamp < origin)
+			origin = entry.first_timestamp;
+		replay.add_segment(entry);
+	}
+
+	const double max_offset = static_cast<double>(numeric_limits<timestamp_t>::max() - origin) / header.ticks_per_second;
+	const timestamp_t begin = origin + static_cast<timestamp_t>(o.begin * header.ticks_per_second);
+	const timestamp_t end = o.end < max_offset ? origin + static_cast<timestamp_t>(o.end * header.ticks_per_second)
+		: numeric_limits<timestamp_t>::max();
+
+	if (!replay.run(o.workers, begin, end))
+		printf("Warning: some of the trace segments could not be read.\n");
+
+	shared_ptr<FILE> output = open_file(unicode(o.output), "wb");
+
+	if (!output)
+	{
+		printf("Cannot create '%s'!\n", o.output.c_str());
+		return 3;
+	}
+
+	file_writer writer(output.get());
+	strmd::serializer<file_writer, packer> archive(writer);
+
+	replay.result().save(archive, header.ticks_per_second);
+	printf("%u functions, %u call paths replayed.\n", static_cast<unsigned int>(replay.result().statistics().size()),
+		static_cast<unsigned int>(replay.result().paths().size()));
+	return 0;
+}